@@ -0,0 +1,149 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission. 
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+/*
+Example: 		acceleration_curve.ino
+Library:		AcksenButton
+Author: 		Acksen Ltd
+
+Created:		16 Oct 2026
+Last Modified:	16 Oct 2026
+
+Description:
+Demonstrate via debug serial port, entering a setpoint from 0 to 10000 with Up and Down buttons in Accelerate
+mode, using an exponential acceleration curve generated at compile time.
+
+While a button is held, repeats speed up smoothly from 400ms to 20ms apart over 32 repeats, and the step applied
+to the setpoint grows with getRepeatCount(), so the whole range can be crossed in a few seconds. The curve table
+is stored in flash (PROGMEM), so it uses no RAM.
+
+The library must be built with ACKSEN_BUTTON_ACCELERATION_CURVES set to 1 - edit the default in AcksenButton.h, or add
+-DACKSEN_BUTTON_ACCELERATION_CURVES=1 to the build flags.
+
+*/
+
+#include <AcksenButton.h>
+#include <AcksenButtonCurve.h>
+
+#if !ACKSEN_BUTTON_ACCELERATION_CURVES
+#error "Set ACKSEN_BUTTON_ACCELERATION_CURVES to 1 in AcksenButton.h to use acceleration curves"
+#endif
+
+// ***********************************
+// Serial Debug
+// ***********************************
+#define DEBUG_BAUD_RATE			115200
+
+
+// ***********************************
+// I/O  
+// ***********************************
+#define BUTTON_UP_IO					12
+#define BUTTON_DOWN_IO					13
+
+
+// ***********************************
+// Constants
+// ***********************************
+#define BUTTON_DEBOUNCE_INTERVAL				20 		// Milliseconds
+#define BUTTON_INITIAL_OFFSET_INTERVAL			500		// Milliseconds before repeats start
+
+#define SETPOINT_MINIMUM						0
+#define SETPOINT_MAXIMUM						10000
+
+typedef AcksenButtonExponentialCurve<400, 20, 32> SetpointCurve;		// 400ms falling to 20ms over 32 repeats
+
+
+// ***********************************
+// Variables
+// ***********************************
+AcksenButton btnUp		=	AcksenButton(BUTTON_UP_IO, ACKSEN_BUTTON_MODE_ACCELERATE, BUTTON_DEBOUNCE_INTERVAL, INPUT);
+AcksenButton btnDown	=	AcksenButton(BUTTON_DOWN_IO, ACKSEN_BUTTON_MODE_ACCELERATE, BUTTON_DEBOUNCE_INTERVAL, INPUT);
+
+long lSetpoint = 0;
+
+ 
+// ************************************************
+// Setup 
+// ************************************************
+void setup()
+{
+
+	// Initialise Serial Port
+	Serial.begin(DEBUG_BAUD_RATE);
+
+	btnUp.setRepeatInitialOffsetDelay(BUTTON_INITIAL_OFFSET_INTERVAL);
+	btnUp.setAccelerationCurve(SetpointCurve::auiTable, SetpointCurve::LENGTH);
+	
+	btnDown.setRepeatInitialOffsetDelay(BUTTON_INITIAL_OFFSET_INTERVAL);
+	btnDown.setAccelerationCurve(SetpointCurve::auiTable, SetpointCurve::LENGTH);
+
+	Serial.println("Startup Complete!");
+	
+}
+
+// ************************************************
+// Main Control Loop
+// ************************************************
+void loop()
+{
+	
+	unsigned long ulNow_MS = millis();
+	
+	btnUp.refreshStatus(ulNow_MS);
+	btnDown.refreshStatus(ulNow_MS);
+	
+	if (btnUp.onPressed() == true)
+	{
+		lSetpoint += getSetpointStep(btnUp.getRepeatCount());
+		printSetpoint();
+	}
+	
+	if (btnDown.onPressed() == true)
+	{
+		lSetpoint -= getSetpointStep(btnDown.getRepeatCount());
+		printSetpoint();
+	}
+	
+}
+
+// ************************************************
+// Setpoint Step - larger steps the longer a button is held
+// ************************************************
+long getSetpointStep(uint16_t uiRepeatCount)
+{
+	
+	if (uiRepeatCount < 20)
+	{
+		return 1;
+	}
+	else if (uiRepeatCount < 60)
+	{
+		return 10;
+	}
+	
+	return 100;
+	
+}
+
+void printSetpoint()
+{
+	
+	lSetpoint = constrain(lSetpoint, SETPOINT_MINIMUM, SETPOINT_MAXIMUM);
+	
+	Serial.print("Setpoint: ");
+	Serial.println(lSetpoint);
+	
+}
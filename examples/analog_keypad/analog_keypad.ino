@@ -0,0 +1,118 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission. 
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+/*
+Example: 		analog_keypad.ino
+Library:		AcksenButton
+Author: 		Acksen Ltd
+
+Created:		16 Oct 2026
+Last Modified:	16 Oct 2026
+
+Description:
+Demonstrate via debug serial port, reading the five buttons of an LCD keypad shield, which share analog pin A0
+through a resistor ladder, with AcksenButtonAnalog.
+
+The ladder is updated on every loop without waiting for the ADC, and each button is an AcksenButton, so buttons
+can use any button mode - here Up and Down repeat while held, and Select registers a Long Press. If the buttons
+are misread, print getLastReading() while pressing each one, and adjust the levels to suit.
+
+*/
+
+#include <AcksenButtonAnalog.h>
+
+// ***********************************
+// Serial Debug
+// ***********************************
+#define DEBUG_BAUD_RATE			115200
+
+
+// ***********************************
+// I/O  
+// ***********************************
+#define KEYPAD_ANALOG_PIN						A0
+
+
+// ***********************************
+// Constants
+// ***********************************
+#define BUTTON_DEBOUNCE_INTERVAL				20 		// Milliseconds
+
+#define KEYPAD_KEYS								5
+#define KEYPAD_IDLE_LEVEL						1023	// ADC reading with no button pressed
+
+// Nominal ADC reading for each button, in the order Right, Up, Down, Left, Select
+const uint16_t auiKeyLevels[KEYPAD_KEYS] = { 0, 131, 306, 479, 720 };
+
+const char* aszKeyNames[KEYPAD_KEYS] = { "Right", "Up", "Down", "Left", "Select" };
+
+
+// ***********************************
+// Variables
+// ***********************************
+AcksenButtonAnalog<KEYPAD_KEYS> anaKeypad	=	AcksenButtonAnalog<KEYPAD_KEYS>(KEYPAD_ANALOG_PIN, auiKeyLevels, KEYPAD_IDLE_LEVEL);
+
+AcksenButton abtnKeys[KEYPAD_KEYS] =
+{
+	AcksenButton(anaKeypad.getInput(0), ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL),
+	AcksenButton(anaKeypad.getInput(1), ACKSEN_BUTTON_MODE_REPEAT, BUTTON_DEBOUNCE_INTERVAL),
+	AcksenButton(anaKeypad.getInput(2), ACKSEN_BUTTON_MODE_REPEAT, BUTTON_DEBOUNCE_INTERVAL),
+	AcksenButton(anaKeypad.getInput(3), ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL),
+	AcksenButton(anaKeypad.getInput(4), ACKSEN_BUTTON_MODE_LONGPRESS, BUTTON_DEBOUNCE_INTERVAL)
+};
+
+ 
+// ************************************************
+// Setup 
+// ************************************************
+void setup()
+{
+
+	// Initialise Serial Port
+	Serial.begin(DEBUG_BAUD_RATE);
+
+	Serial.println("Startup Complete!");
+	
+}
+
+// ************************************************
+// Main Control Loop
+// ************************************************
+void loop()
+{
+	
+	unsigned long ulNow_MS = millis();
+	
+	// Collect the last conversion, if it has finished, and start the next - this never waits for the ADC
+	anaKeypad.update();
+	
+	for (uint8_t uiKey = 0; uiKey < KEYPAD_KEYS; uiKey++)
+	{
+		abtnKeys[uiKey].refreshStatus(ulNow_MS);
+		
+		if (abtnKeys[uiKey].onPressed() == true)
+		{
+			Serial.print("Button Pressed: ");
+			Serial.println(aszKeyNames[uiKey]);
+		}
+		
+		if (abtnKeys[uiKey].onLongPress() == true)
+		{
+			Serial.print("***Long Press: ");
+			Serial.println(aszKeyNames[uiKey]);
+		}
+	}
+	
+}
@@ -0,0 +1,114 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission. 
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+/*
+Example: 		button_bank.ino
+Library:		AcksenButton
+Author: 		Acksen Ltd
+
+Created:		16 Oct 2026
+Last Modified:	16 Oct 2026
+
+Description:
+Demonstrate via debug serial port, debouncing 8 buttons on one I/O port in a single pass with AcksenButtonBank.
+
+The whole port is read with one register access, and every button is debounced at once. Individual lanes can
+still use the Long Press, Repeat and Accelerate modes.
+
+*/
+
+#include <AcksenButtonBank.h>
+
+// ***********************************
+// Serial Debug
+// ***********************************
+#define DEBUG_BAUD_RATE			115200
+
+
+// ***********************************
+// I/O  
+// ***********************************
+#define BANK_FIRST_INPUT_IO						0		// Any pin on the port to be read - all 8 bits of its port are used
+
+
+// ***********************************
+// Constants
+// ***********************************
+#define BUTTON_DEBOUNCE_INTERVAL				20 		// Milliseconds
+
+#define LONG_PRESS_LANE							0
+#define REPEAT_LANE								1
+
+
+// ***********************************
+// Variables
+// ***********************************
+AcksenButtonBank8 bnkButtons	=	AcksenButtonBank8(BUTTON_DEBOUNCE_INTERVAL);
+
+volatile uint8_t* pButtonPort;
+
+ 
+// ************************************************
+// Setup 
+// ************************************************
+void setup()
+{
+
+	// Initialise Serial Port
+	Serial.begin(DEBUG_BAUD_RATE);
+	
+	// Look up the input register for the port once, so each refresh is a single register read
+	pButtonPort = (volatile uint8_t*)portInputRegister(digitalPinToPort(BANK_FIRST_INPUT_IO));
+	
+	// Buttons switch to ground with the internal pull-ups enabled, so a LOW input means pressed
+	bnkButtons.setInputInversion(0xFF);
+	
+	bnkButtons.setLaneOperatingMode(LONG_PRESS_LANE, ACKSEN_BUTTON_MODE_LONGPRESS);
+	bnkButtons.setLaneOperatingMode(REPEAT_LANE, ACKSEN_BUTTON_MODE_REPEAT);
+
+	Serial.println("Startup Complete!");
+	
+}
+
+// ************************************************
+// Main Control Loop
+// ************************************************
+void loop()
+{
+	
+	// Read the whole port and update every button in one pass
+	if (bnkButtons.refreshStatus(*pButtonPort) != 0)
+	{
+		Serial.print("Pressed mask=");
+		Serial.print(bnkButtons.getPressedMask(), BIN);
+		Serial.print(", Released mask=");
+		Serial.print(bnkButtons.getReleasedMask(), BIN);
+		Serial.print(", Held mask=");
+		Serial.println(bnkButtons.getHeldMask(), BIN);
+	}
+	
+	// Individual lanes behave like AcksenButton instances
+	if (bnkButtons.onLongPress(LONG_PRESS_LANE) == true)
+	{
+		Serial.println("***Long Press!");
+	}
+	
+	if (bnkButtons.onPressed(REPEAT_LANE) == true)
+	{
+		Serial.println("***Repeat Button Pressed!");
+	}
+	
+}
@@ -0,0 +1,115 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission. 
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+/*
+Example: 		compact_buttons.ino
+Library:		AcksenButton
+Author: 		Acksen Ltd
+
+Created:		16 Oct 2026
+Last Modified:	16 Oct 2026
+
+Description:
+Demonstrate via debug serial port, a panel of buttons using AcksenButtonCompact to save RAM.
+
+Each AcksenButtonCompact behaves exactly like an AcksenButton, but only needs a few bytes, as its intervals are
+kept in an AcksenButtonCompactConfig shared by the whole panel. This suits boards with many buttons and little RAM.
+
+*/
+
+#include <AcksenButtonCompact.h>
+
+// ***********************************
+// Serial Debug
+// ***********************************
+#define DEBUG_BAUD_RATE			115200
+
+
+// ***********************************
+// I/O  
+// ***********************************
+#define FIRST_BUTTON_INPUT_IO					2
+
+
+// ***********************************
+// Constants
+// ***********************************
+#define BUTTON_DEBOUNCE_INTERVAL				20 		// Milliseconds
+#define BUTTON_REPEAT_INTERVAL					250		// Milliseconds
+#define BUTTON_COUNT							8
+
+
+// ***********************************
+// Variables
+// ***********************************
+AcksenButtonCompactConfig cfgPanelButtons	=	AcksenButtonCompactConfig(BUTTON_DEBOUNCE_INTERVAL);
+
+AcksenButtonCompact btnPanel[BUTTON_COUNT] =
+{
+	AcksenButtonCompact(FIRST_BUTTON_INPUT_IO + 0, ACKSEN_BUTTON_MODE_NORMAL, &cfgPanelButtons, INPUT),
+	AcksenButtonCompact(FIRST_BUTTON_INPUT_IO + 1, ACKSEN_BUTTON_MODE_NORMAL, &cfgPanelButtons, INPUT),
+	AcksenButtonCompact(FIRST_BUTTON_INPUT_IO + 2, ACKSEN_BUTTON_MODE_NORMAL, &cfgPanelButtons, INPUT),
+	AcksenButtonCompact(FIRST_BUTTON_INPUT_IO + 3, ACKSEN_BUTTON_MODE_NORMAL, &cfgPanelButtons, INPUT),
+	AcksenButtonCompact(FIRST_BUTTON_INPUT_IO + 4, ACKSEN_BUTTON_MODE_LONGPRESS, &cfgPanelButtons, INPUT),
+	AcksenButtonCompact(FIRST_BUTTON_INPUT_IO + 5, ACKSEN_BUTTON_MODE_LONGPRESS, &cfgPanelButtons, INPUT),
+	AcksenButtonCompact(FIRST_BUTTON_INPUT_IO + 6, ACKSEN_BUTTON_MODE_REPEAT, &cfgPanelButtons, INPUT),
+	AcksenButtonCompact(FIRST_BUTTON_INPUT_IO + 7, ACKSEN_BUTTON_MODE_ACCELERATE, &cfgPanelButtons, INPUT)
+};
+
+ 
+// ************************************************
+// Setup 
+// ************************************************
+void setup()
+{
+
+	// Initialise Serial Port
+	Serial.begin(DEBUG_BAUD_RATE);
+	
+	// Changing the shared configuration affects every button that uses it
+	// Intervals are limited to ACKSEN_BUTTON_COMPACT_MAX_INTERVAL
+	cfgPanelButtons.uiRepeatPressesInterval_MS = BUTTON_REPEAT_INTERVAL;
+	
+	Serial.println("Startup Complete!");
+	
+}
+
+// ************************************************
+// Main Control Loop
+// ************************************************
+void loop()
+{
+	
+	for (uint8_t uiButton = 0; uiButton < BUTTON_COUNT; uiButton++)
+	{
+		
+		btnPanel[uiButton].refreshStatus();
+		
+		if (btnPanel[uiButton].onPressed() == true)
+		{
+			Serial.print("***Button Pressed: ");
+			Serial.println(uiButton);
+		}
+		
+		if (btnPanel[uiButton].onLongPress() == true)
+		{
+			Serial.print("***Button Long Press: ");
+			Serial.println(uiButton);
+		}
+		
+	}
+	
+}
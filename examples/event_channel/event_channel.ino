@@ -0,0 +1,163 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission. 
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+/*
+Example: 		event_channel.ino
+Library:		AcksenButton
+Author: 		Acksen Ltd
+
+Created:		16 Oct 2026
+Last Modified:	16 Oct 2026
+
+Description:
+Demonstrate via debug serial port, scanning buttons in one FreeRTOS task and handling their events in another,
+on a dual-core ESP32.
+
+The scanning task, pinned to core 0, refreshes both buttons every millisecond. Their events are published to an
+event channel, a lock-free single-producer/single-consumer ring, tagged with each button's id. The main loop, on
+core 1, pops events from the channel. It never calls onPressed() or any other method of the buttons, which belong
+to the scanning task, so no locks are needed.
+
+The library must be built with ACKSEN_BUTTON_EVENTS set to 1 - edit the default in AcksenButton.h, or add
+-DACKSEN_BUTTON_EVENTS=1 to the build flags.
+
+*/
+
+#include <AcksenButton.h>
+
+#if !defined(ESP32)
+#error "This example needs a dual-core ESP32"
+#endif
+
+#if !ACKSEN_BUTTON_EVENTS
+#error "Set ACKSEN_BUTTON_EVENTS to 1 in AcksenButton.h to use event channels"
+#endif
+
+// ***********************************
+// Serial Debug
+// ***********************************
+#define DEBUG_BAUD_RATE			115200
+
+
+// ***********************************
+// I/O  
+// ***********************************
+#define BUTTON_SELECT_INPUT_IO			12
+#define BUTTON_UP_INPUT_IO				13
+
+
+// ***********************************
+// Constants
+// ***********************************
+#define BUTTON_DEBOUNCE_INTERVAL				20 		// Milliseconds
+
+#define BUTTON_ID_SELECT						0
+#define BUTTON_ID_UP							1
+
+#define SCAN_TASK_STACK							2048	// Bytes
+#define SCAN_TASK_PRIORITY						2
+#define SCAN_TASK_CORE							0
+
+
+// ***********************************
+// Variables
+// ***********************************
+AcksenButton btnSelectButton	=	AcksenButton(BUTTON_SELECT_INPUT_IO, ACKSEN_BUTTON_MODE_LONGPRESS, BUTTON_DEBOUNCE_INTERVAL, INPUT);
+AcksenButton btnUpButton		=	AcksenButton(BUTTON_UP_INPUT_IO, ACKSEN_BUTTON_MODE_ACCELERATE, BUTTON_DEBOUNCE_INTERVAL, INPUT);
+
+// Written by the scanning task only, read by the main loop only
+AcksenButtonEventChannel chnButtonEvents;
+
+
+// ************************************************
+// Scanning Task
+// ************************************************
+void scanButtons(void* pParameters)
+{
+	
+	TickType_t tLastWake = xTaskGetTickCount();
+	
+	while (true)
+	{
+		
+		unsigned long ulNow = millis();
+		
+		btnSelectButton.refreshStatus(ulNow);
+		btnUpButton.refreshStatus(ulNow);
+		
+		vTaskDelayUntil(&tLastWake, pdMS_TO_TICKS(1));
+		
+	}
+	
+}
+
+ 
+// ************************************************
+// Setup 
+// ************************************************
+void setup()
+{
+
+	// Initialise Serial Port
+	Serial.begin(DEBUG_BAUD_RATE);
+	
+	// Attach the channel before the scanning task starts
+	btnSelectButton.setEventChannel(&chnButtonEvents, BUTTON_ID_SELECT);
+	btnUpButton.setEventChannel(&chnButtonEvents, BUTTON_ID_UP);
+	
+	xTaskCreatePinnedToCore(scanButtons, "scanButtons", SCAN_TASK_STACK, NULL, SCAN_TASK_PRIORITY, NULL, SCAN_TASK_CORE);
+	
+	Serial.println("Startup Complete!");
+
+}
+
+// ************************************************
+// Main Control Loop
+// ************************************************
+void loop()
+{
+	
+	AcksenButtonChannelEvent evtButton;
+	
+	while (chnButtonEvents.pop(evtButton) == true)
+	{
+		
+		Serial.print((evtButton.uiButtonId == BUTTON_ID_SELECT) ? "Select " : "Up ");
+		
+		switch (evtButton.uiType)
+		{
+			case ACKSEN_BUTTON_EVENT_PRESSED:	Serial.print("Pressed");	break;
+			case ACKSEN_BUTTON_EVENT_RELEASED:	Serial.print("Released");	break;
+			case ACKSEN_BUTTON_EVENT_LONGPRESS:	Serial.print("Long Press");	break;
+			case ACKSEN_BUTTON_EVENT_REPEAT:	Serial.print("Repeat");		break;
+			default:							Serial.print("Other");		break;
+		}
+		
+		Serial.print(" at ");
+		Serial.println(evtButton.ulTimestamp_MS);
+		
+	}
+	
+	// Events published while the channel was full are counted, rather than silently lost
+	if (chnButtonEvents.getOverflowCount() > 0)
+	{
+		Serial.print("Overflowed events=");
+		Serial.println(chnButtonEvents.getOverflowCount());
+	}
+	
+	delay(10);
+	
+}
@@ -0,0 +1,126 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission. 
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+/*
+Example: 		event_queue.ino
+Library:		AcksenButton
+Author: 		Acksen Ltd
+
+Created:		16 Oct 2026
+Last Modified:	16 Oct 2026
+
+Description:
+Demonstrate via debug serial port, reading button events from a per-button event queue.
+
+onPressed() and onReleased() only report what happened in the most recent refreshStatus() call, so a slow main
+loop can miss presses, releases and repeats. With an event queue attached, every event is kept (with the time it
+occurred) until it is read with pollEvent(), so a slow loop processes the backlog in one batch instead.
+
+The library must be built with ACKSEN_BUTTON_EVENTS set to 1 - edit the default in AcksenButton.h, or add
+-DACKSEN_BUTTON_EVENTS=1 to the build flags.
+
+*/
+
+#include <AcksenButton.h>
+
+#if !ACKSEN_BUTTON_EVENTS
+#error "Set ACKSEN_BUTTON_EVENTS to 1 in AcksenButton.h to use event queues"
+#endif
+
+// ***********************************
+// Serial Debug
+// ***********************************
+#define DEBUG_BAUD_RATE			115200
+
+
+// ***********************************
+// I/O  
+// ***********************************
+#define BUTTON_INPUT_IO					13
+
+
+// ***********************************
+// Constants
+// ***********************************
+#define BUTTON_DEBOUNCE_INTERVAL				20 		// Milliseconds
+#define SERIAL_DEBUG_UPDATE_DELAY				1000	// Milliseconds
+
+
+// ***********************************
+// Variables
+// ***********************************
+AcksenButton btnAccelButton		=	AcksenButton(BUTTON_INPUT_IO, ACKSEN_BUTTON_MODE_ACCELERATE, BUTTON_DEBOUNCE_INTERVAL, INPUT);
+
+AcksenButtonEventQueue queAccelButtonEvents;
+
+// Timer variable to control how often the queue is serviced
+unsigned long ulUpdateSerialDebug;
+
+ 
+// ************************************************
+// Setup 
+// ************************************************
+void setup()
+{
+
+	// Initialise Serial Port
+	Serial.begin(DEBUG_BAUD_RATE);
+	
+	btnAccelButton.setEventQueue(&queAccelButtonEvents);
+	
+	Serial.println("Startup Complete!");
+
+}
+
+// ************************************************
+// Main Control Loop
+// ************************************************
+void loop()
+{
+	
+	// Read the I/O Port and update the button status - events are queued as they occur
+	btnAccelButton.refreshStatus();
+	
+	// Only service the queue once a second, to show that events are not lost in the meantime
+	if (millis() - ulUpdateSerialDebug >= SERIAL_DEBUG_UPDATE_DELAY)
+	{
+		
+		AcksenButtonEvent evtButton;
+		
+		while (btnAccelButton.pollEvent(evtButton) == true)
+		{
+			
+			switch (evtButton.uiType)
+			{
+				case ACKSEN_BUTTON_EVENT_PRESSED:	Serial.print("Pressed");	break;
+				case ACKSEN_BUTTON_EVENT_RELEASED:	Serial.print("Released");	break;
+				case ACKSEN_BUTTON_EVENT_REPEAT:	Serial.print("Repeat");		break;
+				default:							Serial.print("Other");		break;
+			}
+			
+			Serial.print(" at ");
+			Serial.println(evtButton.ulTimestamp_MS);
+			
+		}
+		
+		// Events that arrived while the queue was full are counted, rather than silently lost
+		Serial.print("Overflowed events=");
+		Serial.println(btnAccelButton.getEventOverflowCount());
+		
+		ulUpdateSerialDebug = millis();
+	}
+	
+}
@@ -0,0 +1,116 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission. 
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+/*
+Example: 		gestures.ino
+Library:		AcksenButton
+Author: 		Acksen Ltd
+
+Created:		16 Oct 2026
+Last Modified:	16 Oct 2026
+
+Description:
+Demonstrate via debug serial port, detecting clicks, double-clicks and chords with AcksenButtonGestures.
+
+The Select button reports single clicks as soon as it is released. The Mode button counts up to two clicks, so
+a single click is only reported once the click window has passed without a second. Holding Select and Mode
+together reports a chord, instead of a click on either.
+
+*/
+
+#include <AcksenButtonGesture.h>
+
+// ***********************************
+// Serial Debug
+// ***********************************
+#define DEBUG_BAUD_RATE			115200
+
+
+// ***********************************
+// I/O  
+// ***********************************
+#define BUTTON_SELECT_IO				12
+#define BUTTON_MODE_IO					13
+
+
+// ***********************************
+// Constants
+// ***********************************
+#define BUTTON_DEBOUNCE_INTERVAL				20 		// Milliseconds
+
+#define GESTURE_SELECT							0		// Buttons, in the order added
+#define GESTURE_MODE							1
+
+
+// ***********************************
+// Variables
+// ***********************************
+AcksenButton btnSelect	=	AcksenButton(BUTTON_SELECT_IO, ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL, INPUT);
+AcksenButton btnMode	=	AcksenButton(BUTTON_MODE_IO, ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL, INPUT);
+
+AcksenButtonGestures<2> gstButtons;
+
+ 
+// ************************************************
+// Setup 
+// ************************************************
+void setup()
+{
+
+	// Initialise Serial Port
+	Serial.begin(DEBUG_BAUD_RATE);
+
+	gstButtons.add(&btnSelect);
+	gstButtons.add(&btnMode);
+	
+	gstButtons.setMultiClick(GESTURE_MODE, 2);
+	gstButtons.addChord(GESTURE_SELECT, GESTURE_MODE);
+
+	Serial.println("Startup Complete!");
+	
+}
+
+// ************************************************
+// Main Control Loop
+// ************************************************
+void loop()
+{
+	
+	AcksenButtonGesture sGesture;
+	
+	// Refresh both buttons, then report any gestures completed
+	gstButtons.update();
+	
+	while (gstButtons.pollGesture(sGesture) == true)
+	{
+		if (sGesture.uiType == ACKSEN_BUTTON_GESTURE_CHORD)
+		{
+			Serial.println("Chord: Select + Mode");
+		}
+		else if (sGesture.uiIndex == GESTURE_SELECT)
+		{
+			Serial.println("Select Clicked");
+		}
+		else if (sGesture.uiCount == 2)
+		{
+			Serial.println("Mode Double-Clicked");
+		}
+		else
+		{
+			Serial.println("Mode Clicked");
+		}
+	}
+	
+}
@@ -0,0 +1,127 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission. 
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+/*
+Example: 		interrupt_button.ino
+Library:		AcksenButton
+Author: 		Acksen Ltd
+
+Created:		16 Oct 2026
+Last Modified:	16 Oct 2026
+
+Description:
+Demonstrate via debug serial port, capturing button edges by interrupt so that presses are neither missed, nor
+their timing distorted, when the main loop is busy for long periods.
+
+The pin-change interrupt timestamps each raw edge into a ring buffer. refreshStatus() then debounces the edges
+using the time they actually occurred, rather than the time the main loop got round to looking at the pin.
+
+The library must be built with ACKSEN_BUTTON_EDGE_CAPTURE set to 1 - edit the default in AcksenButton.h, or add
+-DACKSEN_BUTTON_EDGE_CAPTURE=1 to the build flags.
+
+*/
+
+#include <AcksenButton.h>
+
+#if !ACKSEN_BUTTON_EDGE_CAPTURE
+#error "Set ACKSEN_BUTTON_EDGE_CAPTURE to 1 in AcksenButton.h to capture edges by interrupt"
+#endif
+
+// ***********************************
+// Serial Debug
+// ***********************************
+#define DEBUG_BAUD_RATE			115200
+
+
+// ***********************************
+// I/O  
+// ***********************************
+#define BUTTON_INPUT_IO					2		// Must be a pin that supports attachInterrupt()
+
+
+// ***********************************
+// Constants
+// ***********************************
+#define BUTTON_DEBOUNCE_INTERVAL				20 		// Milliseconds
+#define BUSY_WORK_DELAY							500		// Milliseconds
+
+
+// ***********************************
+// Variables
+// ***********************************
+AcksenButton btnInterruptButton	=	AcksenButton(BUTTON_INPUT_IO, ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL, INPUT);
+
+// Edges are passed from the interrupt handler to refreshStatus() through this ring
+AcksenButtonEdgeRing ringButtonEdges;
+
+
+// ************************************************
+// Interrupt Handler
+// ************************************************
+void buttonPinChanged()
+{
+	btnInterruptButton.captureEdge();
+}
+
+ 
+// ************************************************
+// Setup 
+// ************************************************
+void setup()
+{
+
+	// Initialise Serial Port
+	Serial.begin(DEBUG_BAUD_RATE);
+	
+	// Switch the button over to interrupt-driven edge capture
+	btnInterruptButton.setEdgeCapture(&ringButtonEdges);
+	attachInterrupt(digitalPinToInterrupt(BUTTON_INPUT_IO), buttonPinChanged, CHANGE);
+	
+	Serial.println("Startup Complete!");
+	
+}
+
+// ************************************************
+// Main Control Loop
+// ************************************************
+void loop()
+{
+	
+	// Debounce any edges captured since the last refresh
+	// Only one state change is reported per refresh, so keep refreshing until there are none left
+	while (btnInterruptButton.refreshStatus() == true)
+	{
+		
+		if (btnInterruptButton.onPressed() == true)
+		{
+			Serial.print("***Button Pressed ");
+			Serial.print(btnInterruptButton.getTimeFromLastStateChange());
+			Serial.println("ms ago");
+		}
+		
+		if (btnInterruptButton.onReleased() == true)
+		{
+			Serial.print("***Button Released ");
+			Serial.print(btnInterruptButton.getTimeFromLastStateChange());
+			Serial.println("ms ago");
+		}
+		
+	}
+	
+	// Stand-in for other work that keeps the main loop away from the button for a long time
+	delay(BUSY_WORK_DELAY);
+	
+}
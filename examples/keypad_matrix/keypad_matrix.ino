@@ -0,0 +1,131 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission. 
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+/*
+Example: 		keypad_matrix.ino
+Library:		AcksenButton
+Author: 		Acksen Ltd
+
+Created:		16 Oct 2026
+Last Modified:	16 Oct 2026
+
+Description:
+Demonstrate via debug serial port, reading a 4x4 keypad matrix with AcksenButtonMatrix.
+
+Each key is an AcksenButton, so keys can use any button mode - here the '#' key repeats while held, and the
+'*' key registers a Long Press. If three keys at the corners of a rectangle are held, the matrix cannot tell
+which keys are pressed, and ghosting is reported.
+
+*/
+
+#include <AcksenButtonMatrix.h>
+
+// ***********************************
+// Serial Debug
+// ***********************************
+#define DEBUG_BAUD_RATE			115200
+
+
+// ***********************************
+// I/O  
+// ***********************************
+const uint8_t auiRowPins[4]		=	{ 2, 3, 4, 5 };
+const uint8_t auiColumnPins[4]	=	{ 6, 7, 8, 9 };
+
+
+// ***********************************
+// Constants
+// ***********************************
+#define BUTTON_DEBOUNCE_INTERVAL				20 		// Milliseconds
+
+#define KEYPAD_ROWS								4
+#define KEYPAD_COLUMNS							4
+#define KEYPAD_KEYS								(KEYPAD_ROWS * KEYPAD_COLUMNS)
+
+const char acKeyNames[KEYPAD_KEYS] = { '1', '2', '3', 'A', '4', '5', '6', 'B', '7', '8', '9', 'C', '*', '0', '#', 'D' };
+
+
+// ***********************************
+// Variables
+// ***********************************
+AcksenButtonMatrix<KEYPAD_ROWS, KEYPAD_COLUMNS> mtxKeypad	=	AcksenButtonMatrix<KEYPAD_ROWS, KEYPAD_COLUMNS>(auiRowPins, auiColumnPins);
+
+AcksenButton abtnKeys[KEYPAD_KEYS] =
+{
+	AcksenButton(mtxKeypad.getKeyInput(0, 0), ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL),
+	AcksenButton(mtxKeypad.getKeyInput(0, 1), ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL),
+	AcksenButton(mtxKeypad.getKeyInput(0, 2), ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL),
+	AcksenButton(mtxKeypad.getKeyInput(0, 3), ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL),
+	AcksenButton(mtxKeypad.getKeyInput(1, 0), ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL),
+	AcksenButton(mtxKeypad.getKeyInput(1, 1), ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL),
+	AcksenButton(mtxKeypad.getKeyInput(1, 2), ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL),
+	AcksenButton(mtxKeypad.getKeyInput(1, 3), ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL),
+	AcksenButton(mtxKeypad.getKeyInput(2, 0), ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL),
+	AcksenButton(mtxKeypad.getKeyInput(2, 1), ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL),
+	AcksenButton(mtxKeypad.getKeyInput(2, 2), ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL),
+	AcksenButton(mtxKeypad.getKeyInput(2, 3), ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL),
+	AcksenButton(mtxKeypad.getKeyInput(3, 0), ACKSEN_BUTTON_MODE_LONGPRESS, BUTTON_DEBOUNCE_INTERVAL),
+	AcksenButton(mtxKeypad.getKeyInput(3, 1), ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL),
+	AcksenButton(mtxKeypad.getKeyInput(3, 2), ACKSEN_BUTTON_MODE_REPEAT, BUTTON_DEBOUNCE_INTERVAL),
+	AcksenButton(mtxKeypad.getKeyInput(3, 3), ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL)
+};
+
+ 
+// ************************************************
+// Setup 
+// ************************************************
+void setup()
+{
+
+	// Initialise Serial Port
+	Serial.begin(DEBUG_BAUD_RATE);
+
+	Serial.println("Startup Complete!");
+	
+}
+
+// ************************************************
+// Main Control Loop
+// ************************************************
+void loop()
+{
+	
+	unsigned long ulNow_MS = millis();
+	
+	// Read the whole keypad, then update every key from the same scan
+	if (mtxKeypad.scan() == true)
+	{
+		Serial.println("***Ghosting - release a key!");
+	}
+	
+	for (uint8_t uiKey = 0; uiKey < KEYPAD_KEYS; uiKey++)
+	{
+		abtnKeys[uiKey].refreshStatus(ulNow_MS);
+		
+		if (abtnKeys[uiKey].onPressed() == true)
+		{
+			Serial.print("Key Pressed: ");
+			Serial.println(acKeyNames[uiKey]);
+		}
+		
+		if (abtnKeys[uiKey].onLongPress() == true)
+		{
+			Serial.print("***Long Press: ");
+			Serial.println(acKeyNames[uiKey]);
+		}
+	}
+	
+}
@@ -0,0 +1,120 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission. 
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+/*
+Example: 		rotary_encoder.ino
+Library:		AcksenButton
+Author: 		Acksen Ltd
+
+Created:		16 Oct 2026
+Last Modified:	16 Oct 2026
+
+Description:
+Demonstrate via debug serial port, reading a quadrature rotary encoder with a push switch.
+
+Both encoder outputs are decoded by pin-change interrupts, so no detent is lost while the main loop is busy. Fast
+turns are accelerated, moving several steps per detent, and pressing the switch returns the position to zero.
+
+*/
+
+#include <AcksenButton.h>
+#include <AcksenButtonEncoder.h>
+
+// ***********************************
+// Serial Debug
+// ***********************************
+#define DEBUG_BAUD_RATE			115200
+
+
+// ***********************************
+// I/O  
+// ***********************************
+#define ENCODER_A_INPUT_IO				2		// Must be a pin that supports attachInterrupt()
+#define ENCODER_B_INPUT_IO				3		// Must be a pin that supports attachInterrupt()
+#define ENCODER_SWITCH_INPUT_IO			4
+
+
+// ***********************************
+// Constants
+// ***********************************
+#define SWITCH_DEBOUNCE_INTERVAL				20 		// Milliseconds
+#define BUSY_WORK_DELAY							100		// Milliseconds
+
+
+// ***********************************
+// Variables
+// ***********************************
+AcksenButtonEncoder encRotaryEncoder	=	AcksenButtonEncoder(ENCODER_A_INPUT_IO, ENCODER_B_INPUT_IO, ACKSEN_BUTTON_MODE_ACCELERATE, INPUT_PULLUP);
+AcksenButton btnEncoderSwitch	=	AcksenButton(ENCODER_SWITCH_INPUT_IO, ACKSEN_BUTTON_MODE_NORMAL, SWITCH_DEBOUNCE_INTERVAL, INPUT_PULLUP);
+
+
+// ************************************************
+// Interrupt Handler
+// ************************************************
+void encoderPinChanged()
+{
+	encRotaryEncoder.captureEdge();
+}
+
+ 
+// ************************************************
+// Setup 
+// ************************************************
+void setup()
+{
+
+	// Initialise Serial Port
+	Serial.begin(DEBUG_BAUD_RATE);
+	
+	// The push switch is refreshed along with the encoder
+	encRotaryEncoder.setSwitch(&btnEncoderSwitch);
+	
+	// Switch the encoder over to interrupt-driven decoding, on both pins
+	encRotaryEncoder.setEdgeCapture(true);
+	attachInterrupt(digitalPinToInterrupt(ENCODER_A_INPUT_IO), encoderPinChanged, CHANGE);
+	attachInterrupt(digitalPinToInterrupt(ENCODER_B_INPUT_IO), encoderPinChanged, CHANGE);
+	
+	Serial.println("Startup Complete!");
+	
+}
+
+// ************************************************
+// Main Control Loop
+// ************************************************
+void loop()
+{
+	
+	// Collect the detents decoded since the last update, and refresh the switch
+	if (encRotaryEncoder.update() == true)
+	{
+		Serial.print("***Position ");
+		Serial.print(encRotaryEncoder.getPosition());
+		Serial.print(" (turned ");
+		Serial.print(encRotaryEncoder.getSteps());
+		Serial.println(" steps)");
+	}
+	
+	// Switch is active LOW, so a press is reported as released
+	if (btnEncoderSwitch.onReleased() == true)
+	{
+		encRotaryEncoder.setPosition(0);
+		Serial.println("***Switch Pressed - Position Reset");
+	}
+	
+	// Stand-in for other work that keeps the main loop away from the encoder
+	delay(BUSY_WORK_DELAY);
+	
+}
@@ -0,0 +1,137 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission. 
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+/*
+Example: 		shift_register_buttons.ino
+Library:		AcksenButton
+Author: 		Acksen Ltd
+
+Created:		16 Oct 2026
+Last Modified:	16 Oct 2026
+
+Description:
+Demonstrate via debug serial port, reading 64 buttons through a chain of eight 74HC165 shift registers with
+AcksenButtonShiftIn.
+
+The whole chain is latched and read in one SPI transfer per loop, and each input is an AcksenButton, so inputs
+can use any button mode - here input 0 repeats while held, and input 1 registers a Long Press. The buttons pull
+their inputs LOW when pressed, so the inputs are inverted as they are read.
+
+Wiring: SH/LD of every register to the latch pin, CLK of every register to SCK, QH of the first register to MISO,
+and SER of each register to QH of the next. CLK INH is tied LOW.
+
+*/
+
+#include <SPI.h>
+#include <AcksenButtonShiftIn.h>
+
+// ***********************************
+// Serial Debug
+// ***********************************
+#define DEBUG_BAUD_RATE			115200
+
+
+// ***********************************
+// I/O  
+// ***********************************
+#define SHIFT_REGISTER_LATCH_PIN				10
+
+
+// ***********************************
+// Constants
+// ***********************************
+#define BUTTON_DEBOUNCE_INTERVAL				20 		// Milliseconds
+
+#define SHIFT_REGISTER_BYTES					8
+#define SHIFT_REGISTER_INPUTS					(SHIFT_REGISTER_BYTES * 8)
+
+
+// ***********************************
+// Variables
+// ***********************************
+void transferShiftRegisters(uint8_t* auiBuffer, uint8_t uiLength);
+
+AcksenButtonShiftIn<SHIFT_REGISTER_BYTES> sinButtons	=	AcksenButtonShiftIn<SHIFT_REGISTER_BYTES>(SHIFT_REGISTER_LATCH_PIN, transferShiftRegisters);
+
+AcksenButton* pabtnInputs[SHIFT_REGISTER_INPUTS];
+
+ 
+// ************************************************
+// Setup 
+// ************************************************
+void setup()
+{
+
+	// Initialise Serial Port
+	Serial.begin(DEBUG_BAUD_RATE);
+
+	SPI.begin();
+	
+	sinButtons.setInputInversion(true);
+	
+	for (uint8_t uiInput = 0; uiInput < SHIFT_REGISTER_INPUTS; uiInput++)
+	{
+		pabtnInputs[uiInput] = new AcksenButton(sinButtons.getInput(uiInput), ACKSEN_BUTTON_MODE_NORMAL, BUTTON_DEBOUNCE_INTERVAL);
+	}
+	
+	pabtnInputs[0]->setButtonOperatingMode(ACKSEN_BUTTON_MODE_REPEAT);
+	pabtnInputs[1]->setButtonOperatingMode(ACKSEN_BUTTON_MODE_LONGPRESS);
+
+	Serial.println("Startup Complete!");
+	
+}
+
+// ************************************************
+// Main Control Loop
+// ************************************************
+void loop()
+{
+	
+	unsigned long ulNow_MS = millis();
+	
+	// Read the whole chain in one transfer, then update every button from the same read
+	sinButtons.read();
+	
+	for (uint8_t uiInput = 0; uiInput < SHIFT_REGISTER_INPUTS; uiInput++)
+	{
+		pabtnInputs[uiInput]->refreshStatus(ulNow_MS);
+		
+		if (pabtnInputs[uiInput]->onPressed() == true)
+		{
+			Serial.print("Button Pressed: ");
+			Serial.println(uiInput);
+		}
+		
+		if (pabtnInputs[uiInput]->onLongPress() == true)
+		{
+			Serial.print("***Long Press: ");
+			Serial.println(uiInput);
+		}
+	}
+	
+}
+
+// ************************************************
+// Shift Register Transfer
+// ************************************************
+void transferShiftRegisters(uint8_t* auiBuffer, uint8_t uiLength)
+{
+	
+	// The 74HC165 shifts on the rising clock edge, and presents its first bit as soon as it is loaded
+	SPI.beginTransaction(SPISettings(4000000, MSBFIRST, SPI_MODE0));
+	SPI.transfer(auiBuffer, uiLength);
+	SPI.endTransaction();
+	
+}
@@ -0,0 +1,101 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission. 
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+/*
+Example: 		static_button.ino
+Library:		AcksenButton
+Author: 		Acksen Ltd
+
+Created:		16 Oct 2026
+Last Modified:	16 Oct 2026
+
+Description:
+Demonstrate via debug serial port, buttons whose pin, mode and intervals are fixed at compile time.
+
+AcksenButtonStatic only stores the state its mode needs, and its refreshStatus() has no mode checks, so it uses
+less RAM and fewer cycles than AcksenButton. Use AcksenButton where the mode or intervals change at run time.
+
+*/
+
+#include <AcksenButtonStatic.h>
+
+// ***********************************
+// Serial Debug
+// ***********************************
+#define DEBUG_BAUD_RATE			115200
+
+
+// ***********************************
+// I/O  
+// ***********************************
+#define LONG_PRESS_BUTTON_INPUT_IO				12
+#define ACCEL_BUTTON_INPUT_IO					13
+
+
+// ***********************************
+// Constants
+// ***********************************
+#define BUTTON_DEBOUNCE_INTERVAL				20 		// Milliseconds
+#define BUTTON_LONG_PRESS_INTERVAL				1000	// Milliseconds
+
+
+// ***********************************
+// Variables
+// ***********************************
+AcksenButtonStatic<LONG_PRESS_BUTTON_INPUT_IO, ACKSEN_BUTTON_MODE_LONGPRESS, BUTTON_DEBOUNCE_INTERVAL, BUTTON_LONG_PRESS_INTERVAL> btnLongPressButton(INPUT);
+
+// Intervals not given take the same defaults as AcksenButton
+AcksenButtonStatic<ACCEL_BUTTON_INPUT_IO, ACKSEN_BUTTON_MODE_ACCELERATE, BUTTON_DEBOUNCE_INTERVAL> btnAccelButton(INPUT);
+
+int iAccelButtonPressCount;
+
+ 
+// ************************************************
+// Setup 
+// ************************************************
+void setup()
+{
+
+	// Initialise Serial Port
+	Serial.begin(DEBUG_BAUD_RATE);
+	
+	Serial.println("Startup Complete!");
+	
+}
+
+// ************************************************
+// Main Control Loop
+// ************************************************
+void loop()
+{
+	
+	btnLongPressButton.refreshStatus();
+	btnAccelButton.refreshStatus();
+	
+	if (btnLongPressButton.onLongPress() == true)
+	{
+		Serial.println("***Long Press!");
+	}
+	
+	if (btnAccelButton.onPressed() == true)
+	{
+		iAccelButtonPressCount++;
+		
+		Serial.print("AccelCount=");
+		Serial.println(iAccelButtonPressCount);
+	}
+	
+}
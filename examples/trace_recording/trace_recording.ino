@@ -0,0 +1,124 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission. 
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+/*
+Example: 		trace_recording.ino
+Library:		AcksenButton
+Author: 		Acksen Ltd
+
+Created:		16 Oct 2026
+Last Modified:	16 Oct 2026
+
+Description:
+Demonstrate recording a binary trace of two buttons' raw inputs and events to the serial port, for replaying on a
+host PC.
+
+The library must be built with ACKSEN_BUTTON_TRACE and ACKSEN_BUTTON_DEBOUNCE_STRATEGIES set to 1 - edit the
+defaults in AcksenButton.h, or add -DACKSEN_BUTTON_TRACE=1 -DACKSEN_BUTTON_DEBOUNCE_STRATEGIES=1 to the build flags.
+Capture the serial output to a file with any terminal program that can log raw binary data, then replay it
+through the library with extras/host/replay:
+
+	./replay capture.trace
+
+Most edges take two bytes. Only binary data is written to the serial port, so nothing else can be printed.
+
+*/
+
+#include <AcksenButton.h>
+#include <AcksenButtonTrace.h>
+
+#if !ACKSEN_BUTTON_TRACE
+#error "Set ACKSEN_BUTTON_TRACE to 1 in AcksenButton.h to record traces"
+#endif
+
+#if !ACKSEN_BUTTON_DEBOUNCE_STRATEGIES
+#error "Set ACKSEN_BUTTON_DEBOUNCE_STRATEGIES to 1 in AcksenButton.h to use the Integrator strategy"
+#endif
+
+// ***********************************
+// Serial Debug
+// ***********************************
+#define DEBUG_BAUD_RATE			115200
+
+
+// ***********************************
+// I/O  
+// ***********************************
+#define BUTTON_MODE_INPUT_IO			12
+#define BUTTON_UP_INPUT_IO				13
+
+
+// ***********************************
+// Constants
+// ***********************************
+#define BUTTON_DEBOUNCE_INTERVAL				20 		// Milliseconds
+
+#define TRACE_CHANNEL_MODE						0
+#define TRACE_CHANNEL_UP						1
+
+
+// ***********************************
+// Variables
+// ***********************************
+AcksenButton btnModeButton		=	AcksenButton(BUTTON_MODE_INPUT_IO, ACKSEN_BUTTON_MODE_LONGPRESS, BUTTON_DEBOUNCE_INTERVAL, INPUT);
+AcksenButton btnUpButton		=	AcksenButton(BUTTON_UP_INPUT_IO, ACKSEN_BUTTON_MODE_ACCELERATE, BUTTON_DEBOUNCE_INTERVAL, INPUT);
+
+// Each byte of the trace is sent straight to the serial port
+void writeTrace(uint8_t uiByte)
+{
+	Serial.write(uiByte);
+}
+
+AcksenButtonTraceRecorder recTrace(writeTrace);
+
+ 
+// ************************************************
+// Setup 
+// ************************************************
+void setup()
+{
+
+	// Initialise Serial Port
+	Serial.begin(DEBUG_BAUD_RATE);
+	
+	// Configure the buttons first - their settings are recorded when they are attached to the trace
+	btnModeButton.setDebounceStrategy(ACKSEN_BUTTON_DEBOUNCE_INTEGRATOR);
+	btnModeButton.setLongPressInterval(1000);
+	
+	// The main loop refreshes the buttons at least once a millisecond, so the trace does not need to record each refresh
+	recTrace.begin();
+	
+	btnModeButton.setTraceRecorder(&recTrace, TRACE_CHANNEL_MODE);
+	btnUpButton.setTraceRecorder(&recTrace, TRACE_CHANNEL_UP);
+
+}
+
+// ************************************************
+// Main Control Loop
+// ************************************************
+void loop()
+{
+	
+	// Read the I/O Ports and update the button status - edges and events are recorded as they occur
+	btnModeButton.refreshStatus();
+	btnUpButton.refreshStatus();
+	
+	// The application would handle the buttons here as normal
+	btnModeButton.onPressed();
+	btnModeButton.onLongPress();
+	btnUpButton.onPressed();
+	
+}
@@ -0,0 +1,276 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+#include <atomic>
+
+#include "AcksenButtonHost.h"
+#include "AcksenButtonAnalog.h"
+
+// Simulated clock - atomic, and sequentially consistent, so that a thread standing in for an ISR both reads it
+// safely and publishes everything it did before advancing it
+static std::atomic<unsigned long> ulHostMillis(0);
+static std::atomic<unsigned long> ulHostMicros(0);
+static unsigned long ulHostMicrosFraction = 0;		// Microseconds since getMillis() last advanced
+
+// Mock GPIO, laid out like an AVR: pins are looked up in port/bitmask tables, as the Arduino core does
+static volatile uint8_t aHostPortInput[ACKSEN_HOST_PORT_COUNT];
+static uint8_t aHostPinMode[ACKSEN_HOST_PIN_COUNT];
+static bool aHostPinOutput[ACKSEN_HOST_PIN_COUNT];
+static AcksenButtonHostOutputHook pHostOutputHook = NULL;
+static AcksenButtonHostDelayHook pHostDelayHook = NULL;
+
+// Mock ADC - a conversion samples its input when started, and completes after a set number of polls
+static uint16_t aHostAnalogInput[ACKSEN_HOST_PIN_COUNT];
+static uint16_t uiHostAnalogResult = 0;
+static uint8_t uiHostAnalogPolls = 0;
+static uint8_t uiHostAnalogPollsLeft = 0;
+
+static const uint8_t aHostPinToPort[ACKSEN_HOST_PIN_COUNT] =
+{
+	0, 0, 0, 0, 0, 0, 0, 0,
+	1, 1, 1, 1, 1, 1, 1, 1,
+	2, 2, 2, 2, 2, 2, 2, 2,
+	3, 3, 3, 3, 3, 3, 3, 3,
+	4, 4, 4, 4, 4, 4, 4, 4,
+	5, 5, 5, 5, 5, 5, 5, 5,
+	6, 6, 6, 6, 6, 6, 6, 6,
+	7, 7, 7, 7, 7, 7, 7, 7
+};
+
+static const uint8_t aHostPinToBitMask[ACKSEN_HOST_PIN_COUNT] =
+{
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80
+};
+
+// *******************************************
+// AcksenButtonHAL implementation
+// *******************************************
+
+unsigned long AcksenButtonHAL::getMillis()
+{
+	return ulHostMillis.load();
+}
+
+unsigned long AcksenButtonHAL::getMicros()
+{
+	return ulHostMicros.load();
+}
+
+bool AcksenButtonHAL::readPin(uint8_t uiPin)
+{
+	// Out of range pins read LOW, as digitalRead() does for NOT_A_PIN
+	if (uiPin >= ACKSEN_HOST_PIN_COUNT)
+	{
+		return false;
+	}
+
+	return (aHostPortInput[aHostPinToPort[uiPin]] & aHostPinToBitMask[uiPin]) != 0;
+}
+
+void AcksenButtonHAL::setPinMode(uint8_t uiPin, uint8_t uiMode)
+{
+	if (uiPin < ACKSEN_HOST_PIN_COUNT)
+	{
+		aHostPinMode[uiPin] = uiMode;
+
+		if (pHostOutputHook != NULL)
+		{
+			pHostOutputHook(uiPin);
+		}
+	}
+}
+
+void AcksenButtonHAL::writePin(uint8_t uiPin, bool bLevel)
+{
+	if (uiPin < ACKSEN_HOST_PIN_COUNT)
+	{
+		aHostPinOutput[uiPin] = bLevel;
+
+		if (pHostOutputHook != NULL)
+		{
+			pHostOutputHook(uiPin);
+		}
+	}
+}
+
+void AcksenButtonHAL::delayMicros(uint16_t uiMicros)
+{
+	// Time passes, as in a busy wait
+	AcksenButtonHost::advanceMicros(uiMicros);
+
+	if (pHostDelayHook != NULL)
+	{
+		pHostDelayHook(uiMicros);
+	}
+}
+
+const volatile AcksenButtonPort_t* AcksenButtonHAL::getInputRegister(uint8_t uiPin)
+{
+	if (uiPin >= ACKSEN_HOST_PIN_COUNT)
+	{
+		return NULL;
+	}
+
+	return &aHostPortInput[aHostPinToPort[uiPin]];
+}
+
+AcksenButtonPort_t AcksenButtonHAL::getPinBitMask(uint8_t uiPin)
+{
+	return (uiPin < ACKSEN_HOST_PIN_COUNT) ? aHostPinToBitMask[uiPin] : 0;
+}
+
+void AcksenButtonHAL::startAnalogRead(uint8_t uiPin)
+{
+	uiHostAnalogResult = (uiPin < ACKSEN_HOST_PIN_COUNT) ? aHostAnalogInput[uiPin] : 0;
+	uiHostAnalogPollsLeft = uiHostAnalogPolls;
+}
+
+bool AcksenButtonHAL::isAnalogReadComplete()
+{
+	if (uiHostAnalogPollsLeft > 0)
+	{
+		uiHostAnalogPollsLeft--;
+
+		return false;
+	}
+
+	return true;
+}
+
+uint16_t AcksenButtonHAL::getAnalogResult()
+{
+	return uiHostAnalogResult;
+}
+
+// *******************************************
+// Simulation control
+// *******************************************
+
+void AcksenButtonHost::reset()
+{
+	ulHostMillis.store(0);
+	ulHostMicros.store(0);
+	ulHostMicrosFraction = 0;
+
+	for (uint8_t uiPort = 0; uiPort < ACKSEN_HOST_PORT_COUNT; uiPort++)
+	{
+		aHostPortInput[uiPort] = 0;
+	}
+
+	for (uint8_t uiPin = 0; uiPin < ACKSEN_HOST_PIN_COUNT; uiPin++)
+	{
+		aHostPinMode[uiPin] = INPUT;
+		aHostPinOutput[uiPin] = false;
+		aHostAnalogInput[uiPin] = 0;
+	}
+
+	uiHostAnalogResult = 0;
+	uiHostAnalogPolls = 0;
+	uiHostAnalogPollsLeft = 0;
+	acksenButtonAnalogAdc() = AcksenButtonAnalogAdc();		// Ladders sharing the mock ADC start again from the first turn
+	pHostOutputHook = NULL;
+	pHostDelayHook = NULL;
+}
+
+void AcksenButtonHost::setMillis(unsigned long ulMillis)
+{
+	ulHostMicrosFraction = 0;
+	ulHostMicros.store(ulMillis * 1000);
+	ulHostMillis.store(ulMillis);
+}
+
+void AcksenButtonHost::advanceMillis(unsigned long ulMillis)
+{
+	ulHostMicros.fetch_add(ulMillis * 1000);
+	ulHostMillis.fetch_add(ulMillis);
+}
+
+void AcksenButtonHost::setMicros(unsigned long ulMicros)
+{
+	ulHostMicrosFraction = ulMicros % 1000;
+	ulHostMicros.store(ulMicros);
+	ulHostMillis.store(ulMicros / 1000);
+}
+
+void AcksenButtonHost::advanceMicros(unsigned long ulMicros)
+{
+	ulHostMicrosFraction += ulMicros;
+	ulHostMicros.fetch_add(ulMicros);
+	ulHostMillis.fetch_add(ulHostMicrosFraction / 1000);
+	ulHostMicrosFraction %= 1000;
+}
+
+void AcksenButtonHost::setPin(uint8_t uiPin, bool bLevel)
+{
+	if (uiPin >= ACKSEN_HOST_PIN_COUNT)
+	{
+		return;
+	}
+
+	if (bLevel)
+	{
+		aHostPortInput[aHostPinToPort[uiPin]] |= aHostPinToBitMask[uiPin];
+	}
+	else
+	{
+		aHostPortInput[aHostPinToPort[uiPin]] &= (uint8_t)~aHostPinToBitMask[uiPin];
+	}
+}
+
+uint8_t AcksenButtonHost::readPort(uint8_t uiPort)
+{
+	return (uiPort < ACKSEN_HOST_PORT_COUNT) ? aHostPortInput[uiPort] : 0;
+}
+
+uint8_t AcksenButtonHost::getPinMode(uint8_t uiPin)
+{
+	return (uiPin < ACKSEN_HOST_PIN_COUNT) ? aHostPinMode[uiPin] : INPUT;
+}
+
+bool AcksenButtonHost::getPinOutput(uint8_t uiPin)
+{
+	return (uiPin < ACKSEN_HOST_PIN_COUNT) ? aHostPinOutput[uiPin] : false;
+}
+
+void AcksenButtonHost::setOutputHook(AcksenButtonHostOutputHook pHook)
+{
+	pHostOutputHook = pHook;
+}
+
+void AcksenButtonHost::setDelayHook(AcksenButtonHostDelayHook pHook)
+{
+	pHostDelayHook = pHook;
+}
+
+void AcksenButtonHost::setAnalogInput(uint8_t uiPin, uint16_t uiValue)
+{
+	if (uiPin < ACKSEN_HOST_PIN_COUNT)
+	{
+		aHostAnalogInput[uiPin] = uiValue;
+	}
+}
+
+void AcksenButtonHost::setAnalogConversionPolls(uint8_t uiPolls)
+{
+	uiHostAnalogPolls = uiPolls;
+}
@@ -0,0 +1,181 @@
+/*!
+@file AcksenButtonHost.h
+
+*/
+
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+// Host (Linux) implementation of AcksenButtonHAL.
+//
+// Provides a mock GPIO, laid out as AVR-style 8-bit ports, and a deterministic simulated clock which
+// only moves when the caller advances it. The clock counts milliseconds and microseconds together, as the
+// Arduino core does: setting or advancing either keeps the other consistent with it.
+
+#ifndef AcksenButtonHost_h
+#define AcksenButtonHost_h
+
+#include "AcksenButtonHAL.h"
+
+#define ACKSEN_HOST_PORT_COUNT		8							///< Number of simulated 8-bit I/O ports
+#define ACKSEN_HOST_PIN_COUNT		(ACKSEN_HOST_PORT_COUNT * 8)	///< Number of simulated I/O pins
+
+typedef void (*AcksenButtonHostOutputHook)(uint8_t uiPin);			///< Called after a pin's mode or output level changes
+typedef void (*AcksenButtonHostDelayHook)(uint16_t uiMicros);		///< Called after AcksenButtonHAL::delayMicros() has advanced the clock
+
+/**************************************************************************/
+/*!
+    @brief  Class that controls the simulated clock and mock GPIO used by host builds
+*/
+/**************************************************************************/
+class AcksenButtonHost
+{
+
+public:
+
+/**************************************************************************/
+/*!
+    @brief  Resets the simulated clock to zero, all pins to LOW/INPUT and analog inputs to 0, and removes any output hook.
+			The mock ADC is released, and AcksenButtonAnalog ladders constructed afterwards take turns from the first.
+    @return No return value.
+*/
+/**************************************************************************/
+	static void reset();
+
+/**************************************************************************/
+/*!
+    @brief  Sets the simulated clock, to a whole number of milliseconds.
+    @param  ulMillis
+            The new value returned by AcksenButtonHAL::getMillis(). getMicros() returns 1000 times this.
+    @return No return value.
+*/
+/**************************************************************************/
+	static void setMillis(unsigned long ulMillis);
+
+/**************************************************************************/
+/*!
+    @brief  Advances the simulated clock.
+    @param  ulMillis
+            The number of milliseconds to advance the clock by.
+    @return No return value.
+*/
+/**************************************************************************/
+	static void advanceMillis(unsigned long ulMillis);
+
+/**************************************************************************/
+/*!
+    @brief  Sets the simulated clock, to the microsecond.
+    @param  ulMicros
+            The new value returned by AcksenButtonHAL::getMicros(). getMillis() returns this divided by 1000.
+    @return No return value.
+*/
+/**************************************************************************/
+	static void setMicros(unsigned long ulMicros);
+
+/**************************************************************************/
+/*!
+    @brief  Advances the simulated clock by a number of microseconds. getMillis() advances each time a whole
+			millisecond has passed, and wraps independently of getMicros(), as on an Arduino.
+    @param  ulMicros
+            The number of microseconds to advance the clock by.
+    @return No return value.
+*/
+/**************************************************************************/
+	static void advanceMicros(unsigned long ulMicros);
+
+/**************************************************************************/
+/*!
+    @brief  Drives the level seen on a mock input pin.
+    @param  uiPin
+            The pin to set.
+    @param  bLevel
+            true for HIGH, false for LOW.
+    @return No return value.
+*/
+/**************************************************************************/
+	static void setPin(uint8_t uiPin, bool bLevel);
+
+/**************************************************************************/
+/*!
+    @brief  Returns the levels of all 8 pins on a mock port (pin 8*uiPort is bit 0), as a port register read would.
+    @param  uiPort
+            The port to read (0 to ACKSEN_HOST_PORT_COUNT-1).
+*/
+/**************************************************************************/
+	static uint8_t readPort(uint8_t uiPort);
+
+/**************************************************************************/
+/*!
+    @brief  Returns the mode last applied to a pin with AcksenButtonHAL::setPinMode().
+*/
+/**************************************************************************/
+	static uint8_t getPinMode(uint8_t uiPin);
+
+/**************************************************************************/
+/*!
+    @brief  Returns the level last written to a pin with AcksenButtonHAL::writePin().
+*/
+/**************************************************************************/
+	static bool getPinOutput(uint8_t uiPin);
+
+/**************************************************************************/
+/*!
+    @brief  Installs a function called whenever a pin's mode or output level changes, so that a test can model
+			external circuitry (e.g. a keypad matrix) by updating input pins in response.
+    @param  pHook
+            The function to call, or NULL to remove it.
+    @return No return value.
+*/
+/**************************************************************************/
+	static void setOutputHook(AcksenButtonHostOutputHook pHook);
+
+/**************************************************************************/
+/*!
+    @brief  Installs a function called after each AcksenButtonHAL::delayMicros(), which advances the simulated clock,
+			so that a test can model circuitry that takes time to settle.
+    @param  pHook
+            The function to call, or NULL to remove it.
+    @return No return value.
+*/
+/**************************************************************************/
+	static void setDelayHook(AcksenButtonHostDelayHook pHook);
+
+/**************************************************************************/
+/*!
+    @brief  Sets the value an ADC conversion of a mock analog pin returns.
+    @param  uiPin
+            The pin to set.
+    @param  uiValue
+            The conversion result, 0 to 1023.
+    @return No return value.
+*/
+/**************************************************************************/
+	static void setAnalogInput(uint8_t uiPin, uint16_t uiValue);
+
+/**************************************************************************/
+/*!
+    @brief  Sets how long a mock ADC conversion takes, as the number of AcksenButtonHAL::isAnalogReadComplete()
+			calls that return false before it completes (0 by default).
+    @param  uiPolls
+            The number of polls.
+    @return No return value.
+*/
+/**************************************************************************/
+	static void setAnalogConversionPolls(uint8_t uiPolls);
+
+};
+
+#endif
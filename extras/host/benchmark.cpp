@@ -0,0 +1,3474 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+/*
+Tool:			benchmark
+Library:		AcksenButton
+
+Description:
+Host benchmark suite for the AcksenButton library, built against the mock GPIO and simulated clock
+in AcksenButtonHost.cpp.
+
+Each benchmark scans a bank of buttons once per simulated millisecond while a fixed schedule presses
+and releases the inputs, so that every mode spends time debouncing, holding, repeating and idling.
+Timings are wall-clock per call, so compare results from the same machine only.
+
+Usage:			./benchmark [suite...]
+				With no arguments, all suites are run.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "AcksenButton.h"
+#include "AcksenButtonAnalog.h"
+#include "AcksenButtonBank.h"
+#include "AcksenButtonCompact.h"
+#include "AcksenButtonCurve.h"
+#include "AcksenButtonEncoder.h"
+#include "AcksenButtonGesture.h"
+#include "AcksenButtonGroup.h"
+#include "AcksenButtonMatrix.h"
+#include "AcksenButtonShiftIn.h"
+#include "AcksenButtonStatic.h"
+#include "AcksenButtonTimerWheel.h"
+#include "AcksenButtonHost.h"
+
+// ***********************************
+// Constants
+// ***********************************
+#define BENCH_TARGET_CALLS				(1UL << 23)		// Refresh calls per measurement (approximate)
+#define BENCH_MIN_SCANS					8000			// Simulated milliseconds per measurement (minimum)
+#define BENCH_PRESS_PERIOD				3500			// Milliseconds between presses on the same pin
+#define BENCH_PRESS_LENGTH				3000			// Milliseconds each press is held for
+#define BENCH_BOUNCE_LENGTH				4				// Milliseconds of contact bounce after each press/release
+#define BENCH_DEBOUNCE_INTERVAL			20				// Milliseconds
+
+
+// ***********************************
+// Helpers
+// ***********************************
+
+// Prevents the compiler from discarding results that are otherwise unused
+static volatile unsigned long ulBenchSink;
+
+typedef std::chrono::steady_clock BenchClock;
+
+static double elapsedNs(BenchClock::time_point tStart, BenchClock::time_point tEnd)
+{
+	return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(tEnd - tStart).count();
+}
+
+static const char* modeName(uint8_t uiMode)
+{
+	switch (uiMode)
+	{
+		case ACKSEN_BUTTON_MODE_NORMAL:		return "NORMAL";
+		case ACKSEN_BUTTON_MODE_LONGPRESS:	return "LONGPRESS";
+		case ACKSEN_BUTTON_MODE_REPEAT:		return "REPEAT";
+		case ACKSEN_BUTTON_MODE_ACCELERATE:	return "ACCELERATE";
+		default:							return "?";
+	}
+}
+
+static void printResult(const char* szSuite, const char* szCase, unsigned long ulButtons, unsigned long long ullCalls, double dNs)
+{
+	double dNsPerCall = dNs / (double)ullCalls;
+
+	printf("%-12s %-22s %6lu  %10.2f ns/call  %14.0f calls/s\n", szSuite, szCase, ulButtons, dNsPerCall, 1.0e9 / dNsPerCall);
+}
+
+// Input schedule - each pin is pressed for BENCH_PRESS_LENGTH every BENCH_PRESS_PERIOD, starting at a
+// pin-specific phase, with BENCH_BOUNCE_LENGTH milliseconds of chatter at each transition.
+// The schedule for one period is precomputed and sorted, so applying it costs one compare per scan.
+struct BenchPinEvent
+{
+	unsigned long ulOffset;
+	uint8_t uiPin;
+	bool bLevel;
+};
+
+class BenchSchedule
+{
+
+public:
+
+	BenchSchedule(uint8_t uiPins, unsigned long ulStart = 0)
+	{
+		std::vector<BenchPinEvent> aAll;
+
+		for (uint8_t uiPin = 0; uiPin < uiPins; uiPin++)
+		{
+			unsigned long ulPhase = ((unsigned long)uiPin * 53) % BENCH_PRESS_PERIOD;
+
+			for (unsigned long ulBounce = 0; ulBounce <= BENCH_BOUNCE_LENGTH; ulBounce++)
+			{
+				bool bLevel = (ulBounce % 2) == 0;
+
+				aAll.push_back({ (ulPhase + ulBounce) % BENCH_PRESS_PERIOD, uiPin, bLevel });
+				aAll.push_back({ (ulPhase + BENCH_PRESS_LENGTH + ulBounce) % BENCH_PRESS_PERIOD, uiPin, !bLevel });
+			}
+		}
+
+		// Insertion sort keeps events for the same pin in the order generated
+		for (size_t i = 1; i < aAll.size(); i++)
+		{
+			BenchPinEvent sEvent = aAll[i];
+			size_t j = i;
+
+			while ((j > 0) && (aAll[j - 1].ulOffset > sEvent.ulOffset))
+			{
+				aAll[j] = aAll[j - 1];
+				j--;
+			}
+
+			aAll[j] = sEvent;
+		}
+
+		aEvents = aAll;
+		uiNext = 0;
+		ulPeriodStart = ulStart;
+	}
+
+	// Applies all pin changes due up to and including the given simulated time, optionally listing the pins changed
+	void apply(unsigned long ulNow, std::vector<uint8_t>* paChanged = NULL)
+	{
+		while (!acksenButtonTimeBefore(ulNow, nextChange()))
+		{
+			AcksenButtonHost::setPin(aEvents[uiNext].uiPin, aEvents[uiNext].bLevel);
+
+			if (paChanged != NULL)
+			{
+				paChanged->push_back(aEvents[uiNext].uiPin);
+			}
+
+			if (++uiNext == aEvents.size())
+			{
+				uiNext = 0;
+				ulPeriodStart += BENCH_PRESS_PERIOD;
+			}
+		}
+	}
+
+	// Returns the time of the next pin change not yet applied
+	unsigned long nextChange()
+	{
+		return ulPeriodStart + aEvents[uiNext].ulOffset;
+	}
+
+private:
+
+	std::vector<BenchPinEvent> aEvents;
+	size_t uiNext;
+	unsigned long ulPeriodStart;
+
+};
+
+// Measures the cost of advancing the clock and applying the input schedule for a number of scans, so
+// that it can be removed from per-call figures (it otherwise dominates when only one button is scanned)
+static double scheduleOverheadNs(unsigned long ulScans)
+{
+	AcksenButtonHost::reset();
+
+	BenchSchedule cSchedule(ACKSEN_HOST_PIN_COUNT);
+	BenchClock::time_point tStart = BenchClock::now();
+
+	for (unsigned long ulScan = 0; ulScan < ulScans; ulScan++)
+	{
+		AcksenButtonHost::advanceMillis(1);
+		cSchedule.apply(AcksenButtonHAL::getMillis());
+	}
+
+	BenchClock::time_point tEnd = BenchClock::now();
+
+	return elapsedNs(tStart, tEnd);
+}
+
+// Small deterministic random number generator (xorshift32), so every run replays the same traces
+class BenchRandom
+{
+
+public:
+
+	BenchRandom(uint32_t uiSeed) : uiState(uiSeed ? uiSeed : 1) {}
+
+	// Returns a value from ulMin to ulMax inclusive
+	unsigned long range(unsigned long ulMin, unsigned long ulMax)
+	{
+		uiState ^= uiState << 13;
+		uiState ^= uiState >> 17;
+		uiState ^= uiState << 5;
+
+		return ulMin + (uiState % (ulMax - ulMin + 1));
+	}
+
+private:
+
+	uint32_t uiState;
+
+};
+
+// Returns the CPU timestamp counter where there is one, for cycle counts; otherwise 0
+static inline unsigned long long benchCycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+static unsigned long scanCount(unsigned long ulButtons)
+{
+	unsigned long ulScans = BENCH_TARGET_CALLS / ulButtons;
+
+	return (ulScans < BENCH_MIN_SCANS) ? BENCH_MIN_SCANS : ulScans;
+}
+
+
+// ***********************************
+// Suites
+// ***********************************
+
+// refreshStatus() cost for every mode, with 1, 64 and 4096 button instances
+static void benchRefresh()
+{
+	static const unsigned long aButtonCounts[] = { 1, 64, 4096 };
+
+	for (uint8_t uiMode = ACKSEN_BUTTON_MODE_NORMAL; uiMode <= ACKSEN_BUTTON_MODE_ACCELERATE; uiMode++)
+	{
+		for (size_t c = 0; c < sizeof(aButtonCounts) / sizeof(aButtonCounts[0]); c++)
+		{
+			unsigned long ulButtons = aButtonCounts[c];
+			unsigned long ulScans = scanCount(ulButtons);
+			unsigned long ulEvents = 0;
+
+			AcksenButtonHost::reset();
+
+			BenchSchedule cSchedule(ACKSEN_HOST_PIN_COUNT);
+			std::vector<AcksenButton> aButtons;
+
+			aButtons.reserve(ulButtons);
+
+			for (unsigned long i = 0; i < ulButtons; i++)
+			{
+				aButtons.push_back(AcksenButton((uint8_t)(i % ACKSEN_HOST_PIN_COUNT), uiMode, BENCH_DEBOUNCE_INTERVAL, INPUT));
+			}
+
+			BenchClock::time_point tStart = BenchClock::now();
+
+			for (unsigned long ulScan = 0; ulScan < ulScans; ulScan++)
+			{
+				AcksenButtonHost::advanceMillis(1);
+				cSchedule.apply(AcksenButtonHAL::getMillis());
+
+				for (unsigned long i = 0; i < ulButtons; i++)
+				{
+					ulEvents += aButtons[i].refreshStatus();
+				}
+			}
+
+			BenchClock::time_point tEnd = BenchClock::now();
+
+			ulBenchSink += ulEvents;
+
+			double dNs = elapsedNs(tStart, tEnd) - scheduleOverheadNs(ulScans);
+
+			printResult("refresh", modeName(uiMode), ulButtons, (unsigned long long)ulScans * ulButtons, dNs);
+		}
+	}
+}
+
+
+// Input backends: the same 64 buttons read with digitalRead() (the host readPin() mirrors the AVR core - range
+// check, then port and bit mask table lookups) and through the input register resolved at construction.
+// Reports time and CPU timestamp cycles per refreshStatus() call, and checks both report the same events.
+#define BACKEND_BUTTONS				64
+
+static void benchBackend()
+{
+	for (uint8_t uiMode = ACKSEN_BUTTON_MODE_NORMAL; uiMode <= ACKSEN_BUTTON_MODE_ACCELERATE; uiMode++)
+	{
+		unsigned long aulEvents[2] = { 0, 0 };
+
+		for (uint8_t uiBackend = ACKSEN_BUTTON_INPUT_DIGITALREAD; uiBackend <= ACKSEN_BUTTON_INPUT_PORT; uiBackend++)
+		{
+			unsigned long ulScans = scanCount(BACKEND_BUTTONS);
+			unsigned long long ullCycles = 0;
+			double dNs = 0;
+
+			AcksenButtonHost::reset();
+
+			BenchSchedule cSchedule(ACKSEN_HOST_PIN_COUNT);
+			std::vector<AcksenButton> aButtons;
+
+			aButtons.reserve(BACKEND_BUTTONS);
+
+			for (unsigned long i = 0; i < BACKEND_BUTTONS; i++)
+			{
+				aButtons.push_back(AcksenButton((uint8_t)(i % ACKSEN_HOST_PIN_COUNT), uiMode, BENCH_DEBOUNCE_INTERVAL, INPUT));
+				aButtons[i].setInputBackend(uiBackend);
+			}
+
+			for (unsigned long ulScan = 0; ulScan < ulScans; ulScan++)
+			{
+				AcksenButtonHost::advanceMillis(1);
+				cSchedule.apply(AcksenButtonHAL::getMillis());
+
+				unsigned long ulNow = AcksenButtonHAL::getMillis();
+				BenchClock::time_point tStart = BenchClock::now();
+				unsigned long long ullStart = benchCycles();
+
+				for (unsigned long i = 0; i < BACKEND_BUTTONS; i++)
+				{
+					aulEvents[uiBackend] += aButtons[i].refreshStatus(ulNow);
+				}
+
+				ullCycles += benchCycles() - ullStart;
+				dNs += elapsedNs(tStart, BenchClock::now());
+			}
+
+			double dCalls = (double)ulScans * BACKEND_BUTTONS;
+			char szCase[32];
+
+			snprintf(szCase, sizeof(szCase), "%s %s", modeName(uiMode), (uiBackend == ACKSEN_BUTTON_INPUT_PORT) ? "port" : "digitalRead");
+
+			printf("%-12s %-22s %6u  %10.2f ns/call  %10.1f cycles/call  %lu events\n", "backend", szCase, (unsigned)BACKEND_BUTTONS,
+				dNs / dCalls, ullCycles / dCalls, aulEvents[uiBackend]);
+		}
+
+		if (aulEvents[0] != aulEvents[1])
+		{
+			printf("%-12s %-22s event counts differ between backends\n", "backend", modeName(uiMode));
+		}
+	}
+}
+
+// Keypad matrix scanning, against a model of a matrix without diodes: while a row is driven LOW, every column
+// connected to it through pressed keys (directly, or via other rows) reads LOW. Every key is pressed in turn
+// and must be reported once, by its own AcksenButton only. Then three corners of a rectangle are pressed, and
+// the scanner must flag ghosting without reporting the fourth. Scan cost includes the model, which runs on every
+// row drive. A column released by a row stays LOW for MATRIX_RISE_US, as the pull-up recharges it, so the scanner
+// must wait for the columns to settle after driving each row.
+#define MATRIX_COLUMN_PIN			0				// Columns on port 0
+#define MATRIX_ROW_PIN				8				// Rows from port 1 upwards
+#define MATRIX_MAX_ROWS				32
+#define MATRIX_MAX_COLUMNS			8
+#define MATRIX_HOLD_MS				60
+#define MATRIX_GAP_MS				40
+#define MATRIX_RISE_US				3				// Time a released column takes to read HIGH again
+
+static bool abMatrixKeyDown[MATRIX_MAX_ROWS][MATRIX_MAX_COLUMNS];
+static uint8_t auiMatrixReach[MATRIX_MAX_ROWS];		// Columns pulled LOW while each row is driven
+static uint8_t uiMatrixRows;
+static uint8_t uiMatrixColumns;
+static uint8_t uiMatrixLow;							// Columns pulled LOW by the driven rows
+static uint8_t uiMatrixRising;						// Columns released, still reading LOW until MATRIX_RISE_US has passed
+static unsigned long ulMatrixRelease_US;
+
+// Recomputes the columns reached from each row through pressed keys, after a key changes
+static void matrixModelUpdate()
+{
+	for (uint8_t uiRow = 0; uiRow < uiMatrixRows; uiRow++)
+	{
+		uint8_t uiColumns = 0;
+		uint32_t uiRows = 1UL << uiRow;
+		bool bGrown = true;
+
+		while (bGrown)
+		{
+			bGrown = false;
+
+			for (uint8_t r = 0; r < uiMatrixRows; r++)
+			{
+				for (uint8_t c = 0; (c < uiMatrixColumns) && (uiRows & (1UL << r)); c++)
+				{
+					if (abMatrixKeyDown[r][c] && !(uiColumns & (1 << c)))
+					{
+						uiColumns |= (1 << c);
+						bGrown = true;
+					}
+				}
+
+				for (uint8_t c = 0; c < uiMatrixColumns; c++)
+				{
+					if ((uiColumns & (1 << c)) && abMatrixKeyDown[r][c] && !(uiRows & (1UL << r)))
+					{
+						uiRows |= (1UL << r);
+						bGrown = true;
+					}
+				}
+			}
+		}
+
+		auiMatrixReach[uiRow] = uiColumns;
+	}
+}
+
+// Output hook - sets the column levels for whichever rows are driven, and for columns still rising
+static void matrixModelHook(uint8_t)
+{
+	uint8_t uiLow = 0;
+
+	for (uint8_t uiRow = 0; uiRow < uiMatrixRows; uiRow++)
+	{
+		if ((AcksenButtonHost::getPinMode(MATRIX_ROW_PIN + uiRow) == OUTPUT) && !AcksenButtonHost::getPinOutput(MATRIX_ROW_PIN + uiRow))
+		{
+			uiLow |= auiMatrixReach[uiRow];
+		}
+	}
+
+	if (uiMatrixLow & ~uiLow)
+	{
+		uiMatrixRising |= uiMatrixLow & ~uiLow;
+		ulMatrixRelease_US = AcksenButtonHAL::getMicros();
+	}
+
+	if (AcksenButtonHAL::getMicros() - ulMatrixRelease_US >= MATRIX_RISE_US)
+	{
+		uiMatrixRising = 0;
+	}
+
+	uiMatrixLow = uiLow;
+
+	for (uint8_t uiColumn = 0; uiColumn < uiMatrixColumns; uiColumn++)
+	{
+		AcksenButtonHost::setPin(MATRIX_COLUMN_PIN + uiColumn, ((uiLow | uiMatrixRising) & (1 << uiColumn)) == 0);
+	}
+}
+
+// Delay hook - columns finish rising as time passes
+static void matrixModelDelay(uint16_t)
+{
+	matrixModelHook(0);
+}
+
+// Clears the model, and attaches it to the mock pins
+static void matrixModelStart(uint8_t uiRows, uint8_t uiColumns)
+{
+	memset(abMatrixKeyDown, 0, sizeof(abMatrixKeyDown));
+	uiMatrixRows = uiRows;
+	uiMatrixColumns = uiColumns;
+	uiMatrixLow = 0;
+	uiMatrixRising = 0;
+	ulMatrixRelease_US = 0;
+	matrixModelUpdate();
+	AcksenButtonHost::setOutputHook(matrixModelHook);
+	AcksenButtonHost::setDelayHook(matrixModelDelay);
+}
+
+static void matrixSetKey(uint8_t uiRow, uint8_t uiColumn, bool bDown)
+{
+	abMatrixKeyDown[uiRow][uiColumn] = bDown;
+	matrixModelUpdate();
+	matrixModelHook(0);
+}
+
+template <uint8_t ROWS, uint8_t COLUMNS>
+static void benchMatrixSize()
+{
+	static_assert((ROWS <= MATRIX_MAX_ROWS) && (COLUMNS <= MATRIX_MAX_COLUMNS), "Matrix larger than the model");
+
+	const unsigned long ulKeys = (unsigned long)ROWS * COLUMNS;
+	uint8_t auiRowPins[ROWS];
+	uint8_t auiColumnPins[COLUMNS];
+
+	AcksenButtonHost::reset();
+	matrixModelStart(ROWS, COLUMNS);
+
+	for (uint8_t uiRow = 0; uiRow < ROWS; uiRow++)
+	{
+		auiRowPins[uiRow] = MATRIX_ROW_PIN + uiRow;
+	}
+
+	for (uint8_t uiColumn = 0; uiColumn < COLUMNS; uiColumn++)
+	{
+		auiColumnPins[uiColumn] = MATRIX_COLUMN_PIN + uiColumn;
+	}
+
+	static AcksenButtonMatrix<ROWS, COLUMNS> cMatrix(auiRowPins, auiColumnPins);
+	std::vector<AcksenButton> aKeys;
+
+	matrixModelHook(0);
+	aKeys.reserve(ulKeys);
+
+	for (unsigned long k = 0; k < ulKeys; k++)
+	{
+		aKeys.push_back(AcksenButton(cMatrix.getKeyInput(k / COLUMNS, k % COLUMNS), ACKSEN_BUTTON_MODE_NORMAL, BENCH_DEBOUNCE_INTERVAL));
+	}
+
+	unsigned long ulNow = 1000;
+	unsigned long ulScans = 0;
+	unsigned long ulMismatches = 0;
+	double dScanNs = 0;
+	double dRefreshNs = 0;
+
+	// Scans and refreshes for a number of milliseconds, returning a bitmap of the keys reported pressed
+	auto run = [&](unsigned long ulDuration_MS, std::vector<bool>& abPressed)
+	{
+		for (unsigned long ulStep = 0; ulStep < ulDuration_MS; ulStep++, ulNow++)
+		{
+			BenchClock::time_point tStart = BenchClock::now();
+			cMatrix.scan();
+			BenchClock::time_point tScanned = BenchClock::now();
+
+			for (unsigned long k = 0; k < ulKeys; k++)
+			{
+				aKeys[k].refreshStatus(ulNow);
+			}
+
+			dRefreshNs += elapsedNs(tScanned, BenchClock::now());
+			dScanNs += elapsedNs(tStart, tScanned);
+			ulScans++;
+
+			for (unsigned long k = 0; k < ulKeys; k++)
+			{
+				if (aKeys[k].onPressed())
+				{
+					abPressed[k] = true;
+				}
+			}
+		}
+	};
+
+	for (uint8_t uiPass = 0; uiPass < 4; uiPass++)
+	{
+		for (unsigned long k = 0; k < ulKeys; k++)
+		{
+			std::vector<bool> abPressed(ulKeys, false);
+
+			matrixSetKey(k / COLUMNS, k % COLUMNS, true);
+			run(MATRIX_HOLD_MS, abPressed);
+			matrixSetKey(k / COLUMNS, k % COLUMNS, false);
+			run(MATRIX_GAP_MS, abPressed);
+
+			for (unsigned long j = 0; j < ulKeys; j++)
+			{
+				ulMismatches += (abPressed[j] != (j == k));
+			}
+		}
+	}
+
+	// Two keys on row 0, then a third on row 1 below one of them - key (1,1) becomes a ghost
+	std::vector<bool> abGhostPressed(ulKeys, false);
+
+	matrixSetKey(0, 0, true);
+	matrixSetKey(0, 1, true);
+	run(MATRIX_HOLD_MS, abGhostPressed);
+	matrixSetKey(1, 0, true);
+	run(MATRIX_HOLD_MS, abGhostPressed);
+
+	bool bGhostFlagged = cMatrix.isGhosting();
+
+	matrixSetKey(0, 0, false);
+	matrixSetKey(0, 1, false);
+	matrixSetKey(1, 0, false);
+	run(MATRIX_GAP_MS, abGhostPressed);
+
+	AcksenButtonHost::setOutputHook(NULL);
+	AcksenButtonHost::setDelayHook(NULL);
+
+	char szCase[32];
+
+	snprintf(szCase, sizeof(szCase), "%ux%u", (unsigned)ROWS, (unsigned)COLUMNS);
+
+	printf("%-12s %-22s %6lu  %10.1f ns/scan  %7.2f ns/key refresh  %lu mismatches, ghosting %s, phantom key %s\n", "matrix", szCase, ulKeys,
+		dScanNs / ulScans, dRefreshNs / ((double)ulScans * ulKeys), ulMismatches, bGhostFlagged ? "flagged" : "MISSED",
+		abGhostPressed[1 * COLUMNS + 1] ? "REPORTED" : "suppressed");
+}
+
+// Settle time: every key of a 4x4 matrix is pressed in turn, with the default settle time and with none. Without
+// it, a row reads the columns still rising from the row before, and keys below a pressed key are reported too.
+static void benchMatrixSettle()
+{
+	static const uint8_t auiRowPins[4] = { MATRIX_ROW_PIN, MATRIX_ROW_PIN + 1, MATRIX_ROW_PIN + 2, MATRIX_ROW_PIN + 3 };
+	static const uint8_t auiColumnPins[4] = { MATRIX_COLUMN_PIN, MATRIX_COLUMN_PIN + 1, MATRIX_COLUMN_PIN + 2, MATRIX_COLUMN_PIN + 3 };
+
+	for (uint16_t uiSettle_US = ACKSEN_BUTTON_MATRIX_SETTLE_US; ; uiSettle_US = 0)
+	{
+		AcksenButtonHost::reset();
+		matrixModelStart(4, 4);
+
+		AcksenButtonMatrix<4, 4> cMatrix(auiRowPins, auiColumnPins);
+		std::vector<AcksenButton> aKeys;
+		unsigned long ulNow = 1000;
+		unsigned long ulWrongKeys = 0;
+
+		cMatrix.setSettleTime(uiSettle_US);
+		aKeys.reserve(16);
+
+		for (uint8_t k = 0; k < 16; k++)
+		{
+			aKeys.push_back(AcksenButton(cMatrix.getKeyInput(k / 4, k % 4), ACKSEN_BUTTON_MODE_NORMAL, BENCH_DEBOUNCE_INTERVAL));
+		}
+
+		for (uint8_t k = 0; k < 16; k++)
+		{
+			std::vector<bool> abPressed(16, false);
+
+			for (unsigned long ulStep = 0; ulStep < MATRIX_HOLD_MS + MATRIX_GAP_MS; ulStep++, ulNow++)
+			{
+				matrixSetKey(k / 4, k % 4, ulStep < MATRIX_HOLD_MS);
+				cMatrix.scan();
+
+				for (uint8_t j = 0; j < 16; j++)
+				{
+					aKeys[j].refreshStatus(ulNow);
+					abPressed[j] = abPressed[j] || aKeys[j].onPressed();
+				}
+			}
+
+			for (uint8_t j = 0; j < 16; j++)
+			{
+				ulWrongKeys += (abPressed[j] != (j == k));
+			}
+		}
+
+		AcksenButtonHost::setOutputHook(NULL);
+		AcksenButtonHost::setDelayHook(NULL);
+
+		if (uiSettle_US != 0)
+		{
+			printf("%-12s %-22s %6u  %lu mismatches\n", "matrix", "settle default", 16, ulWrongKeys);
+		}
+		else
+		{
+			printf("%-12s %-22s %6u  %lu keys wrongly reported without settling\n", "matrix", "settle 0", 16, ulWrongKeys);
+			break;
+		}
+	}
+}
+
+static void benchMatrix()
+{
+	benchMatrixSize<4, 4>();
+	benchMatrixSize<4, 8>();
+	benchMatrixSize<8, 8>();
+	benchMatrixSize<16, 8>();
+	benchMatrixSize<32, 8>();
+	benchMatrixSettle();
+}
+
+// Shift register input expansion, against a model of a chain of eight 74HC165s (64 inputs). Each input of the
+// chain follows one of the first 56 mock pins, which the usual press schedule drives, and every AcksenButton on
+// the chain is compared with a reference AcksenButton reading its pin directly - in every mode, both through a
+// transfer function standing in for SPI and bit-banged. An AcksenButtonBank64 fed from the chain is compared
+// with one fed from the pins. Scan cost is one latch pulse and one transfer, including the model.
+#define SHIFTIN_BYTES				8
+#define SHIFTIN_SOURCE_PINS			56				// Chain inputs follow these pins, in turn
+#define SHIFTIN_LATCH_PIN			60
+#define SHIFTIN_DATA_PIN			61
+#define SHIFTIN_CLOCK_PIN			62
+
+static uint8_t auiShiftInChain[SHIFTIN_BYTES];		// Register contents, in the order they are shifted out
+static uint16_t uiShiftInPosition;					// Bits shifted out since the last load
+static bool bShiftInClock;
+static unsigned long ulShiftInLoads;
+static unsigned long ulShiftInTransfers;
+
+// Presents the bit at the head of the chain on the data pin, as QH of the nearest register does
+static void shiftInModelPresent()
+{
+	bool bLevel = false;
+
+	if (uiShiftInPosition < SHIFTIN_BYTES * 8)
+	{
+		bLevel = (auiShiftInChain[uiShiftInPosition / 8] & (0x80 >> (uiShiftInPosition % 8))) != 0;
+	}
+
+	AcksenButtonHost::setPin(SHIFTIN_DATA_PIN, bLevel);
+}
+
+// Loads the chain while the latch is LOW, and shifts it on each rising clock edge
+static void shiftInModelHook(uint8_t uiPin)
+{
+	if ((uiPin == SHIFTIN_LATCH_PIN) && !AcksenButtonHost::getPinOutput(SHIFTIN_LATCH_PIN))
+	{
+		for (uint16_t uiInput = 0; uiInput < SHIFTIN_BYTES * 8; uiInput++)
+		{
+			uint8_t uiBit = (uint8_t)(1 << (uiInput % 8));
+
+			if (AcksenButtonHAL::readPin(uiInput % SHIFTIN_SOURCE_PINS))
+			{
+				auiShiftInChain[uiInput / 8] |= uiBit;
+			}
+			else
+			{
+				auiShiftInChain[uiInput / 8] &= (uint8_t)~uiBit;
+			}
+		}
+
+		uiShiftInPosition = 0;
+		ulShiftInLoads++;
+		shiftInModelPresent();
+	}
+	else if (uiPin == SHIFTIN_CLOCK_PIN)
+	{
+		bool bClock = AcksenButtonHost::getPinOutput(SHIFTIN_CLOCK_PIN);
+
+		if (bClock && !bShiftInClock)
+		{
+			uiShiftInPosition++;
+			shiftInModelPresent();
+		}
+
+		bShiftInClock = bClock;
+	}
+}
+
+// Stands in for SPI.transfer() - one call per scan reads the whole chain
+static void shiftInModelTransfer(uint8_t* auiBuffer, uint8_t uiLength)
+{
+	for (uint8_t uiByte = 0; uiByte < uiLength; uiByte++)
+	{
+		auiBuffer[uiByte] = (uiByte < SHIFTIN_BYTES) ? auiShiftInChain[uiByte] : 0;
+	}
+
+	uiShiftInPosition = (uint16_t)uiLength * 8;
+	ulShiftInTransfers++;
+}
+
+static void benchShiftInMode(uint8_t uiMode, bool bBitBang)
+{
+	const unsigned long ulInputs = AcksenButtonShiftIn<SHIFTIN_BYTES>::INPUTS;
+	unsigned long ulScans = scanCount(ulInputs);
+
+	AcksenButtonHost::reset();
+	memset(auiShiftInChain, 0, sizeof(auiShiftInChain));
+	uiShiftInPosition = 0;
+	bShiftInClock = false;
+	ulShiftInLoads = 0;
+	ulShiftInTransfers = 0;
+	AcksenButtonHost::setOutputHook(shiftInModelHook);
+
+	AcksenButtonShiftIn<SHIFTIN_BYTES> cChainSpi(SHIFTIN_LATCH_PIN, shiftInModelTransfer);
+	AcksenButtonShiftIn<SHIFTIN_BYTES> cChainBitBang(SHIFTIN_LATCH_PIN, SHIFTIN_DATA_PIN, SHIFTIN_CLOCK_PIN);
+	AcksenButtonShiftIn<SHIFTIN_BYTES>& cChain = bBitBang ? cChainBitBang : cChainSpi;
+
+	BenchSchedule cSchedule(SHIFTIN_SOURCE_PINS);
+	std::vector<AcksenButton> aButtons;
+	std::vector<AcksenButton> aReference;
+	AcksenButtonBank64 cBank(BENCH_DEBOUNCE_INTERVAL);
+	AcksenButtonBank64 cReferenceBank(BENCH_DEBOUNCE_INTERVAL);
+
+	aButtons.reserve(ulInputs);
+	aReference.reserve(ulInputs);
+
+	for (unsigned long i = 0; i < ulInputs; i++)
+	{
+		aButtons.push_back(AcksenButton(cChain.getInput(i), uiMode, BENCH_DEBOUNCE_INTERVAL));
+		aReference.push_back(AcksenButton((uint8_t)(i % SHIFTIN_SOURCE_PINS), uiMode, BENCH_DEBOUNCE_INTERVAL, INPUT));
+		cBank.setLaneOperatingMode(i, uiMode);
+		cReferenceBank.setLaneOperatingMode(i, uiMode);
+	}
+
+	unsigned long ulLoadsBefore = ulShiftInLoads;
+	unsigned long ulTransfersBefore = ulShiftInTransfers;
+	unsigned long ulMismatches = 0;
+	unsigned long ulEvents = 0;
+	double dScanNs = 0;
+	double dRefreshNs = 0;
+
+	for (unsigned long ulScan = 0; ulScan < ulScans; ulScan++)
+	{
+		AcksenButtonHost::advanceMillis(1);
+
+		unsigned long ulNow = AcksenButtonHAL::getMillis();
+
+		cSchedule.apply(ulNow);
+
+		BenchClock::time_point tStart = BenchClock::now();
+		cChain.read();
+		BenchClock::time_point tRead = BenchClock::now();
+
+		for (unsigned long i = 0; i < ulInputs; i++)
+		{
+			aButtons[i].refreshStatus(ulNow);
+		}
+
+		dRefreshNs += elapsedNs(tRead, BenchClock::now());
+		dScanNs += elapsedNs(tStart, tRead);
+
+		uint64_t uInput = 0;
+		uint64_t uReferenceInput = 0;
+
+		for (unsigned long i = 0; i < ulInputs; i++)
+		{
+			aReference[i].refreshStatus(ulNow);
+
+			bool bPressed = aButtons[i].onPressed();
+			bool bLongPress = aButtons[i].onLongPress();
+			bool bReleased = aButtons[i].onReleased();
+
+			ulMismatches += (bPressed != aReference[i].onPressed());
+			ulMismatches += (bLongPress != aReference[i].onLongPress());
+			ulMismatches += (bReleased != aReference[i].onReleased());
+			ulMismatches += (aButtons[i].getButtonState() != aReference[i].getButtonState());
+			ulEvents += bPressed + bLongPress + bReleased;
+
+			uReferenceInput |= (uint64_t)AcksenButtonHAL::readPin(i % SHIFTIN_SOURCE_PINS) << i;
+		}
+
+		for (uint8_t uiByte = 0; uiByte < SHIFTIN_BYTES; uiByte++)
+		{
+			uInput |= (uint64_t)cChain.getByte(uiByte) << (uiByte * 8);
+		}
+
+		cBank.refreshStatus(uInput);
+		cReferenceBank.refreshStatus(uReferenceInput);
+
+		ulMismatches += (cBank.getPressedMask() != cReferenceBank.getPressedMask());
+		ulMismatches += (cBank.getRepeatMask() != cReferenceBank.getRepeatMask());
+	}
+
+	AcksenButtonHost::setOutputHook(NULL);
+
+	char szCase[32];
+
+	snprintf(szCase, sizeof(szCase), "%s %s", bBitBang ? "bitbang" : "spi", modeName(uiMode));
+
+	printf("%-12s %-22s %6lu  %10.1f ns/scan  %7.2f ns/btn refresh  %.2f loads/scan, %.2f transfers/scan, %lu events, %lu mismatches\n", "shiftin", szCase,
+		ulInputs, dScanNs / ulScans, dRefreshNs / ((double)ulScans * ulInputs), (double)(ulShiftInLoads - ulLoadsBefore) / ulScans,
+		(double)(ulShiftInTransfers - ulTransfersBefore) / ulScans, ulEvents, ulMismatches);
+}
+
+static void benchShiftIn()
+{
+	for (uint8_t uiMode = ACKSEN_BUTTON_MODE_NORMAL; uiMode <= ACKSEN_BUTTON_MODE_ACCELERATE; uiMode++)
+	{
+		benchShiftInMode(uiMode, false);
+	}
+
+	benchShiftInMode(ACKSEN_BUTTON_MODE_NORMAL, true);
+}
+
+// Resistor ladder keypads: two ladders of six keys share the mock ADC, whose conversions take several polls. Each
+// key is pressed in turn on both ladders, with reading noise, contact bounce, and readings from other keys' bands
+// while the voltage moves between levels. Every press must be reported once, by its own key only - with the
+// default filter, and unfiltered for comparison. Cost is per update() call, which never waits for the ADC.
+#define ANALOG_KEYS					6
+#define ANALOG_LADDERS				2
+#define ANALOG_IDLE_LEVEL			1023
+#define ANALOG_NOISE				15			// Peak reading noise, in ADC counts
+#define ANALOG_CONVERSION_POLLS		3			// Polls before a mock conversion completes
+#define ANALOG_UPDATES_PER_MS		8			// Main loop iterations per millisecond
+#define ANALOG_SETTLE_UPDATES		2			// Loop iterations spent between levels on each transition
+#define ANALOG_BOUNCE_MS			3
+#define ANALOG_HOLD_MS				150
+#define ANALOG_GAP_MS				60
+#define ANALOG_PRESSES				600			// Per ladder
+
+// Nominal readings of a typical five-button shield with an extra key, deliberately out of order
+static const uint16_t auiAnalogKeyLevels[ANALOG_KEYS] = { 479, 0, 816, 130, 641, 306 };
+
+static void benchAnalogFilter(uint8_t uiFilterSamples)
+{
+	AcksenButtonHost::reset();
+	AcksenButtonHost::setAnalogConversionPolls(ANALOG_CONVERSION_POLLS);
+
+	std::vector<AcksenButtonAnalog<ANALOG_KEYS> > aLadders;
+	std::vector<AcksenButton> aKeys;
+	BenchRandom cRandom(0xADC0FFEE);
+
+	aLadders.reserve(ANALOG_LADDERS);
+
+	for (uint8_t uiLadder = 0; uiLadder < ANALOG_LADDERS; uiLadder++)
+	{
+		aLadders.push_back(AcksenButtonAnalog<ANALOG_KEYS>(uiLadder, auiAnalogKeyLevels, ANALOG_IDLE_LEVEL));
+		aLadders[uiLadder].setFilterSamples(uiFilterSamples);
+		AcksenButtonHost::setAnalogInput(uiLadder, ANALOG_IDLE_LEVEL);
+	}
+
+	aKeys.reserve(ANALOG_LADDERS * ANALOG_KEYS);
+
+	for (uint8_t k = 0; k < ANALOG_LADDERS * ANALOG_KEYS; k++)
+	{
+		aKeys.push_back(AcksenButton(aLadders[k / ANALOG_KEYS].getInput(k % ANALOG_KEYS), ACKSEN_BUTTON_MODE_NORMAL, BENCH_DEBOUNCE_INTERVAL));
+	}
+
+	unsigned long ulNow = 1000;
+	unsigned long ulUpdates = 0;
+	unsigned long ulSamples = 0;
+	unsigned long ulReported = 0;
+	unsigned long ulFalse = 0;
+	unsigned long ulLatency = 0;
+	double dUpdateNs = 0;
+	uint16_t auiLevel[ANALOG_LADDERS];			// Level each ladder is moving towards
+	uint16_t auiPrevious[ANALOG_LADDERS];		// Level it is moving from
+	uint8_t auiSettle[ANALOG_LADDERS];			// Updates left between the two
+	uint8_t auiHeld[ANALOG_LADDERS];			// Key held on each ladder
+	int aiPressed[ANALOG_LADDERS];				// Key whose press has not been reported yet, or -1
+	unsigned long aulPressTime[ANALOG_LADDERS];
+
+	for (uint8_t uiLadder = 0; uiLadder < ANALOG_LADDERS; uiLadder++)
+	{
+		auiLevel[uiLadder] = ANALOG_IDLE_LEVEL;
+		auiPrevious[uiLadder] = ANALOG_IDLE_LEVEL;
+		auiSettle[uiLadder] = 0;
+		auiHeld[uiLadder] = 0;
+		aiPressed[uiLadder] = -1;
+		aulPressTime[uiLadder] = 0;
+	}
+
+	auto moveTo = [&](uint8_t uiLadder, uint16_t uiLevel)
+	{
+		auiPrevious[uiLadder] = auiLevel[uiLadder];
+		auiLevel[uiLadder] = uiLevel;
+		auiSettle[uiLadder] = ANALOG_SETTLE_UPDATES;
+	};
+
+	// Runs the main loop for a number of milliseconds, with ladder 1 half a cycle behind ladder 0
+	auto run = [&](unsigned long ulDuration_MS)
+	{
+		for (unsigned long ulStep = 0; ulStep < ulDuration_MS; ulStep++, ulNow++)
+		{
+			for (uint8_t uiUpdate = 0; uiUpdate < ANALOG_UPDATES_PER_MS; uiUpdate++)
+			{
+				for (uint8_t uiLadder = 0; uiLadder < ANALOG_LADDERS; uiLadder++)
+				{
+					long lReading = auiLevel[uiLadder];
+
+					if (auiSettle[uiLadder] > 0)
+					{
+						lReading = (long)cRandom.range((auiPrevious[uiLadder] < auiLevel[uiLadder]) ? auiPrevious[uiLadder] : auiLevel[uiLadder],
+							(auiPrevious[uiLadder] < auiLevel[uiLadder]) ? auiLevel[uiLadder] : auiPrevious[uiLadder]);
+						auiSettle[uiLadder]--;
+					}
+
+					lReading += (long)cRandom.range(0, 2 * ANALOG_NOISE) - ANALOG_NOISE;
+					lReading = (lReading < 0) ? 0 : ((lReading > ANALOG_IDLE_LEVEL) ? ANALOG_IDLE_LEVEL : lReading);
+
+					AcksenButtonHost::setAnalogInput(uiLadder, (uint16_t)lReading);
+				}
+
+				BenchClock::time_point tStart = BenchClock::now();
+
+				for (uint8_t uiLadder = 0; uiLadder < ANALOG_LADDERS; uiLadder++)
+				{
+					ulSamples += aLadders[uiLadder].update();
+				}
+
+				dUpdateNs += elapsedNs(tStart, BenchClock::now());
+				ulUpdates += ANALOG_LADDERS;
+			}
+
+			for (uint8_t k = 0; k < ANALOG_LADDERS * ANALOG_KEYS; k++)
+			{
+				aKeys[k].refreshStatus(ulNow);
+
+				if (aKeys[k].onPressed())
+				{
+					uint8_t uiLadder = k / ANALOG_KEYS;
+
+					if (aiPressed[uiLadder] == (int)(k % ANALOG_KEYS))
+					{
+						ulReported++;
+						ulLatency += ulNow - aulPressTime[uiLadder];
+						aiPressed[uiLadder] = -1;
+					}
+					else
+					{
+						ulFalse++;
+					}
+				}
+			}
+		}
+	};
+
+	for (unsigned long ulPress = 0; ulPress < ANALOG_PRESSES; ulPress++)
+	{
+		for (uint8_t uiLadder = 0; uiLadder < ANALOG_LADDERS; uiLadder++)
+		{
+			uint8_t uiKey = (uint8_t)((ulPress + uiLadder * 3) % ANALOG_KEYS);
+
+			auiHeld[uiLadder] = uiKey;
+			aiPressed[uiLadder] = uiKey;
+			aulPressTime[uiLadder] = ulNow;
+
+			for (uint8_t uiBounce = 0; uiBounce < ANALOG_BOUNCE_MS; uiBounce++)
+			{
+				moveTo(uiLadder, ((uiBounce % 2) == 0) ? auiAnalogKeyLevels[uiKey] : ANALOG_IDLE_LEVEL);
+				run(1);
+			}
+
+			moveTo(uiLadder, auiAnalogKeyLevels[uiKey]);
+			run(ANALOG_HOLD_MS / 2);
+		}
+
+		for (uint8_t uiLadder = 0; uiLadder < ANALOG_LADDERS; uiLadder++)
+		{
+			for (uint8_t uiBounce = 0; uiBounce < ANALOG_BOUNCE_MS; uiBounce++)
+			{
+				moveTo(uiLadder, ((uiBounce % 2) == 0) ? ANALOG_IDLE_LEVEL : auiAnalogKeyLevels[auiHeld[uiLadder]]);
+				run(1);
+			}
+
+			moveTo(uiLadder, ANALOG_IDLE_LEVEL);
+			run(ANALOG_GAP_MS / 2);
+		}
+
+		run(ANALOG_HOLD_MS / 2);
+	}
+
+	char szCase[32];
+
+	snprintf(szCase, sizeof(szCase), "filter %u", (unsigned)uiFilterSamples);
+
+	printf("%-12s %-22s %6u  %10.1f ns/update  %5.2f samples/ms/ladder  presses %lu/%u, false %lu, latency %.1f ms\n", "analog", szCase,
+		ANALOG_LADDERS * ANALOG_KEYS, dUpdateNs / ulUpdates, (double)ulSamples * ANALOG_UPDATES_PER_MS / ulUpdates,
+		ulReported, ANALOG_LADDERS * ANALOG_PRESSES, ulFalse, ulReported ? (double)ulLatency / ulReported : 0.0);
+}
+
+// Three ladders share the ADC, updated at uneven rates - the first every main loop iteration, the last only once
+// per millisecond. Each holds a different key. Every ladder must keep taking readings, with no gap longer than
+// ANALOG_SHARED_MAX_GAP_MS and at least half as many as the ladder taking the most, and report its own key.
+#define ANALOG_SHARED_LADDERS		3
+#define ANALOG_SHARED_MS			2000
+#define ANALOG_SHARED_MAX_GAP_MS	10
+
+static const uint8_t auiAnalogSharedPeriods[ANALOG_SHARED_LADDERS] = { 1, 2, ANALOG_UPDATES_PER_MS };	// Iterations between update() calls
+
+static void benchAnalogShared()
+{
+	AcksenButtonHost::reset();
+	AcksenButtonHost::setAnalogConversionPolls(ANALOG_CONVERSION_POLLS);
+
+	std::vector<AcksenButtonAnalog<ANALOG_KEYS> > aLadders;
+	unsigned long aulSamples[ANALOG_SHARED_LADDERS];
+	unsigned long aulLastSample[ANALOG_SHARED_LADDERS];
+	unsigned long aulMaxGap[ANALOG_SHARED_LADDERS];
+	unsigned long ulMismatches = 0;
+
+	aLadders.reserve(ANALOG_SHARED_LADDERS);
+
+	for (uint8_t uiLadder = 0; uiLadder < ANALOG_SHARED_LADDERS; uiLadder++)
+	{
+		aLadders.push_back(AcksenButtonAnalog<ANALOG_KEYS>(uiLadder, auiAnalogKeyLevels, ANALOG_IDLE_LEVEL));
+		AcksenButtonHost::setAnalogInput(uiLadder, auiAnalogKeyLevels[uiLadder]);
+
+		aulSamples[uiLadder] = 0;
+		aulLastSample[uiLadder] = 0;
+		aulMaxGap[uiLadder] = 0;
+	}
+
+	for (unsigned long ulNow = 1; ulNow <= ANALOG_SHARED_MS; ulNow++)
+	{
+		for (uint8_t uiUpdate = 0; uiUpdate < ANALOG_UPDATES_PER_MS; uiUpdate++)
+		{
+			for (uint8_t uiLadder = 0; uiLadder < ANALOG_SHARED_LADDERS; uiLadder++)
+			{
+				if (((uiUpdate % auiAnalogSharedPeriods[uiLadder]) == 0) && aLadders[uiLadder].update())
+				{
+					aulSamples[uiLadder]++;
+					aulMaxGap[uiLadder] = std::max(aulMaxGap[uiLadder], ulNow - aulLastSample[uiLadder]);
+					aulLastSample[uiLadder] = ulNow;
+				}
+			}
+		}
+	}
+
+	unsigned long ulMostSamples = *std::max_element(aulSamples, aulSamples + ANALOG_SHARED_LADDERS);
+
+	for (uint8_t uiLadder = 0; uiLadder < ANALOG_SHARED_LADDERS; uiLadder++)
+	{
+		aulMaxGap[uiLadder] = std::max(aulMaxGap[uiLadder], ANALOG_SHARED_MS - aulLastSample[uiLadder]);
+
+		ulMismatches += (aulMaxGap[uiLadder] > ANALOG_SHARED_MAX_GAP_MS) + (2 * aulSamples[uiLadder] < ulMostSamples);
+		ulMismatches += (aLadders[uiLadder].getKey() != uiLadder);
+	}
+
+	printf("%-12s %-22s %6u  samples/ms %.2f/%.2f/%.2f, longest gap %lu/%lu/%lu ms, %lu mismatches\n", "analog", "shared, uneven calls",
+		ANALOG_SHARED_LADDERS * ANALOG_KEYS, (double)aulSamples[0] / ANALOG_SHARED_MS, (double)aulSamples[1] / ANALOG_SHARED_MS,
+		(double)aulSamples[2] / ANALOG_SHARED_MS, aulMaxGap[0], aulMaxGap[1], aulMaxGap[2], ulMismatches);
+}
+
+static void benchAnalog()
+{
+	benchAnalogFilter(1);
+	benchAnalogFilter(DEFAULT_ANALOG_FILTER_SAMPLES);
+	benchAnalogShared();
+}
+
+// Gesture detection on a deterministic script of clicks, multi-clicks, chords and near-miss chords (second press
+// just outside the chord window), with contact bounce on every edge. Every gesture is compared with the script -
+// type, button or chord, click count and timestamp - and the delay from the gesture completing to it being
+// reported is measured. Single clicks, completed multi-clicks and chords should report with no delay.
+#define GESTURE_BUTTONS				8
+#define GESTURE_EPISODES			4000
+#define GESTURE_BOUNCE_MS			3
+
+static const uint8_t auiGestureMaxClicks[GESTURE_BUTTONS] = { 1, 1, 2, 2, 3, 3, 1, 1 };
+static const uint8_t auiGestureChords[2][2] = { { 6, 7 }, { 1, 3 } };
+
+struct BenchGestureRecord
+{
+	unsigned long ulTimestamp_MS;
+	unsigned long ulReported_MS;
+	uint8_t uiType;
+	uint8_t uiIndex;
+	uint8_t uiCount;
+
+	bool operator==(const BenchGestureRecord& sOther) const
+	{
+		return (ulTimestamp_MS == sOther.ulTimestamp_MS) && (ulReported_MS == sOther.ulReported_MS) && (uiType == sOther.uiType) &&
+			(uiIndex == sOther.uiIndex) && (uiCount == sOther.uiCount);
+	}
+};
+
+static void benchGesture()
+{
+	std::vector<BenchPinEvent> aEdges;
+	std::vector<BenchGestureRecord> aExpected;
+	BenchRandom cRandom(0x6E57);
+	unsigned long ulTime = 1000;
+
+	// An edge, with bounce, becoming stable after GESTURE_BOUNCE_MS
+	auto edge = [&](uint8_t uiPin, unsigned long ulAt, bool bLevel)
+	{
+		for (unsigned long ulBounce = 0; ulBounce < GESTURE_BOUNCE_MS; ulBounce++)
+		{
+			aEdges.push_back({ ulAt + ulBounce, uiPin, ((ulBounce % 2) == 0) ? bLevel : !bLevel });
+		}
+	};
+
+	for (unsigned long ulEpisode = 0; ulEpisode < GESTURE_EPISODES; ulEpisode++)
+	{
+		unsigned long ulType = cRandom.range(0, 9);
+		unsigned long ulEnd = ulTime;
+
+		if (ulType < 6)
+		{
+			// Burst of clicks on one button, up to its configured count
+			uint8_t uiButton = (uint8_t)cRandom.range(0, GESTURE_BUTTONS - 1);
+			uint8_t uiClicks = (uint8_t)cRandom.range(1, auiGestureMaxClicks[uiButton]);
+			unsigned long ulAt = ulTime;
+
+			for (uint8_t uiClick = 0; uiClick < uiClicks; uiClick++)
+			{
+				edge(uiButton, ulAt, true);
+				ulAt += cRandom.range(30, 120);
+				edge(uiButton, ulAt, false);
+				ulEnd = ulAt;
+
+				if (uiClick + 1 < uiClicks)
+				{
+					ulAt += cRandom.range(40, DEFAULT_GESTURE_CLICK_WINDOW - 50);
+				}
+			}
+
+			unsigned long ulReported = ulEnd + ((uiClicks < auiGestureMaxClicks[uiButton]) ? DEFAULT_GESTURE_CLICK_WINDOW : 0);
+
+			aExpected.push_back({ ulEnd, ulReported, ACKSEN_BUTTON_GESTURE_CLICK, uiButton, uiClicks });
+		}
+		else
+		{
+			// Chord, or a near miss whose second press comes too late - then each release is a single click
+			bool bChord = (ulType < 8);
+			uint8_t uiChord = bChord ? (uint8_t)cRandom.range(0, 1) : 0;
+			uint8_t uiFirst = (uint8_t)cRandom.range(0, 1);
+			uint8_t uiA = auiGestureChords[uiChord][uiFirst];
+			uint8_t uiB = auiGestureChords[uiChord][1 - uiFirst];
+			unsigned long ulPressB = ulTime + (bChord ? cRandom.range(0, DEFAULT_GESTURE_CHORD_WINDOW - 10) : cRandom.range(DEFAULT_GESTURE_CHORD_WINDOW + 20, 150));
+			unsigned long ulReleaseA = ulPressB + cRandom.range(30, 200);
+			unsigned long ulReleaseB = ulReleaseA + cRandom.range(30, 100);
+
+			edge(uiA, ulTime, true);
+			edge(uiB, ulPressB, true);
+			edge(uiA, ulReleaseA, false);
+			edge(uiB, ulReleaseB, false);
+			ulEnd = ulReleaseB;
+
+			if (bChord)
+			{
+				aExpected.push_back({ ulPressB, ulPressB, ACKSEN_BUTTON_GESTURE_CHORD, uiChord, 2 });
+			}
+			else
+			{
+				aExpected.push_back({ ulReleaseA, ulReleaseA, ACKSEN_BUTTON_GESTURE_CLICK, uiA, 1 });
+				aExpected.push_back({ ulReleaseB, ulReleaseB, ACKSEN_BUTTON_GESTURE_CLICK, uiB, 1 });
+			}
+		}
+
+		ulTime = ulEnd + DEFAULT_GESTURE_CLICK_WINDOW + cRandom.range(50, 150);
+	}
+
+	std::stable_sort(aEdges.begin(), aEdges.end(), [](const BenchPinEvent& a, const BenchPinEvent& b) { return a.ulOffset < b.ulOffset; });
+
+	AcksenButtonHost::reset();
+
+	std::vector<AcksenButton> aButtons;
+	AcksenButtonGestures<GESTURE_BUTTONS> cGestures;
+
+	aButtons.reserve(GESTURE_BUTTONS);
+
+	for (uint8_t uiButton = 0; uiButton < GESTURE_BUTTONS; uiButton++)
+	{
+		aButtons.push_back(AcksenButton(uiButton, ACKSEN_BUTTON_MODE_NORMAL, BENCH_DEBOUNCE_INTERVAL, INPUT));
+		cGestures.add(&aButtons[uiButton]);
+		cGestures.setMultiClick(uiButton, auiGestureMaxClicks[uiButton]);
+	}
+
+	cGestures.addChord(auiGestureChords[0][0], auiGestureChords[0][1]);
+	cGestures.addChord(auiGestureChords[1][0], auiGestureChords[1][1]);
+
+	std::vector<BenchGestureRecord> aReported;
+	size_t uiEdge = 0;
+	double dUpdateNs = 0;
+	unsigned long ulUpdates = 0;
+
+	for (unsigned long ulNow = 0; ulNow <= ulTime; ulNow++)
+	{
+		while ((uiEdge < aEdges.size()) && (aEdges[uiEdge].ulOffset == ulNow))
+		{
+			AcksenButtonHost::setPin(aEdges[uiEdge].uiPin, aEdges[uiEdge].bLevel);
+			uiEdge++;
+		}
+
+		BenchClock::time_point tStart = BenchClock::now();
+		cGestures.update(ulNow);
+		dUpdateNs += elapsedNs(tStart, BenchClock::now());
+		ulUpdates++;
+
+		AcksenButtonGesture sGesture;
+
+		while (cGestures.pollGesture(sGesture))
+		{
+			aReported.push_back({ sGesture.ulTimestamp_MS, ulNow, sGesture.uiType, sGesture.uiIndex, sGesture.uiCount });
+		}
+	}
+
+	unsigned long ulMismatches = (aReported.size() > aExpected.size()) ? aReported.size() - aExpected.size() : aExpected.size() - aReported.size();
+	unsigned long aulLatency[4] = { 0, 0, 0, 0 };		// Single clicks, completed multi-clicks, timed out multi-clicks, chords
+	unsigned long aulCount[4] = { 0, 0, 0, 0 };
+
+	for (size_t i = 0; i < aReported.size(); i++)
+	{
+		const BenchGestureRecord& sGesture = aReported[i];
+		uint8_t uiKind = 3;
+
+		ulMismatches += (i < aExpected.size()) && !(sGesture == aExpected[i]);
+
+		if (sGesture.uiType == ACKSEN_BUTTON_GESTURE_CLICK)
+		{
+			uint8_t uiMax = auiGestureMaxClicks[sGesture.uiIndex];
+
+			uiKind = (uiMax == 1) ? 0 : ((sGesture.uiCount == uiMax) ? 1 : 2);
+		}
+
+		aulLatency[uiKind] += sGesture.ulReported_MS - sGesture.ulTimestamp_MS;
+		aulCount[uiKind]++;
+	}
+
+	double adLatency[4];
+
+	for (uint8_t uiKind = 0; uiKind < 4; uiKind++)
+	{
+		adLatency[uiKind] = aulCount[uiKind] ? (double)aulLatency[uiKind] / aulCount[uiKind] : 0.0;
+	}
+
+	printf("%-12s %-22s %6u  %10.1f ns/update  %lu/%lu gestures reported, %lu mismatches, %u overflows\n", "gesture", "script",
+		GESTURE_BUTTONS, dUpdateNs / ulUpdates, (unsigned long)aReported.size(), (unsigned long)aExpected.size(), ulMismatches,
+		cGestures.getGestureOverflowCount());
+	printf("%-12s %-22s %6u  reporting delay: single click %.1f ms, multi-click %.1f ms complete / %.1f ms timed out, chord %.1f ms\n", "gesture", "latency",
+		GESTURE_BUTTONS, adLatency[0], adLatency[1], adLatency[2], adLatency[3]);
+	
+	// Gestures are timed in milliseconds, so a button in the microsecond time base is refused
+	AcksenButtonGestures<2> cTimeBaseGestures;
+	AcksenButton cMicrosButton(0, ACKSEN_BUTTON_MODE_NORMAL, BENCH_DEBOUNCE_INTERVAL, INPUT);
+	
+	cMicrosButton.setTimeBase(ACKSEN_BUTTON_TIME_MICROS);
+	
+	bool bMicrosAdded = cTimeBaseGestures.add(&cMicrosButton);
+	
+	printf("%-12s %-22s microsecond button %s, %lu mismatches\n", "gesture", "time base", bMicrosAdded ? "added" : "refused",
+		(unsigned long)(bMicrosAdded || (cTimeBaseGestures.getCount() != 0)));
+}
+
+// Acceleration curves: 64 buttons in Accelerate mode are held until the first has repeated ACCEL_REPEATS times,
+// with the two-stage timing and with generated and hand-written curves. Every interval between repeats is checked
+// against the curve, and the time taken to reach the count (e.g. to enter a setpoint) and the cost of a refresh
+// while held are reported.
+#define ACCEL_BUTTONS				64
+#define ACCEL_REPEATS				1000
+#define ACCEL_PIN					0
+
+typedef AcksenButtonExponentialCurve<400, 20, 32> BenchExponentialCurve;
+typedef AcksenButtonLinearCurve<400, 50, 16> BenchLinearCurve;
+
+static const uint16_t auiBenchSteppedCurve[] PROGMEM = { 500, 500, 250, 250, 250, 100, 100, 100, 100, 50 };
+
+// The curves are evaluated by the compiler - these fail the build if the generated tables are wrong
+static_assert(acksenButtonCurveDecay(400, BenchExponentialCurve::RATIO, 31, 20) == 20, "Exponential curve must reach END_MS at its last step");
+static_assert(acksenButtonCurveDecay(400, BenchExponentialCurve::RATIO, 30, 20) > 20, "Exponential curve must not reach END_MS early");
+static_assert(acksenButtonCurveLinear(400, 50, 16, 15) == 50, "Linear curve must reach END_MS at its last step");
+
+static void benchAccelCurve(const char* szCase, const uint16_t* pauiCurve, uint8_t uiLength)
+{
+	AcksenButtonHost::reset();
+
+	std::vector<AcksenButton> aButtons;
+
+	aButtons.reserve(ACCEL_BUTTONS);
+
+	for (uint8_t i = 0; i < ACCEL_BUTTONS; i++)
+	{
+		aButtons.push_back(AcksenButton(ACCEL_PIN, ACKSEN_BUTTON_MODE_ACCELERATE, BENCH_DEBOUNCE_INTERVAL, INPUT));
+		aButtons[i].setAccelerationCurve(pauiCurve, uiLength);
+	}
+
+	unsigned long ulNow = 1000;
+	unsigned long ulPress = ulNow;
+	unsigned long ulLastRepeat = 0;
+	unsigned long ulRepeats = 0;
+	unsigned long ulMismatches = 0;
+	unsigned long ulScans = 0;
+	double dRefreshNs = 0;
+
+	AcksenButtonHost::setPin(ACCEL_PIN, true);
+
+	while (ulRepeats < ACCEL_REPEATS)
+	{
+		BenchClock::time_point tStart = BenchClock::now();
+
+		for (uint8_t i = 0; i < ACCEL_BUTTONS; i++)
+		{
+			aButtons[i].refreshStatus(ulNow);
+		}
+
+		dRefreshNs += elapsedNs(tStart, BenchClock::now());
+		ulScans++;
+
+		bool bPressed = aButtons[0].onPressed();
+
+		for (uint8_t i = 1; i < ACCEL_BUTTONS; i++)
+		{
+			ulMismatches += (aButtons[i].onPressed() != bPressed);
+		}
+
+		if (bPressed && (ulNow != ulPress))
+		{
+			unsigned long ulExpected;
+
+			if (ulRepeats == 0)
+			{
+				ulExpected = DEFAULT_REPEAT_INITIAL_OFFSET_INTERVAL;
+			}
+			else if (pauiCurve != NULL)
+			{
+				ulExpected = pauiCurve[(ulRepeats - 1 < uiLength) ? ulRepeats - 1 : uiLength - 1];
+			}
+			else
+			{
+				ulExpected = (ulLastRepeat - ulPress >= DEFAULT_ACCELERATION_INITIAL_OFFSET_INTERVAL) ? DEFAULT_ACCELERATION_PRESSES_INTERVAL : DEFAULT_REPEAT_PRESS_INTERVAL;
+			}
+
+			ulMismatches += (ulNow - ((ulRepeats == 0) ? ulPress : ulLastRepeat) != ulExpected);
+			ulMismatches += (aButtons[0].getRepeatCount() != ulRepeats + 1);
+			ulLastRepeat = ulNow;
+			ulRepeats++;
+		}
+
+		ulNow++;
+	}
+
+	printf("%-12s %-22s %6u  %10.2f ns/call  %8.1f s to %u repeats, %lu mismatches\n", "accel", szCase, ACCEL_BUTTONS,
+		dRefreshNs / ((double)ulScans * ACCEL_BUTTONS), (ulLastRepeat - ulPress) / 1000.0, ACCEL_REPEATS, ulMismatches);
+}
+
+static void benchAccel()
+{
+	benchAccelCurve("two-stage", NULL, 0);
+	benchAccelCurve("exponential 400-20/32", BenchExponentialCurve::auiTable, BenchExponentialCurve::LENGTH);
+	benchAccelCurve("linear 400-50/16", BenchLinearCurve::auiTable, BenchLinearCurve::LENGTH);
+	benchAccelCurve("stepped (hand-written)", auiBenchSteppedCurve, sizeof(auiBenchSteppedCurve) / sizeof(auiBenchSteppedCurve[0]));
+}
+
+// Instrumentation. ./benchmark (ACKSEN_BUTTON_INSTRUMENTATION 0) and ./benchmark_instrumented (1) both report the size of
+// AcksenButton and the cost of refreshing 64 buttons in Repeat mode on the usual schedule, reading every press, so
+// the overhead can be compared (make bench-instrumentation runs both). With instrumentation on, a scripted run also
+// checks every statistic: a fast loop with bouncy presses, every fifth left unread, then a slow loop with clean
+// presses landing at different points in the loop period. The script's button uses edge capture, so that each edge
+// carries the time it happened, and the slow loop's latency is the wait for the next refresh.
+#define INSTRUMENT_BUTTONS			64
+#define INSTRUMENT_PRESSES			200			// Per phase
+#define INSTRUMENT_PRESS_PERIOD		300
+#define INSTRUMENT_SLOW_LOOP_MS		7
+
+static void benchInstrument()
+{
+	unsigned long ulScans = scanCount(INSTRUMENT_BUTTONS);
+
+	AcksenButtonHost::reset();
+
+	BenchSchedule cSchedule(ACKSEN_HOST_PIN_COUNT);
+	std::vector<AcksenButton> aButtons;
+
+	aButtons.reserve(INSTRUMENT_BUTTONS);
+
+	for (uint8_t i = 0; i < INSTRUMENT_BUTTONS; i++)
+	{
+		aButtons.push_back(AcksenButton(i, ACKSEN_BUTTON_MODE_REPEAT, BENCH_DEBOUNCE_INTERVAL, INPUT));
+	}
+
+	unsigned long ulPressed = 0;
+	BenchClock::time_point tStart = BenchClock::now();
+
+	for (unsigned long ulScan = 0; ulScan < ulScans; ulScan++)
+	{
+		AcksenButtonHost::advanceMillis(1);
+
+		unsigned long ulNow = AcksenButtonHAL::getMillis();
+
+		cSchedule.apply(ulNow);
+
+		for (uint8_t i = 0; i < INSTRUMENT_BUTTONS; i++)
+		{
+			aButtons[i].refreshStatus(ulNow);
+			ulPressed += aButtons[i].onPressed();
+		}
+	}
+
+	BenchClock::time_point tEnd = BenchClock::now();
+
+	ulBenchSink += ulPressed;
+
+	double dNs = elapsedNs(tStart, tEnd) - scheduleOverheadNs(ulScans);
+
+	printf("%-12s %-22s %6u  %10.2f ns/call  sizeof(AcksenButton) = %u bytes\n", "instrument",
+		ACKSEN_BUTTON_INSTRUMENTATION ? "enabled" : "disabled", INSTRUMENT_BUTTONS, dNs / ((double)ulScans * INSTRUMENT_BUTTONS),
+		(unsigned)sizeof(AcksenButton));
+
+#if ACKSEN_BUTTON_INSTRUMENTATION
+
+	AcksenButtonHost::reset();
+
+	AcksenButton cButton(0, ACKSEN_BUTTON_MODE_NORMAL, BENCH_DEBOUNCE_INTERVAL, INPUT);
+	AcksenButtonEdgeRing cRing;
+	unsigned long ulExpectedLatencyTotal = 0;
+	unsigned long ulExpectedLatencyMax = 0;
+	uint16_t auiExpectedHistogram[ACKSEN_BUTTON_LATENCY_BUCKETS] = { 0 };
+	unsigned long ulNow = 0;
+
+	cButton.setEdgeCapture(&cRing);
+
+	// Runs the loop up to (not including) a time, refreshing every ulPeriod_MS and reading presses unless told not to
+	auto runUntil = [&](unsigned long ulUntil, unsigned long ulPeriod_MS, bool bRead)
+	{
+		for (; ulNow < ulUntil; ulNow++)
+		{
+			if ((ulNow % ulPeriod_MS) == 0)
+			{
+				AcksenButtonHost::setMillis(ulNow);
+				cButton.refreshStatus(ulNow);
+
+				if (bRead)
+				{
+					cButton.onPressed();
+				}
+			}
+		}
+	};
+
+	// Sets the pin, as the edge interrupt would see it
+	auto setEdge = [&](bool bLevel)
+	{
+		AcksenButtonHost::setMillis(ulNow);
+		AcksenButtonHost::setPin(0, bLevel);
+		cButton.captureEdge();
+	};
+
+	// Phase 1 - fast loop, each edge bouncing twice
+	for (unsigned long p = 0; p < INSTRUMENT_PRESSES; p++)
+	{
+		unsigned long ulPress = 1000 + p * INSTRUMENT_PRESS_PERIOD;
+		bool bRead = (p % 5) != 4;
+
+		for (unsigned long ulEdge = 0; ulEdge < 3; ulEdge++)
+		{
+			runUntil(ulPress + ulEdge, 1, bRead);
+			setEdge((ulEdge % 2) == 0);
+		}
+
+		for (unsigned long ulEdge = 0; ulEdge < 3; ulEdge++)
+		{
+			runUntil(ulPress + 100 + ulEdge, 1, bRead);
+			setEdge((ulEdge % 2) != 0);
+		}
+
+		// Each read press is seen in the same refresh as its first edge
+		auiExpectedHistogram[0] += bRead;
+	}
+
+	// Phase 2 - slow loop, clean edges, so each press waits for the next refresh
+	unsigned long ulPhase2 = 1000 + INSTRUMENT_PRESSES * INSTRUMENT_PRESS_PERIOD;
+
+	for (unsigned long p = 0; p < INSTRUMENT_PRESSES; p++)
+	{
+		unsigned long ulPress = ulPhase2 + p * INSTRUMENT_PRESS_PERIOD + (p % 11);
+		unsigned long ulSeen = ((ulPress + INSTRUMENT_SLOW_LOOP_MS - 1) / INSTRUMENT_SLOW_LOOP_MS) * INSTRUMENT_SLOW_LOOP_MS;
+		unsigned long ulLatency = ulSeen - ulPress;
+		uint8_t uiBucket = 0;
+
+		while ((uiBucket < ACKSEN_BUTTON_LATENCY_BUCKETS - 1) && (ulLatency >= (1UL << uiBucket)))
+		{
+			uiBucket++;
+		}
+
+		runUntil(ulPress, INSTRUMENT_SLOW_LOOP_MS, true);
+		setEdge(true);
+		runUntil(ulPress + 150, INSTRUMENT_SLOW_LOOP_MS, true);
+		setEdge(false);
+
+		ulExpectedLatencyTotal += ulLatency;
+		ulExpectedLatencyMax = (ulLatency > ulExpectedLatencyMax) ? ulLatency : ulExpectedLatencyMax;
+		auiExpectedHistogram[uiBucket]++;
+	}
+
+	runUntil(ulNow + 200, INSTRUMENT_SLOW_LOOP_MS, true);
+
+	const AcksenButtonStats& sStats = cButton.getStats();
+	unsigned long ulMismatches = 0;
+
+	ulMismatches += (sStats.uiRawEdges != INSTRUMENT_PRESSES * 6 + INSTRUMENT_PRESSES * 2);
+	ulMismatches += (sStats.uiAcceptedEdges != INSTRUMENT_PRESSES * 4);
+	ulMismatches += (sStats.uiDroppedEvents != INSTRUMENT_PRESSES / 5);
+	ulMismatches += (sStats.ulMaxRefreshGap_MS != INSTRUMENT_SLOW_LOOP_MS);
+	ulMismatches += (sStats.uiLatencyCount != INSTRUMENT_PRESSES * 2 - INSTRUMENT_PRESSES / 5);
+	ulMismatches += (sStats.uiLatencyMin_MS != 0);
+	ulMismatches += (sStats.uiLatencyMax_MS != ulExpectedLatencyMax);
+	ulMismatches += (sStats.ulLatencyTotal_MS != ulExpectedLatencyTotal);
+
+	for (uint8_t uiBucket = 0; uiBucket < ACKSEN_BUTTON_LATENCY_BUCKETS; uiBucket++)
+	{
+		ulMismatches += (sStats.auiLatencyHistogram[uiBucket] != auiExpectedHistogram[uiBucket]);
+	}
+
+	printf("%-12s %-22s %6u  raw edges %u, accepted %u, dropped %u, max refresh gap %lu ms, latency %u/%.2f/%u ms min/mean/max, %lu mismatches\n",
+		"instrument", "script", 1, sStats.uiRawEdges, sStats.uiAcceptedEdges, sStats.uiDroppedEvents, sStats.ulMaxRefreshGap_MS,
+		sStats.uiLatencyMin_MS, sStats.uiLatencyCount ? (double)sStats.ulLatencyTotal_MS / sStats.uiLatencyCount : 0.0, sStats.uiLatencyMax_MS,
+		ulMismatches);
+
+#endif
+}
+
+// AcksenButtonBank64 against 64 individual AcksenButton instances on the same inputs.
+// Cost is reported per button (lane), including the port reads needed to assemble the input word.
+// Every lane's events are checked against an AcksenButton on the same pin, using the Integrator strategy with the
+// bank's sample count, over BANK_CHECK_PERIODS press periods of the schedule. The bank's vertical counters sample at
+// their own phase, and restart on a disagreeing sample where the Integrator counts down, so each lane must report the
+// same events in the same order, each within one debounce interval. The schedule runs on for BANK_CHECK_TAIL_MS, so
+// that the bank's counterpart of every event the AcksenButton reports within the periods has been seen.
+// Accelerate mode starts accelerating within each press, rather than at the default of 3 seconds.
+#define BANK_CHECK_PERIODS			4
+#define BANK_CHECK_TAIL_MS			1000
+#define BANK_CHECK_ACCELERATION_MS	2000
+
+struct BenchEventRecord
+{
+	unsigned long ulButton;
+	unsigned long ulTimestamp_MS;
+	uint8_t uiType;
+};
+
+static uint64_t readBankInput()
+{
+	uint64_t uInput = 0;
+
+	for (uint8_t uiPort = 0; uiPort < ACKSEN_HOST_PORT_COUNT; uiPort++)
+	{
+		uInput |= (uint64_t)AcksenButtonHost::readPort(uiPort) << (uiPort * 8);
+	}
+
+	return uInput;
+}
+
+static unsigned long checkBankMode(uint8_t uiMode, unsigned long& ulEvents)
+{
+	const uint8_t uiLanes = AcksenButtonBank64::LANES;
+	unsigned long ulMismatches = 0;
+
+	AcksenButtonHost::reset();
+
+	BenchSchedule cSchedule(ACKSEN_HOST_PIN_COUNT);
+	AcksenButtonBank64 cBank(BENCH_DEBOUNCE_INTERVAL);
+	std::vector<AcksenButton> aButtons;
+	std::vector<AcksenButtonEventQueue> aQueues(uiLanes);
+	std::vector<std::vector<BenchEventRecord> > aaBank(uiLanes);
+	std::vector<std::vector<BenchEventRecord> > aaButton(uiLanes);
+
+	cBank.setAccelerationInitialOffsetDelay(BANK_CHECK_ACCELERATION_MS);
+
+	for (uint8_t uiLane = 0; uiLane < uiLanes; uiLane++)
+	{
+		cBank.setLaneOperatingMode(uiLane, uiMode);
+
+		aButtons.push_back(AcksenButton(uiLane, uiMode, BENCH_DEBOUNCE_INTERVAL, INPUT));
+		aButtons[uiLane].setDebounceSamples(ACKSEN_BUTTON_BANK_SAMPLES);
+		aButtons[uiLane].setDebounceStrategy(ACKSEN_BUTTON_DEBOUNCE_INTEGRATOR);
+		aButtons[uiLane].setAccelerationInitialOffsetDelay(BANK_CHECK_ACCELERATION_MS);
+	}
+
+	for (uint8_t uiLane = 0; uiLane < uiLanes; uiLane++)
+	{
+		aButtons[uiLane].setEventQueue(&aQueues[uiLane]);
+	}
+
+	for (unsigned long ulScan = 0; ulScan < BANK_CHECK_PERIODS * BENCH_PRESS_PERIOD + BANK_CHECK_TAIL_MS; ulScan++)
+	{
+		AcksenButtonHost::advanceMillis(1);
+
+		unsigned long ulNow = AcksenButtonHAL::getMillis();
+
+		cSchedule.apply(ulNow);
+
+		cBank.refreshStatus(readBankInput(), ulNow);
+
+		for (uint8_t uiLane = 0; uiLane < uiLanes; uiLane++)
+		{
+			uint64_t uBit = (uint64_t)1 << uiLane;
+			AcksenButtonEvent sEvent;
+
+			if (cBank.getPressedMask() & uBit)
+			{
+				aaBank[uiLane].push_back({ uiLane, ulNow, ACKSEN_BUTTON_EVENT_PRESSED });
+			}
+
+			if (cBank.getReleasedMask() & uBit)
+			{
+				aaBank[uiLane].push_back({ uiLane, ulNow, ACKSEN_BUTTON_EVENT_RELEASED });
+			}
+
+			if (cBank.getRepeatMask() & uBit)
+			{
+				aaBank[uiLane].push_back({ uiLane, ulNow, ACKSEN_BUTTON_EVENT_REPEAT });
+			}
+
+			if (cBank.onLongPress(uiLane))
+			{
+				aaBank[uiLane].push_back({ uiLane, ulNow, ACKSEN_BUTTON_EVENT_LONGPRESS });
+			}
+
+			aButtons[uiLane].refreshStatus(ulNow);
+
+			while (aQueues[uiLane].pop(sEvent))
+			{
+				aaButton[uiLane].push_back({ uiLane, sEvent.ulTimestamp_MS, sEvent.uiType });
+			}
+		}
+	}
+
+	ulEvents = 0;
+
+	for (uint8_t uiLane = 0; uiLane < uiLanes; uiLane++)
+	{
+		const std::vector<BenchEventRecord>& aBank = aaBank[uiLane];
+		const std::vector<BenchEventRecord>& aButton = aaButton[uiLane];
+		size_t uiChecked = 0;
+
+		while ((uiChecked < aButton.size()) && (aButton[uiChecked].ulTimestamp_MS <= BANK_CHECK_PERIODS * BENCH_PRESS_PERIOD))
+		{
+			uiChecked++;
+		}
+
+		size_t uiCommon = (aBank.size() < uiChecked) ? aBank.size() : uiChecked;
+
+		ulEvents += uiChecked;
+		ulMismatches += uiChecked - uiCommon;
+
+		for (size_t i = 0; i < uiCommon; i++)
+		{
+			long lSkew = (long)(aBank[i].ulTimestamp_MS - aButton[i].ulTimestamp_MS);
+
+			ulMismatches += (aBank[i].uiType != aButton[i].uiType) || (lSkew > BENCH_DEBOUNCE_INTERVAL) || (lSkew < -BENCH_DEBOUNCE_INTERVAL);
+		}
+	}
+
+	return ulMismatches;
+}
+
+// Lanes read before any state change are timed from construction, and lanes from LANES upwards are ignored by
+// every per-lane method. Lane 0 is held in Long Press mode throughout, so a stray out-of-range mode change, or an
+// out-of-range read taking lane 0's events, is counted as a mismatch.
+#define BANK_LANES_START_MS			5000
+#define BANK_LANES_AGE_MS			250
+
+static unsigned long checkBankLanes()
+{
+	unsigned long ulMismatches = 0;
+	const uint8_t uiOutside = AcksenButtonBank64::LANES;
+
+	AcksenButtonHost::reset();
+	AcksenButtonHost::advanceMillis(BANK_LANES_START_MS);
+
+	AcksenButtonBank64 cBank(BENCH_DEBOUNCE_INTERVAL);
+
+	AcksenButtonHost::advanceMillis(BANK_LANES_AGE_MS);
+
+	for (uint8_t uiLane = 0; uiLane < AcksenButtonBank64::LANES; uiLane++)
+	{
+		ulMismatches += (cBank.getTimeFromLastStateChange(uiLane) != BANK_LANES_AGE_MS);
+	}
+
+	cBank.setLaneOperatingMode(0, ACKSEN_BUTTON_MODE_LONGPRESS);
+	cBank.setLaneOperatingMode(uiOutside, ACKSEN_BUTTON_MODE_NORMAL);
+	cBank.setLaneOperatingMode(0xFF, ACKSEN_BUTTON_MODE_REPEAT);
+
+	bool bPressed = false;
+	bool bLongPressed = false;
+
+	for (unsigned long ulScan = 0; ulScan < DEFAULT_LONG_PRESS_INTERVAL + 2 * BENCH_DEBOUNCE_INTERVAL; ulScan++)
+	{
+		AcksenButtonHost::advanceMillis(1);
+		cBank.refreshStatus(1);
+
+		ulMismatches += cBank.getButtonState(uiOutside) + cBank.onPressed(uiOutside) + cBank.onLongPress(uiOutside);
+		ulMismatches += (cBank.getTimeFromLastStateChange(uiOutside) != 0);
+
+		bPressed = cBank.onPressed(0) || bPressed;
+		bLongPressed = cBank.onLongPress(0) || bLongPressed;
+	}
+
+	ulMismatches += !bPressed + !bLongPressed;
+
+	bool bReleased = false;
+
+	for (unsigned long ulScan = 0; ulScan < 2 * BENCH_DEBOUNCE_INTERVAL; ulScan++)
+	{
+		AcksenButtonHost::advanceMillis(1);
+		cBank.refreshStatus(0);
+
+		ulMismatches += cBank.onReleased(uiOutside);
+
+		bReleased = cBank.onReleased(0) || bReleased;
+	}
+
+	ulMismatches += !bReleased;
+
+	return ulMismatches;
+}
+
+static void benchBank()
+{
+	for (uint8_t uiMode = ACKSEN_BUTTON_MODE_NORMAL; uiMode <= ACKSEN_BUTTON_MODE_ACCELERATE; uiMode++)
+	{
+		unsigned long ulScans = scanCount(AcksenButtonBank64::LANES);
+		unsigned long ulPressed = 0;
+
+		AcksenButtonHost::reset();
+
+		BenchSchedule cSchedule(ACKSEN_HOST_PIN_COUNT);
+		AcksenButtonBank64 cBank(BENCH_DEBOUNCE_INTERVAL);
+
+		for (uint8_t uiLane = 0; uiLane < AcksenButtonBank64::LANES; uiLane++)
+		{
+			cBank.setLaneOperatingMode(uiLane, uiMode);
+		}
+
+		BenchClock::time_point tStart = BenchClock::now();
+
+		for (unsigned long ulScan = 0; ulScan < ulScans; ulScan++)
+		{
+			AcksenButtonHost::advanceMillis(1);
+			cSchedule.apply(AcksenButtonHAL::getMillis());
+
+			if (cBank.refreshStatus(readBankInput()) != 0)
+			{
+				ulPressed += __builtin_popcountll(cBank.getPressedMask() | cBank.getRepeatMask());
+			}
+		}
+
+		BenchClock::time_point tEnd = BenchClock::now();
+
+		ulBenchSink += ulPressed;
+
+		double dNs = elapsedNs(tStart, tEnd) - scheduleOverheadNs(ulScans);
+
+		printResult("bank", modeName(uiMode), AcksenButtonBank64::LANES, (unsigned long long)ulScans * AcksenButtonBank64::LANES, dNs);
+
+		unsigned long ulEvents;
+		unsigned long ulMismatches = checkBankMode(uiMode, ulEvents);
+
+		printf("%-12s %-22s %6u  %lu events compared against AcksenButton, %lu mismatches\n", "bank", modeName(uiMode),
+			(unsigned)AcksenButtonBank64::LANES, ulEvents, ulMismatches);
+	}
+
+	printf("%-12s %-22s %6u  lanes timed from construction, lanes beyond the bank ignored, %lu mismatches\n", "bank", "lanes",
+		(unsigned)AcksenButtonBank64::LANES, checkBankLanes());
+}
+
+
+// AcksenButtonStatic against the runtime AcksenButton, 64 instances of each in the same mode on one pin.
+// Both are driven together, and every reported event is compared, so any behavioural difference is counted.
+#define STATIC_BUTTONS				64
+#define STATIC_PIN					0
+
+template <uint8_t MODE>
+static void benchStaticMode()
+{
+	typedef AcksenButtonStatic<STATIC_PIN, MODE, BENCH_DEBOUNCE_INTERVAL> StaticButton;
+
+	unsigned long ulScans = scanCount(STATIC_BUTTONS);
+	unsigned long ulMismatches = 0;
+	double dRuntimeNs = 0;
+	double dStaticNs = 0;
+
+	AcksenButtonHost::reset();
+
+	BenchSchedule cSchedule(STATIC_PIN + 1);
+	std::vector<AcksenButton> aRuntime;
+	std::vector<StaticButton> aStatic;
+
+	for (unsigned long i = 0; i < STATIC_BUTTONS; i++)
+	{
+		aRuntime.push_back(AcksenButton(STATIC_PIN, MODE, BENCH_DEBOUNCE_INTERVAL, INPUT));
+		aStatic.push_back(StaticButton(INPUT));
+	}
+
+	for (unsigned long ulScan = 0; ulScan < ulScans; ulScan++)
+	{
+		AcksenButtonHost::advanceMillis(1);
+		cSchedule.apply(AcksenButtonHAL::getMillis());
+
+		unsigned long ulRuntimeEvents = 0;
+		unsigned long ulStaticEvents = 0;
+
+		BenchClock::time_point tStart = BenchClock::now();
+
+		for (unsigned long i = 0; i < STATIC_BUTTONS; i++)
+		{
+			ulRuntimeEvents += aRuntime[i].refreshStatus();
+		}
+
+		BenchClock::time_point tMid = BenchClock::now();
+
+		for (unsigned long i = 0; i < STATIC_BUTTONS; i++)
+		{
+			ulStaticEvents += aStatic[i].refreshStatus();
+		}
+
+		BenchClock::time_point tEnd = BenchClock::now();
+
+		dRuntimeNs += elapsedNs(tStart, tMid);
+		dStaticNs += elapsedNs(tMid, tEnd);
+
+		ulMismatches += (ulRuntimeEvents != ulStaticEvents);
+		ulMismatches += (aRuntime[0].onPressed() != aStatic[0].onPressed());
+		ulMismatches += (aRuntime[0].onReleased() != aStatic[0].onReleased());
+		ulMismatches += (aRuntime[0].onLongPress() != aStatic[0].onLongPress());
+		ulMismatches += (aRuntime[0].getButtonState() != aStatic[0].getButtonState());
+	}
+
+	unsigned long long ullCalls = (unsigned long long)ulScans * STATIC_BUTTONS;
+	char szCase[32];
+
+	snprintf(szCase, sizeof(szCase), "%s runtime", modeName(MODE));
+	printResult("static", szCase, STATIC_BUTTONS, ullCalls, dRuntimeNs);
+
+	snprintf(szCase, sizeof(szCase), "%s static", modeName(MODE));
+	printResult("static", szCase, STATIC_BUTTONS, ullCalls, dStaticNs);
+
+	printf("%-12s %-22s sizeof %u bytes (runtime %u bytes), %lu mismatches\n", "static", modeName(MODE),
+		(unsigned)sizeof(StaticButton), (unsigned)sizeof(AcksenButton), ulMismatches);
+}
+
+static void benchStatic()
+{
+	benchStaticMode<ACKSEN_BUTTON_MODE_NORMAL>();
+	benchStaticMode<ACKSEN_BUTTON_MODE_LONGPRESS>();
+	benchStaticMode<ACKSEN_BUTTON_MODE_REPEAT>();
+	benchStaticMode<ACKSEN_BUTTON_MODE_ACCELERATE>();
+}
+
+// AcksenButtonCompact against AcksenButton, on random bouncy press traces with random intervals in every mode.
+// Both are refreshed at the same (irregular) times and every result is compared, then the refresh cost of
+// 4096 instances of each is measured on the standard schedule.
+#define COMPACT_TRACES				400
+#define COMPACT_TRACE_MS			60000
+#define COMPACT_PIN					3
+
+static void benchCompact()
+{
+	BenchRandom cRandom(0xACC5E11);
+	unsigned long ulMismatches = 0;
+	unsigned long ulChecks = 0;
+
+	for (unsigned long ulTrace = 0; ulTrace < COMPACT_TRACES; ulTrace++)
+	{
+		uint8_t uiMode = (uint8_t)(ulTrace % (ACKSEN_BUTTON_MODE_ACCELERATE + 1));
+
+		AcksenButtonHost::reset();
+		AcksenButtonHost::setMillis(cRandom.range(0, 0xFFFFF));
+
+		AcksenButtonCompactConfig sConfig((uint16_t)cRandom.range(1, 50));
+		sConfig.uiLongPressInterval_MS = (uint16_t)cRandom.range(100, 4000);
+		sConfig.uiRepeatPressesInterval_MS = (uint16_t)cRandom.range(50, 1000);
+		sConfig.uiRepeatInitialOffsetDelay_MS = (uint16_t)cRandom.range(50, 2000);
+		sConfig.uiAccelerationInitialOffsetDelay_MS = (uint16_t)cRandom.range(100, 4000);
+		sConfig.uiAccelerationPressesInterval_MS = (uint16_t)cRandom.range(10, 200);
+
+		AcksenButton cRuntime(COMPACT_PIN, uiMode, sConfig.uiDebounceInterval_MS, INPUT);
+		cRuntime.setLongPressInterval(sConfig.uiLongPressInterval_MS);
+		cRuntime.setRepeatPressesInterval(sConfig.uiRepeatPressesInterval_MS);
+		cRuntime.setRepeatInitialOffsetDelay(sConfig.uiRepeatInitialOffsetDelay_MS);
+		cRuntime.setAccelerationInitialOffsetDelay(sConfig.uiAccelerationInitialOffsetDelay_MS);
+		cRuntime.setAccelerationPressesInterval(sConfig.uiAccelerationPressesInterval_MS);
+
+		AcksenButtonCompact cCompact(COMPACT_PIN, uiMode, &sConfig, INPUT);
+
+		bool bLevel = false;
+		unsigned long ulNextChange = cRandom.range(1, 3000);
+		unsigned long ulBounceEnd = 0;
+
+		for (unsigned long ulTime = 0; ulTime < COMPACT_TRACE_MS; ulTime += cRandom.range(1, 4))
+		{
+			AcksenButtonHost::advanceMillis(ulTime == 0 ? 0 : 1);
+
+			// Alternate between long and short holds, with a burst of contact bounce after each change
+			if (ulTime >= ulNextChange)
+			{
+				bLevel = !bLevel;
+				ulBounceEnd = ulTime + cRandom.range(0, 15);
+				ulNextChange = ulTime + cRandom.range(5, bLevel ? 8000 : 3000);
+			}
+
+			AcksenButtonHost::setPin(COMPACT_PIN, (ulTime < ulBounceEnd) ? (cRandom.range(0, 1) == 1) : bLevel);
+
+			ulMismatches += (cRuntime.refreshStatus() != cCompact.refreshStatus());
+			ulMismatches += (cRuntime.getButtonState() != cCompact.getButtonState());
+
+			// Check events on most scans, leaving some unread, as an application might
+			if (cRandom.range(0, 3) != 0)
+			{
+				ulMismatches += (cRuntime.onPressed() != cCompact.onPressed());
+				ulMismatches += (cRuntime.onReleased() != cCompact.onReleased());
+				ulMismatches += (cRuntime.onLongPress() != cCompact.onLongPress());
+			}
+
+			if (cRuntime.getTimeFromLastStateChange() <= ACKSEN_BUTTON_COMPACT_MAX_INTERVAL)
+			{
+				ulMismatches += (cRuntime.getTimeFromLastStateChange() != cCompact.getTimeFromLastStateChange());
+			}
+			else
+			{
+				ulMismatches += (cCompact.getTimeFromLastStateChange() <= ACKSEN_BUTTON_COMPACT_MAX_INTERVAL);
+			}
+
+			ulChecks++;
+		}
+	}
+
+	printf("%-12s %-22s %lu scans compared against AcksenButton, %lu mismatches\n", "compact", "random traces", ulChecks, ulMismatches);
+	printf("%-12s %-22s sizeof %u bytes (runtime %u bytes), config %u bytes shared\n", "compact", "",
+		(unsigned)sizeof(AcksenButtonCompact), (unsigned)sizeof(AcksenButton), (unsigned)sizeof(AcksenButtonCompactConfig));
+
+	for (uint8_t uiMode = ACKSEN_BUTTON_MODE_NORMAL; uiMode <= ACKSEN_BUTTON_MODE_ACCELERATE; uiMode++)
+	{
+		unsigned long ulButtons = 4096;
+		unsigned long ulScans = scanCount(ulButtons);
+		unsigned long ulEvents = 0;
+
+		AcksenButtonHost::reset();
+
+		AcksenButtonCompactConfig sConfig(BENCH_DEBOUNCE_INTERVAL);
+		BenchSchedule cSchedule(ACKSEN_HOST_PIN_COUNT);
+		std::vector<AcksenButtonCompact> aButtons;
+
+		for (unsigned long i = 0; i < ulButtons; i++)
+		{
+			aButtons.push_back(AcksenButtonCompact((uint8_t)(i % ACKSEN_HOST_PIN_COUNT), uiMode, &sConfig, INPUT));
+		}
+
+		BenchClock::time_point tStart = BenchClock::now();
+
+		for (unsigned long ulScan = 0; ulScan < ulScans; ulScan++)
+		{
+			AcksenButtonHost::advanceMillis(1);
+			cSchedule.apply(AcksenButtonHAL::getMillis());
+
+			for (unsigned long i = 0; i < ulButtons; i++)
+			{
+				ulEvents += aButtons[i].refreshStatus();
+			}
+		}
+
+		BenchClock::time_point tEnd = BenchClock::now();
+
+		ulBenchSink += ulEvents;
+
+		printResult("compact", modeName(uiMode), ulButtons, (unsigned long long)ulScans * ulButtons, elapsedNs(tStart, tEnd) - scheduleOverheadNs(ulScans));
+	}
+}
+
+// Individual refreshStatus() calls (one clock read per button) against AcksenButtonGroup::refreshAll() (one clock
+// read per scan), as the number of buttons grows. On the host the simulated clock is a single atomic load, so
+// this understates the saving on AVR, where each millis() call also disables and restores interrupts.
+#define GROUP_CAPACITY				4096
+
+static void benchGroup()
+{
+	static const unsigned long aButtonCounts[] = { 1, 8, 64, 512, 4096 };
+
+	for (size_t c = 0; c < sizeof(aButtonCounts) / sizeof(aButtonCounts[0]); c++)
+	{
+		unsigned long ulButtons = aButtonCounts[c];
+
+		for (uint8_t uiGrouped = 0; uiGrouped <= 1; uiGrouped++)
+		{
+			unsigned long ulScans = scanCount(ulButtons);
+			unsigned long ulEvents = 0;
+
+			AcksenButtonHost::reset();
+
+			BenchSchedule cSchedule(ACKSEN_HOST_PIN_COUNT);
+			std::vector<AcksenButton> aButtons;
+			static AcksenButtonGroup<GROUP_CAPACITY> cGroup;
+
+			cGroup = AcksenButtonGroup<GROUP_CAPACITY>();
+			aButtons.reserve(ulButtons);
+
+			for (unsigned long i = 0; i < ulButtons; i++)
+			{
+				aButtons.push_back(AcksenButton((uint8_t)(i % ACKSEN_HOST_PIN_COUNT), ACKSEN_BUTTON_MODE_ACCELERATE, BENCH_DEBOUNCE_INTERVAL, INPUT));
+				cGroup.add(&aButtons[i]);
+			}
+
+			BenchClock::time_point tStart = BenchClock::now();
+
+			for (unsigned long ulScan = 0; ulScan < ulScans; ulScan++)
+			{
+				AcksenButtonHost::advanceMillis(1);
+				cSchedule.apply(AcksenButtonHAL::getMillis());
+
+				if (uiGrouped)
+				{
+					ulEvents += cGroup.refreshAll();
+				}
+				else
+				{
+					for (unsigned long i = 0; i < ulButtons; i++)
+					{
+						ulEvents += aButtons[i].refreshStatus();
+					}
+				}
+			}
+
+			BenchClock::time_point tEnd = BenchClock::now();
+
+			ulBenchSink += ulEvents;
+
+			printResult("group", uiGrouped ? "refreshAll()" : "refreshStatus() each", ulButtons, (unsigned long long)ulScans * ulButtons,
+				elapsedNs(tStart, tEnd) - scheduleOverheadNs(ulScans));
+		}
+	}
+}
+
+// Tickless scheduling: a loop that sleeps until AcksenButtonGroup::getNextDeadline() or the next pin change,
+// against one that refreshes every millisecond. Both record every event through event queues, and the two
+// event streams must be identical. Reports how many wakeups each approach needs.
+#define TICKLESS_BUTTONS			64
+#define TICKLESS_DURATION_MS		120000UL
+
+static unsigned long runTickless(bool bTickless, std::vector<BenchEventRecord>& aRecords)
+{
+	AcksenButtonHost::reset();
+
+	BenchSchedule cSchedule(ACKSEN_HOST_PIN_COUNT);
+	std::vector<AcksenButton> aButtons;
+	std::vector<AcksenButtonEventQueue> aQueues(TICKLESS_BUTTONS);
+	static AcksenButtonGroup<TICKLESS_BUTTONS> cGroup;
+
+	cGroup = AcksenButtonGroup<TICKLESS_BUTTONS>();
+	aButtons.reserve(TICKLESS_BUTTONS);
+
+	for (unsigned long i = 0; i < TICKLESS_BUTTONS; i++)
+	{
+		aButtons.push_back(AcksenButton((uint8_t)(i % ACKSEN_HOST_PIN_COUNT), (uint8_t)(i % (ACKSEN_BUTTON_MODE_ACCELERATE + 1)), BENCH_DEBOUNCE_INTERVAL, INPUT));
+		aButtons[i].setEventQueue(&aQueues[i]);
+		cGroup.add(&aButtons[i]);
+	}
+
+	unsigned long ulWakeups = 0;
+	unsigned long ulNow = 0;
+
+	while (ulNow < TICKLESS_DURATION_MS)
+	{
+		cSchedule.apply(ulNow);
+		cGroup.refreshAll(ulNow);
+		ulWakeups++;
+
+		for (unsigned long i = 0; i < TICKLESS_BUTTONS; i++)
+		{
+			AcksenButtonEvent sEvent;
+
+			while (aButtons[i].pollEvent(sEvent))
+			{
+				aRecords.push_back({ i, sEvent.ulTimestamp_MS, sEvent.uiType });
+			}
+		}
+
+		// Sleep until the next deadline, or the pin change interrupt that would wake us first
+		unsigned long ulWake = ulNow + 1;
+
+		if (bTickless)
+		{
+			unsigned long ulDeadline = 0;
+
+			ulWake = cSchedule.nextChange();
+
+			if (cGroup.getNextDeadline(ulDeadline) && acksenButtonTimeBefore(ulDeadline, ulWake))
+			{
+				ulWake = ulDeadline;
+			}
+
+			if (!acksenButtonTimeBefore(ulNow, ulWake))
+			{
+				ulWake = ulNow + 1;
+			}
+		}
+
+		ulNow = ulWake;
+		AcksenButtonHost::setMillis(ulNow);
+	}
+
+	return ulWakeups;
+}
+
+static void benchTickless()
+{
+	std::vector<BenchEventRecord> aPolled;
+	std::vector<BenchEventRecord> aTickless;
+
+	unsigned long ulPolledWakeups = runTickless(false, aPolled);
+	unsigned long ulTicklessWakeups = runTickless(true, aTickless);
+	unsigned long ulMismatches = (aPolled.size() != aTickless.size()) ? 1 : 0;
+
+	for (size_t i = 0; (i < aPolled.size()) && (i < aTickless.size()); i++)
+	{
+		ulMismatches += (aPolled[i].ulButton != aTickless[i].ulButton) || (aPolled[i].ulTimestamp_MS != aTickless[i].ulTimestamp_MS) || (aPolled[i].uiType != aTickless[i].uiType);
+	}
+
+	printf("%-12s %lu buttons over %lus: polled %lu wakeups, tickless %lu wakeups (%.1f%%), %lu events, %lu mismatches\n", "tickless",
+		(unsigned long)TICKLESS_BUTTONS, TICKLESS_DURATION_MS / 1000, ulPolledWakeups, ulTicklessWakeups, 100.0 * ulTicklessWakeups / ulPolledWakeups,
+		(unsigned long)aPolled.size(), ulMismatches);
+}
+
+// Timer wheel: a multiplexed panel of WHEEL_BUTTONS buttons (several per input), scanned every millisecond.
+// The polled loop refreshes every button; the wheel loop refreshes only the buttons whose input changed, then
+// advances an AcksenButtonTimerWheel to refresh those with an expiring deadline. Each is run from zero and again
+// starting WHEEL_ROLLOVER_LEAD_MS before the clock rolls over. Every event stream, relative to its start time,
+// must match the polled run from zero.
+#define WHEEL_BUTTONS				1024
+#define WHEEL_DURATION_MS			60000UL
+#define WHEEL_ROLLOVER_LEAD_MS		20000UL
+
+static double runWheel(bool bWheel, unsigned long ulStart, std::vector<BenchEventRecord>& aRecords)
+{
+	AcksenButtonHost::reset();
+	AcksenButtonHost::setMillis(ulStart);
+
+	BenchSchedule cSchedule(ACKSEN_HOST_PIN_COUNT, ulStart);
+	std::vector<AcksenButton> aButtons;
+	std::vector<AcksenButtonEventQueue> aQueues(WHEEL_BUTTONS);
+	std::vector<uint8_t> aChanged;
+	static AcksenButtonGroup<WHEEL_BUTTONS> cGroup;
+	static AcksenButtonTimerWheel<WHEEL_BUTTONS> cWheel;
+
+	cGroup = AcksenButtonGroup<WHEEL_BUTTONS>();
+	cWheel = AcksenButtonTimerWheel<WHEEL_BUTTONS>();
+	aButtons.reserve(WHEEL_BUTTONS);
+
+	for (unsigned long i = 0; i < WHEEL_BUTTONS; i++)
+	{
+		aButtons.push_back(AcksenButton((uint8_t)(i % ACKSEN_HOST_PIN_COUNT), (uint8_t)(i % (ACKSEN_BUTTON_MODE_ACCELERATE + 1)), BENCH_DEBOUNCE_INTERVAL, INPUT));
+		aButtons[i].setEventQueue(&aQueues[i]);
+	}
+
+	// Added once constructed, so the vector never moves a registered button
+	for (unsigned long i = 0; i < WHEEL_BUTTONS; i++)
+	{
+		cGroup.add(&aButtons[i]);
+		cWheel.add(&aButtons[i], ulStart);
+	}
+
+	double dScanNs = 0;
+
+	for (unsigned long ulElapsed = 0; ulElapsed < WHEEL_DURATION_MS; ulElapsed++)
+	{
+		unsigned long ulNow = ulStart + ulElapsed;
+
+		AcksenButtonHost::setMillis(ulNow);
+		aChanged.clear();
+		cSchedule.apply(ulNow, &aChanged);
+
+		BenchClock::time_point tStart = BenchClock::now();
+
+		if (bWheel)
+		{
+			for (size_t c = 0; c < aChanged.size(); c++)
+			{
+				for (unsigned long i = aChanged[c]; i < WHEEL_BUTTONS; i += ACKSEN_HOST_PIN_COUNT)
+				{
+					cWheel.refreshButton((uint16_t)i, ulNow);
+				}
+			}
+
+			cWheel.advance(ulNow);
+		}
+		else
+		{
+			cGroup.refreshAll(ulNow);
+		}
+
+		dScanNs += elapsedNs(tStart, BenchClock::now());
+
+		for (unsigned long i = 0; i < WHEEL_BUTTONS; i++)
+		{
+			AcksenButtonEvent sEvent;
+
+			while (aButtons[i].pollEvent(sEvent))
+			{
+				aRecords.push_back({ i, sEvent.ulTimestamp_MS - ulStart, sEvent.uiType });
+			}
+		}
+	}
+
+	return dScanNs / WHEEL_DURATION_MS;
+}
+
+static void benchWheel()
+{
+	std::vector<BenchEventRecord> aReference;
+
+	runWheel(false, 0, aReference);
+
+	for (uint8_t uiRun = 0; uiRun < 4; uiRun++)
+	{
+		bool bWheel = (uiRun & 1) != 0;
+		bool bRollover = (uiRun & 2) != 0;
+		std::vector<BenchEventRecord> aRecords;
+
+		double dScanNs = runWheel(bWheel, bRollover ? (ULONG_MAX - WHEEL_ROLLOVER_LEAD_MS + 1) : 0, aRecords);
+		unsigned long ulMismatches = (aRecords.size() != aReference.size()) ? 1 : 0;
+
+		for (size_t i = 0; (i < aRecords.size()) && (i < aReference.size()); i++)
+		{
+			ulMismatches += (aRecords[i].ulButton != aReference[i].ulButton) || (aRecords[i].ulTimestamp_MS != aReference[i].ulTimestamp_MS) || (aRecords[i].uiType != aReference[i].uiType);
+		}
+
+		printf("%-12s %-22s %6u  %12.1f ns/scan  %lu events, %lu mismatches\n", "wheel",
+			bRollover ? (bWheel ? "wheel, rollover" : "polled, rollover") : (bWheel ? "wheel" : "polled"),
+			(unsigned)WHEEL_BUTTONS, dScanNs, (unsigned long)aRecords.size(), ulMismatches);
+	}
+}
+
+// Debounce strategies, replayed against bounce traces sampled every millisecond. Each trace is a run of
+// presses with bursts of contact bounce after every press and release, generated from a seeded model of the
+// switch types below (clean, typical, worn with bounce longer than the debounce interval, and noisy with
+// 1ms glitches while stable). Reports, per strategy: mean and worst press-to-report latency, false edges
+// (reported changes beyond one press and one release per cycle), missed changes, and refresh cost per sample.
+#define DEBOUNCE_PRESSES			2000
+#define DEBOUNCE_INTERVAL			20
+#define DEBOUNCE_PIN				7
+
+struct BenchBounceProfile
+{
+	const char* szName;
+	uint8_t uiBounceMin_MS;
+	uint8_t uiBounceMax_MS;
+	uint16_t uiGlitchesPer10000;		// Chance of a 1ms glitch in each stable millisecond
+	uint8_t uiFinalBounceMax_MS;		// Longest bounce by the end of the trace, for a switch wearing as it is used
+};
+
+static const BenchBounceProfile aBounceProfiles[] =
+{
+	{ "clean", 0, 1, 0, 1 },
+	{ "typical", 1, 6, 0, 6 },
+	{ "worn", 8, 30, 0, 30 },
+	{ "noisy", 1, 6, 20, 6 },
+	{ "wearing", 1, 6, 0, 30 },
+};
+
+struct BenchBounceTrace
+{
+	std::vector<uint8_t> aLevels;			// Input level for each millisecond
+	std::vector<unsigned long> aPresses;	// Time of the first contact of each press
+};
+
+struct BenchDebounceResult
+{
+	unsigned long ulLatencyTotal_MS;
+	unsigned long ulLatencyMax_MS;
+	unsigned long ulLatencyCount;
+	unsigned long ulFalseEdges;
+	unsigned long ulMissed;
+	double dNsPerSample;
+};
+
+static BenchBounceTrace buildBounceTrace(const BenchBounceProfile& sProfile, uint32_t uiSeed)
+{
+	BenchBounceTrace sTrace;
+	BenchRandom cRandom(uiSeed);
+	bool bLevel = false;
+
+	// Appends ulLength stable milliseconds, with the occasional glitch
+	auto stable = [&](unsigned long ulLength)
+	{
+		for (unsigned long i = 0; i < ulLength; i++)
+		{
+			bool bGlitch = (cRandom.range(0, 9999) < sProfile.uiGlitchesPer10000);
+
+			sTrace.aLevels.push_back(bGlitch ? !bLevel : bLevel);
+		}
+	};
+
+	// Switches to the new level, with a burst of bounce starting at the first contact
+	auto bounce = [&](bool bNewLevel, unsigned long ulPress)
+	{
+		unsigned long ulBounceMax = sProfile.uiBounceMax_MS + (sProfile.uiFinalBounceMax_MS - sProfile.uiBounceMax_MS) * ulPress / DEBOUNCE_PRESSES;
+		unsigned long ulBounce = cRandom.range(sProfile.uiBounceMin_MS, ulBounceMax);
+
+		for (unsigned long i = 0; i < ulBounce; i++)
+		{
+			sTrace.aLevels.push_back((i == 0) ? bNewLevel : (cRandom.range(0, 1) != 0));
+		}
+
+		bLevel = bNewLevel;
+	};
+
+	stable(500);
+
+	for (unsigned long ulPress = 0; ulPress < DEBOUNCE_PRESSES; ulPress++)
+	{
+		sTrace.aPresses.push_back(sTrace.aLevels.size());
+		bounce(true, ulPress);
+		stable(cRandom.range(80, 400));
+		bounce(false, ulPress);
+		stable(cRandom.range(150, 400));
+	}
+
+	return sTrace;
+}
+
+// Replays a trace into a button, already configured, and scores the events it reports
+static BenchDebounceResult replayBounceTrace(const BenchBounceTrace& sTrace, AcksenButton& cButton)
+{
+	BenchDebounceResult sResult = { 0, 0, 0, 0, 0, 0 };
+	AcksenButtonEventQueue cQueue;
+	std::vector<AcksenButtonEvent> aEvents;
+	double dRefreshNs = 0;
+
+	cButton.setEventQueue(&cQueue);
+
+	for (unsigned long ulNow = 0; ulNow < sTrace.aLevels.size(); ulNow++)
+	{
+		AcksenButtonHost::setPin(DEBOUNCE_PIN, sTrace.aLevels[ulNow] != 0);
+
+		BenchClock::time_point tStart = BenchClock::now();
+		cButton.refreshStatus(ulNow);
+		dRefreshNs += elapsedNs(tStart, BenchClock::now());
+
+		AcksenButtonEvent sEvent;
+
+		while (cButton.pollEvent(sEvent))
+		{
+			aEvents.push_back(sEvent);
+		}
+	}
+
+	cButton.setEventQueue(NULL);
+
+	// Each cycle, from one first contact to the next, should hold exactly one press and one release
+	size_t uiEvent = 0;
+
+	for (size_t uiCycle = 0; uiCycle < sTrace.aPresses.size(); uiCycle++)
+	{
+		unsigned long ulCycleEnd = (uiCycle + 1 < sTrace.aPresses.size()) ? sTrace.aPresses[uiCycle + 1] : sTrace.aLevels.size();
+		unsigned long ulPresses = 0;
+		unsigned long ulReleases = 0;
+
+		for (; (uiEvent < aEvents.size()) && (aEvents[uiEvent].ulTimestamp_MS < ulCycleEnd); uiEvent++)
+		{
+			if (aEvents[uiEvent].uiType == ACKSEN_BUTTON_EVENT_PRESSED)
+			{
+				if ((ulPresses == 0) && (aEvents[uiEvent].ulTimestamp_MS >= sTrace.aPresses[uiCycle]))
+				{
+					unsigned long ulLatency = aEvents[uiEvent].ulTimestamp_MS - sTrace.aPresses[uiCycle];
+
+					sResult.ulLatencyTotal_MS += ulLatency;
+					sResult.ulLatencyMax_MS = (ulLatency > sResult.ulLatencyMax_MS) ? ulLatency : sResult.ulLatencyMax_MS;
+					sResult.ulLatencyCount++;
+				}
+
+				ulPresses++;
+			}
+			else if (aEvents[uiEvent].uiType == ACKSEN_BUTTON_EVENT_RELEASED)
+			{
+				ulReleases++;
+			}
+		}
+
+		sResult.ulFalseEdges += (ulPresses > 1 ? ulPresses - 1 : 0) + (ulReleases > 1 ? ulReleases - 1 : 0);
+		sResult.ulMissed += (ulPresses == 0) + (ulReleases == 0);
+	}
+
+	sResult.dNsPerSample = dRefreshNs / sTrace.aLevels.size();
+
+	return sResult;
+}
+
+static void printDebounceResult(const char* szProfile, const char* szStrategy, const BenchDebounceResult& sResult)
+{
+	char szCase[32];
+
+	snprintf(szCase, sizeof(szCase), "%s/%s", szProfile, szStrategy);
+
+	printf("%-12s %-22s latency %5.1f ms (max %2lu), %4lu false edges, %4lu missed, %5.1f ns/sample\n", "debounce",
+		szCase, sResult.ulLatencyCount ? (double)sResult.ulLatencyTotal_MS / sResult.ulLatencyCount : 0.0, sResult.ulLatencyMax_MS,
+		sResult.ulFalseEdges, sResult.ulMissed, sResult.dNsPerSample);
+}
+
+static void benchDebounce()
+{
+	static const char* aszStrategies[] = { "timestamp", "integrator", "majority", "lockout", "adaptive" };
+
+	for (size_t p = 0; p < sizeof(aBounceProfiles) / sizeof(aBounceProfiles[0]); p++)
+	{
+		BenchBounceTrace sTrace = buildBounceTrace(aBounceProfiles[p], 0x5EED0000 + p);
+
+		for (uint8_t uiStrategy = ACKSEN_BUTTON_DEBOUNCE_TIMESTAMP; uiStrategy <= ACKSEN_BUTTON_DEBOUNCE_ADAPTIVE; uiStrategy++)
+		{
+			AcksenButtonHost::reset();
+
+			AcksenButton cButton(DEBOUNCE_PIN, ACKSEN_BUTTON_MODE_NORMAL, DEBOUNCE_INTERVAL, INPUT);
+
+			cButton.setDebounceStrategy(uiStrategy);
+
+			printDebounceResult(aBounceProfiles[p].szName, aszStrategies[uiStrategy], replayBounceTrace(sTrace, cButton));
+
+			if (uiStrategy == ACKSEN_BUTTON_DEBOUNCE_ADAPTIVE)
+			{
+				printf("%-12s %-22s learned window %lu ms (bounds %u-%u ms, fixed interval %u ms)\n", "debounce", "",
+					cButton.getLearnedDebounceInterval(), DEFAULT_ADAPTIVE_DEBOUNCE_MINIMUM, DEFAULT_ADAPTIVE_DEBOUNCE_MAXIMUM, DEBOUNCE_INTERVAL);
+			}
+		}
+	}
+}
+
+// Event queues under load: the application only services its buttons every EVENTS_SERVICE_INTERVAL scans.
+// Counts the presses, releases and repeats seen through onPressed()/onReleased() (which only hold the result
+// of the latest refresh) against those seen through pollEvent(), and the refresh cost with a queue attached.
+#define EVENTS_BUTTONS				64
+#define EVENTS_SERVICE_INTERVAL		5
+
+static void benchEvents()
+{
+	for (uint8_t uiQueued = 0; uiQueued <= 1; uiQueued++)
+	{
+		unsigned long ulScans = scanCount(EVENTS_BUTTONS);
+		unsigned long ulGenerated = 0;
+		unsigned long ulSeen = 0;
+		unsigned long ulOverflows = 0;
+
+		AcksenButtonHost::reset();
+
+		BenchSchedule cSchedule(ACKSEN_HOST_PIN_COUNT);
+		std::vector<AcksenButton> aButtons;
+		std::vector<AcksenButtonEventQueue> aQueues(EVENTS_BUTTONS);
+
+		for (unsigned long i = 0; i < EVENTS_BUTTONS; i++)
+		{
+			aButtons.push_back(AcksenButton((uint8_t)(i % ACKSEN_HOST_PIN_COUNT), ACKSEN_BUTTON_MODE_ACCELERATE, BENCH_DEBOUNCE_INTERVAL, INPUT));
+		}
+
+		for (unsigned long i = 0; (i < EVENTS_BUTTONS) && uiQueued; i++)
+		{
+			aButtons[i].setEventQueue(&aQueues[i]);
+		}
+
+		double dRefreshNs = 0;
+
+		for (unsigned long ulScan = 0; ulScan < ulScans; ulScan++)
+		{
+			AcksenButtonHost::advanceMillis(1);
+			cSchedule.apply(AcksenButtonHAL::getMillis());
+
+			BenchClock::time_point tStart = BenchClock::now();
+
+			for (unsigned long i = 0; i < EVENTS_BUTTONS; i++)
+			{
+				ulGenerated += aButtons[i].refreshStatus();
+			}
+
+			dRefreshNs += elapsedNs(tStart, BenchClock::now());
+
+			if ((ulScan % EVENTS_SERVICE_INTERVAL) != 0)
+			{
+				continue;
+			}
+
+			for (unsigned long i = 0; i < EVENTS_BUTTONS; i++)
+			{
+				if (uiQueued)
+				{
+					AcksenButtonEvent sEvent;
+
+					while (aButtons[i].pollEvent(sEvent))
+					{
+						ulSeen++;
+					}
+				}
+				else
+				{
+					ulSeen += aButtons[i].onPressed();
+					ulSeen += aButtons[i].onReleased();
+				}
+			}
+		}
+
+		for (unsigned long i = 0; i < EVENTS_BUTTONS; i++)
+		{
+			ulOverflows += aButtons[i].getEventOverflowCount();
+		}
+
+		printf("%-12s %-22s %lu generated, %lu seen (%.1f%%), %lu overflowed, refresh %.2f ns/call\n", "events",
+			uiQueued ? "pollEvent()" : "onPressed/onReleased", ulGenerated, ulSeen, 100.0 * ulSeen / ulGenerated, ulOverflows,
+			dRefreshNs / ((double)ulScans * EVENTS_BUTTONS));
+	}
+}
+
+// Interrupt-driven edge capture, with a thread standing in for the pin-change ISR.
+// The "ISR" thread owns the simulated clock and generates bouncy presses, calling captureEdge() on every edge.
+// The main loop refreshes at an irregular, slow rate and checks that every press and release is reported
+// with the exact time of its first edge, however late the refresh that reports it.
+#define CAPTURE_PRESSES				20000
+#define CAPTURE_START_MS			1000
+#define CAPTURE_HOLD_MS				50
+#define CAPTURE_GAP_MS				50
+#define CAPTURE_PIN					5
+
+static AcksenButtonEdgeRing cCaptureRing;
+static std::atomic<unsigned long> ulCaptureReported(0);
+static std::atomic<bool> bCaptureDone(false);
+
+static void captureIsrThread(AcksenButton* pButton)
+{
+	// Start clear of the debounce interval that follows construction
+	AcksenButtonHost::setMillis(CAPTURE_START_MS);
+
+	for (unsigned long ulPress = 0; ulPress < CAPTURE_PRESSES; ulPress++)
+	{
+		for (uint8_t uiLevel = 1; uiLevel <= 2; uiLevel++)
+		{
+			bool bLevel = (uiLevel == 1);
+
+			// First edge, then 3ms of chatter settling on the new level
+			for (uint8_t uiBounce = 0; uiBounce < 5; uiBounce++)
+			{
+				AcksenButtonHost::setPin(CAPTURE_PIN, (uiBounce % 2 == 0) ? bLevel : !bLevel);
+				pButton->captureEdge();
+
+				if (uiBounce % 2 == 1)
+				{
+					AcksenButtonHost::advanceMillis(1);
+				}
+			}
+
+			AcksenButtonHost::advanceMillis(bLevel ? CAPTURE_HOLD_MS : CAPTURE_GAP_MS);
+		}
+
+		// Pace the ISR to the consumer, one press/release cycle at a time, so the ring cannot overflow
+		while (ulCaptureReported.load() < 2 * (ulPress + 1))
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	bCaptureDone = true;
+}
+
+// Overflow - a Repeat mode button whose ring overflows while the main loop is stalled, with CAPTURE_OVERFLOW_EDGES
+// bouncing edges that end on the level they started from (a press and release) or on the other level (a press).
+// Once the loop resumes, the button must settle to the pin's level within CAPTURE_OVERFLOW_SETTLE_MS, and then stop
+// repeating if the pin is released. A clean edge after each stall must then be reported, as the ISR side no longer
+// knows which level it last passed on.
+#define CAPTURE_OVERFLOW_STALLS		100
+#define CAPTURE_OVERFLOW_EDGES		20
+#define CAPTURE_OVERFLOW_SETTLE_MS	1000
+#define CAPTURE_OVERFLOW_RUN_MS		3000
+
+static void benchCaptureOverflow()
+{
+	AcksenButtonHost::reset();
+
+	AcksenButton cButton(CAPTURE_PIN, ACKSEN_BUTTON_MODE_REPEAT, BENCH_DEBOUNCE_INTERVAL, INPUT);
+	AcksenButtonEdgeRing cRing;
+	unsigned long ulNow = CAPTURE_START_MS;
+	unsigned long ulMismatches = 0;
+	bool bLevel = false;
+
+	cButton.setEdgeCapture(&cRing);
+
+	// Refreshes every millisecond for ulPeriod_MS, returning the presses reported from ulCount_MS onwards
+	auto runFor = [&](unsigned long ulPeriod_MS, unsigned long ulCount_MS)
+	{
+		unsigned long ulPresses = 0;
+
+		for (unsigned long ulElapsed = 0; ulElapsed < ulPeriod_MS; ulElapsed++, ulNow++)
+		{
+			AcksenButtonHost::setMillis(ulNow);
+			cButton.refreshStatus(ulNow);
+			ulPresses += (cButton.onPressed() && (ulElapsed >= ulCount_MS));
+			cButton.onReleased();
+		}
+
+		return ulPresses;
+	};
+
+	// Sets the pin, as the edge interrupt would see it
+	auto setEdge = [&](bool bNewLevel)
+	{
+		bLevel = bNewLevel;
+		AcksenButtonHost::setMillis(ulNow);
+		AcksenButtonHost::setPin(CAPTURE_PIN, bLevel);
+		cButton.captureEdge();
+	};
+
+	for (unsigned long ulStall = 0; ulStall < CAPTURE_OVERFLOW_STALLS; ulStall++)
+	{
+		unsigned long ulEdges = CAPTURE_OVERFLOW_EDGES + (ulStall % 2);
+
+		// No refresh while the edges arrive, a millisecond apart
+		for (unsigned long ulEdge = 0; ulEdge < ulEdges; ulEdge++, ulNow++)
+		{
+			setEdge(!bLevel);
+		}
+
+		unsigned long ulPresses = runFor(CAPTURE_OVERFLOW_RUN_MS, CAPTURE_OVERFLOW_SETTLE_MS);
+
+		ulMismatches += (cButton.getButtonState() != bLevel);
+		ulMismatches += (!bLevel && (ulPresses != 0));
+
+		// A clean edge, reported once debounced
+		setEdge(!bLevel);
+		runFor(BENCH_DEBOUNCE_INTERVAL + 1, 0);
+
+		ulMismatches += (cButton.getButtonState() != bLevel);
+
+		runFor(BENCH_DEBOUNCE_INTERVAL, 0);
+	}
+
+	printf("%-12s %-22s %lu stalls, ring overflows %u, %lu mismatches\n", "capture", "overflow", (unsigned long)CAPTURE_OVERFLOW_STALLS,
+		cRing.getOverflowCount(), ulMismatches + (cRing.getOverflowCount() == 0));
+}
+
+static void benchCapture()
+{
+	AcksenButtonHost::reset();
+
+	AcksenButton cButton(CAPTURE_PIN, ACKSEN_BUTTON_MODE_NORMAL, BENCH_DEBOUNCE_INTERVAL, INPUT);
+	cButton.setEdgeCapture(&cCaptureRing);
+
+	unsigned long ulPresses = 0;
+	unsigned long ulReleases = 0;
+	unsigned long ulTimingErrors = 0;
+	unsigned long ulRefreshes = 0;
+
+	BenchClock::time_point tStart = BenchClock::now();
+
+	std::thread cIsr(captureIsrThread, &cButton);
+
+	while (!bCaptureDone)
+	{
+		ulRefreshes++;
+
+		if (cButton.refreshStatus())
+		{
+			unsigned long ulNow;
+			unsigned long ulSinceChange;
+
+			// The ISR thread moves the clock - read until the change time is seen against a stable clock
+			do
+			{
+				ulNow = AcksenButtonHAL::getMillis();
+				ulSinceChange = cButton.getTimeFromLastStateChange();
+			}
+			while (AcksenButtonHAL::getMillis() != ulNow);
+
+			unsigned long ulChangeTime = ulNow - ulSinceChange;
+			unsigned long ulEdgeTime;
+
+			if (cButton.onPressed())
+			{
+				ulEdgeTime = CAPTURE_START_MS + ulPresses * (CAPTURE_HOLD_MS + CAPTURE_GAP_MS + 4);
+				ulPresses++;
+			}
+			else
+			{
+				cButton.onReleased();
+				ulEdgeTime = CAPTURE_START_MS + ulReleases * (CAPTURE_HOLD_MS + CAPTURE_GAP_MS + 4) + CAPTURE_HOLD_MS + 2;
+				ulReleases++;
+			}
+
+			ulTimingErrors += (ulChangeTime != ulEdgeTime);
+
+			ulCaptureReported.store(ulPresses + ulReleases);
+		}
+
+		// Simulate a slow main loop - giving up the CPU lets the "ISR" run ahead, as interrupts would
+		std::this_thread::yield();
+	}
+
+	cIsr.join();
+
+	BenchClock::time_point tEnd = BenchClock::now();
+
+	printf("%-12s presses %lu/%u, releases %lu/%u, timing errors %lu, ring overflows %u\n", "capture",
+		ulPresses, CAPTURE_PRESSES, ulReleases, CAPTURE_PRESSES, ulTimingErrors, cCaptureRing.getOverflowCount());
+	printf("%-12s %lu refreshes, %.0f edges/s captured and debounced\n", "capture",
+		ulRefreshes, (double)CAPTURE_PRESSES * 10 * 1.0e9 / elapsedNs(tStart, tEnd));
+
+	benchCaptureOverflow();
+}
+
+
+// Time base: the cost of refreshStatus() in the millisecond and microsecond time bases, sub-millisecond debounce,
+// and timing across micros() rollover.
+// Cost - the refresh suite's schedule, on TIMEBASE_BUTTONS Long Press buttons timed each way in alternating rounds
+// (best round reported). Both must report the same events.
+// Resolution - bouncy presses and releases a few milliseconds apart, polled every TIMEBASE_POLL_US, by a microsecond
+// button with a TIMEBASE_DEBOUNCE_US debounce interval and a millisecond button with the shortest it can have (1ms).
+// Reports each button's mean error in the time of every change, and bounces reported as changes. The microsecond
+// button must report every change at the exact time of its first edge, and no bounces.
+// Rollover - Long Press, Repeat and Accelerate buttons held across micros() rolling over. Every event, relative to
+// the press, must match the same press timed from zero.
+#define TIMEBASE_BUTTONS			64
+#define TIMEBASE_ROUNDS				5
+#define TIMEBASE_CHANGES			10000
+#define TIMEBASE_POLL_US			10
+#define TIMEBASE_DEBOUNCE_US		250
+#define TIMEBASE_PIN				6
+#define TIMEBASE_HOLD_US			4000000UL
+#define TIMEBASE_ROLLOVER_LEAD_US	1200000UL
+
+static double runTimeBaseCost(uint8_t uiTimeBase, unsigned long& ulEvents)
+{
+	unsigned long ulScans = scanCount(TIMEBASE_BUTTONS);
+
+	AcksenButtonHost::reset();
+
+	BenchSchedule cSchedule(ACKSEN_HOST_PIN_COUNT);
+	std::vector<AcksenButton> aButtons;
+
+	for (unsigned long i = 0; i < TIMEBASE_BUTTONS; i++)
+	{
+		aButtons.push_back(AcksenButton((uint8_t)(i % ACKSEN_HOST_PIN_COUNT), ACKSEN_BUTTON_MODE_LONGPRESS, BENCH_DEBOUNCE_INTERVAL, INPUT));
+		aButtons[i].setTimeBase(uiTimeBase);
+	}
+
+	ulEvents = 0;
+
+	BenchClock::time_point tStart = BenchClock::now();
+
+	for (unsigned long ulScan = 0; ulScan < ulScans; ulScan++)
+	{
+		AcksenButtonHost::advanceMillis(1);
+		cSchedule.apply(AcksenButtonHAL::getMillis());
+
+		for (unsigned long i = 0; i < TIMEBASE_BUTTONS; i++)
+		{
+			ulEvents += aButtons[i].refreshStatus();
+		}
+	}
+
+	BenchClock::time_point tEnd = BenchClock::now();
+
+	return (elapsedNs(tStart, tEnd) - scheduleOverheadNs(ulScans)) / ((double)ulScans * TIMEBASE_BUTTONS);
+}
+
+// Holds a button of each mode through one press, starting at ulStart, and records its events relative to ulStart
+static void runTimeBaseRollover(unsigned long ulStart, std::vector<BenchEventRecord>& aRecords)
+{
+	static const uint8_t auiModes[] = { ACKSEN_BUTTON_MODE_LONGPRESS, ACKSEN_BUTTON_MODE_REPEAT, ACKSEN_BUTTON_MODE_ACCELERATE };
+	const uint8_t uiButtons = sizeof(auiModes) / sizeof(auiModes[0]);
+
+	AcksenButtonHost::reset();
+	AcksenButtonHost::setMicros(ulStart);
+
+	std::vector<AcksenButton> aButtons;
+	std::vector<AcksenButtonEventQueue> aQueues(uiButtons);
+
+	for (uint8_t i = 0; i < uiButtons; i++)
+	{
+		aButtons.push_back(AcksenButton(TIMEBASE_PIN, auiModes[i], 1, INPUT));
+		aButtons[i].setTimeBase(ACKSEN_BUTTON_TIME_MICROS);
+		aButtons[i].setDebounceInterval(TIMEBASE_DEBOUNCE_US);
+	}
+
+	for (uint8_t i = 0; i < uiButtons; i++)
+	{
+		aButtons[i].setEventQueue(&aQueues[i]);
+	}
+
+	AcksenButtonHost::advanceMicros(TIMEBASE_DEBOUNCE_US);
+	AcksenButtonHost::setPin(TIMEBASE_PIN, HIGH);
+
+	for (unsigned long ulElapsed = 0; ulElapsed <= 2 * TIMEBASE_HOLD_US; ulElapsed += TIMEBASE_POLL_US)
+	{
+		if (ulElapsed == TIMEBASE_HOLD_US)
+		{
+			AcksenButtonHost::setPin(TIMEBASE_PIN, LOW);
+		}
+
+		for (uint8_t i = 0; i < uiButtons; i++)
+		{
+			AcksenButtonEvent sEvent;
+
+			aButtons[i].refreshStatus();
+
+			while (aButtons[i].pollEvent(sEvent))
+			{
+				aRecords.push_back({ i, sEvent.ulTimestamp_MS - ulStart, sEvent.uiType });
+			}
+		}
+
+		AcksenButtonHost::advanceMicros(TIMEBASE_POLL_US);
+	}
+}
+
+// Adaptive debounce in microseconds - bouncy changes with gaps of up to TIMEBASE_ADAPTIVE_GAP_US between edges, on
+// a microsecond button using the Adaptive strategy with bounds well below and above them. The window it learns must
+// cover the longest gap, so that every change is reported once, only after its last edge, and no bounce is reported.
+#define TIMEBASE_ADAPTIVE_CHANGES	2000
+#define TIMEBASE_ADAPTIVE_GAP_US	1200
+#define TIMEBASE_ADAPTIVE_MIN_US	100
+#define TIMEBASE_ADAPTIVE_MAX_US	20000
+
+static void benchTimeBaseAdaptive()
+{
+	AcksenButtonHost::reset();
+
+	AcksenButton cButton(TIMEBASE_PIN, ACKSEN_BUTTON_MODE_NORMAL, 1, INPUT);
+	AcksenButtonEventQueue cQueue;
+	BenchRandom cRandom(0xADA7);
+	unsigned long ulNow_US = 0;
+	unsigned long ulChanges = 0;
+	unsigned long ulBounces = 0;
+	unsigned long ulMisses = 0;
+	unsigned long ulEarly = 0;
+
+	cButton.setTimeBase(ACKSEN_BUTTON_TIME_MICROS);
+	cButton.setDebounceInterval(4 * TIMEBASE_ADAPTIVE_GAP_US);
+	cButton.setAdaptiveDebounceBounds(TIMEBASE_ADAPTIVE_MIN_US, TIMEBASE_ADAPTIVE_MAX_US);
+	cButton.setDebounceStrategy(ACKSEN_BUTTON_DEBOUNCE_ADAPTIVE);
+	cButton.setEventQueue(&cQueue);
+
+	auto pollUntil = [&](unsigned long ulUntil_US)
+	{
+		for (; ulNow_US < ulUntil_US; ulNow_US += TIMEBASE_POLL_US)
+		{
+			AcksenButtonHost::setMicros(ulNow_US);
+			cButton.refreshStatus();
+		}
+	};
+
+	pollUntil(2 * TIMEBASE_ADAPTIVE_MAX_US);
+
+	for (unsigned long ulChange = 0; ulChange < TIMEBASE_ADAPTIVE_CHANGES; ulChange++)
+	{
+		bool bLevel = (ulChange % 2) == 0;
+		unsigned long ulEdges = 2 * cRandom.range(1, 4);
+
+		for (unsigned long ulEdge = 0; ulEdge < ulEdges; ulEdge++)
+		{
+			AcksenButtonHost::setPin(TIMEBASE_PIN, ((ulEdge % 2) == 0) ? bLevel : !bLevel);
+			pollUntil(ulNow_US + cRandom.range(TIMEBASE_ADAPTIVE_GAP_US / (2 * TIMEBASE_POLL_US), TIMEBASE_ADAPTIVE_GAP_US / TIMEBASE_POLL_US) * TIMEBASE_POLL_US);
+		}
+
+		unsigned long ulLastEdge_US = ulNow_US;
+
+		AcksenButtonHost::setPin(TIMEBASE_PIN, bLevel);
+		pollUntil(ulNow_US + 2 * TIMEBASE_ADAPTIVE_MAX_US);
+
+		AcksenButtonEvent sEvent;
+		bool bReported = false;
+
+		while (cQueue.pop(sEvent))
+		{
+			if (!bReported && (sEvent.uiType == (bLevel ? ACKSEN_BUTTON_EVENT_PRESSED : ACKSEN_BUTTON_EVENT_RELEASED)))
+			{
+				ulChanges++;
+				ulEarly += ((long)(sEvent.ulTimestamp_MS - ulLastEdge_US) < 0);
+				bReported = true;
+			}
+			else
+			{
+				ulBounces++;
+			}
+		}
+
+		ulMisses += !bReported;
+	}
+
+	printf("%-12s %-22s changes %lu/%u, learned window %luus, %lu reported mid-bounce, %lu bounces reported, %lu missed, %lu mismatches\n",
+		"timebase", "adaptive, micros", ulChanges, (unsigned)TIMEBASE_ADAPTIVE_CHANGES, cButton.getLearnedDebounceInterval(), ulEarly,
+		ulBounces, ulMisses, ulEarly + ulBounces + ulMisses);
+}
+
+static void benchTimeBase()
+{
+	// Cost
+	double adBestNs[2] = { 1.0e9, 1.0e9 };
+	unsigned long aulEvents[2] = { 0, 0 };
+
+	for (uint8_t uiRound = 0; uiRound < TIMEBASE_ROUNDS; uiRound++)
+	{
+		for (uint8_t uiTimeBase = ACKSEN_BUTTON_TIME_MILLIS; uiTimeBase <= ACKSEN_BUTTON_TIME_MICROS; uiTimeBase++)
+		{
+			adBestNs[uiTimeBase] = std::min(adBestNs[uiTimeBase], runTimeBaseCost(uiTimeBase, aulEvents[uiTimeBase]));
+		}
+	}
+
+	printf("%-12s %-22s %6u  %10.2f ns/call  %lu events\n", "timebase", "refresh, millis", (unsigned)TIMEBASE_BUTTONS, adBestNs[0], aulEvents[0]);
+	printf("%-12s %-22s %6u  %10.2f ns/call  %lu events, %lu mismatches\n", "timebase", "refresh, micros", (unsigned)TIMEBASE_BUTTONS, adBestNs[1],
+		aulEvents[1], (unsigned long)(aulEvents[0] != aulEvents[1]));
+
+	// Resolution - button 0 is timed in milliseconds, button 1 in microseconds
+	AcksenButtonHost::reset();
+
+	std::vector<AcksenButton> aButtons(2, AcksenButton(TIMEBASE_PIN, ACKSEN_BUTTON_MODE_NORMAL, 1, INPUT));
+	AcksenButtonEventQueue aQueues[2];
+	unsigned long aulChanges[2] = { 0, 0 };
+	unsigned long aulBounces[2] = { 0, 0 };
+	unsigned long aulMisses[2] = { 0, 0 };
+	unsigned long long aullError_US[2] = { 0, 0 };
+
+	aButtons[1].setTimeBase(ACKSEN_BUTTON_TIME_MICROS);
+	aButtons[1].setDebounceInterval(TIMEBASE_DEBOUNCE_US);
+	aButtons[0].setEventQueue(&aQueues[0]);
+	aButtons[1].setEventQueue(&aQueues[1]);
+
+	BenchRandom cRandom(0x71CE);
+	unsigned long ulNow_US = 0;
+
+	// Polls both buttons up to (not including) a time
+	auto pollUntil = [&](unsigned long ulUntil_US)
+	{
+		for (; ulNow_US < ulUntil_US; ulNow_US += TIMEBASE_POLL_US)
+		{
+			AcksenButtonHost::setMicros(ulNow_US);
+			aButtons[0].refreshStatus();
+			aButtons[1].refreshStatus();
+		}
+	};
+
+	pollUntil(2000);
+
+	for (unsigned long ulChange = 0; ulChange < TIMEBASE_CHANGES; ulChange++)
+	{
+		bool bLevel = (ulChange % 2) == 0;
+		unsigned long ulFirstEdge_US = ulNow_US;
+		unsigned long ulStable_US = ulNow_US + (cRandom.range(150, 300) * TIMEBASE_POLL_US);
+		unsigned long ulBounces = cRandom.range(0, 3);
+
+		// Bounce lasts under 210us, well within the microsecond button's debounce interval
+		for (unsigned long ulEdge = 0; ulEdge < 2 * ulBounces; ulEdge++)
+		{
+			AcksenButtonHost::setPin(TIMEBASE_PIN, ((ulEdge % 2) == 0) ? bLevel : !bLevel);
+			pollUntil(ulNow_US + (cRandom.range(1, 3) * TIMEBASE_POLL_US));
+		}
+
+		AcksenButtonHost::setPin(TIMEBASE_PIN, bLevel);
+		pollUntil(ulStable_US);
+
+		for (uint8_t b = 0; b < 2; b++)
+		{
+			AcksenButtonEvent sEvent;
+			bool bReported = false;
+
+			while (aQueues[b].pop(sEvent))
+			{
+				if (!bReported && (sEvent.uiType == (bLevel ? ACKSEN_BUTTON_EVENT_PRESSED : ACKSEN_BUTTON_EVENT_RELEASED)))
+				{
+					unsigned long ulEvent_US = (b == 0) ? (sEvent.ulTimestamp_MS * 1000) : sEvent.ulTimestamp_MS;
+
+					aullError_US[b] += (ulEvent_US > ulFirstEdge_US) ? (ulEvent_US - ulFirstEdge_US) : (ulFirstEdge_US - ulEvent_US);
+					aulChanges[b]++;
+					bReported = true;
+				}
+				else
+				{
+					aulBounces[b]++;
+				}
+			}
+
+			aulMisses[b] += !bReported;
+		}
+	}
+
+	for (uint8_t b = 0; b < 2; b++)
+	{
+		printf("%-12s %-22s changes %lu/%u, mean error %.1fus, %lu bounces reported, %lu missed\n", "timebase",
+			(b == 0) ? "debounce, millis 1ms" : "debounce, micros 250us", aulChanges[b], (unsigned)TIMEBASE_CHANGES,
+			aulChanges[b] ? (double)aullError_US[b] / aulChanges[b] : 0.0, aulBounces[b], aulMisses[b]);
+	}
+
+	printf("%-12s %-22s %lu mismatches\n", "timebase", "debounce, micros", aulBounces[1] + aulMisses[1] + (aullError_US[1] != 0));
+
+	benchTimeBaseAdaptive();
+
+	// Rollover
+	std::vector<BenchEventRecord> aReference;
+	std::vector<BenchEventRecord> aRecords;
+
+	runTimeBaseRollover(0, aReference);
+	runTimeBaseRollover(ULONG_MAX - TIMEBASE_ROLLOVER_LEAD_US + 1, aRecords);
+
+	unsigned long ulMismatches = (aRecords.size() != aReference.size()) ? 1 : 0;
+
+	for (size_t i = 0; (i < aRecords.size()) && (i < aReference.size()); i++)
+	{
+		ulMismatches += (aRecords[i].ulButton != aReference[i].ulButton) || (aRecords[i].ulTimestamp_MS != aReference[i].ulTimestamp_MS) || (aRecords[i].uiType != aReference[i].uiType);
+	}
+
+	printf("%-12s %-22s %lu events across micros() rollover, %lu mismatches\n", "timebase", "rollover", (unsigned long)aRecords.size(), ulMismatches);
+}
+
+// Rotary encoder: scripted turns of a model encoder, with runs of detents in either direction at random speeds,
+// and contact bounce on every transition. The same script is decoded by polling update(), by captureEdge() called
+// on every edge, and by captureEdge() from a second thread standing in for the ISR, each of which must end at the
+// exact position of the script, with no errors. Accelerate mode is checked against the position expected from its
+// timing. The polled case is then repeated at rising detent rates with a ENCODER_SLOW_POLL_US main loop, to find
+// the fastest it keeps up with, and the cost of update() and captureEdge() is measured, giving the fastest rate
+// each could keep up with on the host.
+#define ENCODER_PIN_A				40
+#define ENCODER_PIN_B				41
+#define ENCODER_SWITCH_PIN			42
+#define ENCODER_TURNS				2000
+#define ENCODER_POLL_US				50
+#define ENCODER_SLOW_POLL_US		100
+#define ENCODER_UPDATE_MS			5
+#define ENCODER_COST_CALLS			(1UL << 23)
+
+struct BenchEncoderEdge
+{
+	unsigned long ulTime_US;
+	uint8_t uiPin;
+	bool bLevel;
+};
+
+struct BenchEncoderScript
+{
+	std::vector<BenchEncoderEdge> aEdges;
+	long lDetents;							// Net detents turned
+	unsigned long ulEnd_US;
+};
+
+// Appends one detent, its four transitions evenly spaced over ulPeriod_US and the last on the detent, each
+// followed by uiBounces reversals ulBounce_US apart. Forwards, A leads: 00 -> 10 -> 11 -> 01 -> 00.
+static void encoderScriptDetent(BenchEncoderScript& sScript, bool bForwards, unsigned long ulPeriod_US, uint8_t uiBounces, unsigned long ulBounce_US)
+{
+	static const uint8_t auiForwardPins[4] = { ENCODER_PIN_A, ENCODER_PIN_B, ENCODER_PIN_A, ENCODER_PIN_B };
+	static const bool abForwardLevels[4] = { true, true, false, false };
+	unsigned long ulStart_US = sScript.ulEnd_US;
+
+	for (uint8_t uiQuarter = 0; uiQuarter < 4; uiQuarter++)
+	{
+		// Backwards retraces the forwards transitions in reverse
+		uint8_t uiStep = bForwards ? uiQuarter : (3 - uiQuarter);
+		uint8_t uiPin = auiForwardPins[uiStep];
+		bool bLevel = bForwards ? abForwardLevels[uiStep] : !abForwardLevels[uiStep];
+		unsigned long ulTime_US = ulStart_US + ((uiQuarter + 1) * ulPeriod_US) / 4 - (2 * uiBounces * ulBounce_US);
+
+		sScript.aEdges.push_back({ ulTime_US, uiPin, bLevel });
+
+		for (uint8_t uiBounce = 0; uiBounce < uiBounces; uiBounce++)
+		{
+			sScript.aEdges.push_back({ ulTime_US += ulBounce_US, uiPin, !bLevel });
+			sScript.aEdges.push_back({ ulTime_US += ulBounce_US, uiPin, bLevel });
+		}
+	}
+
+	sScript.lDetents += bForwards ? 1 : -1;
+	sScript.ulEnd_US = ulStart_US + ulPeriod_US;
+}
+
+// Runs of 1 to 30 detents, each run in a random direction at a random speed, with a pause after each run
+static BenchEncoderScript buildEncoderScript(uint32_t uiSeed, unsigned long ulMinPeriod_US, unsigned long ulMaxPeriod_US, uint8_t uiMaxBounces)
+{
+	BenchRandom cRandom(uiSeed);
+	BenchEncoderScript sScript;
+
+	sScript.lDetents = 0;
+	sScript.ulEnd_US = 10000;
+
+	for (unsigned long ulTurn = 0; ulTurn < ENCODER_TURNS; ulTurn++)
+	{
+		bool bForwards = cRandom.range(0, 1) != 0;
+		unsigned long ulDetents = cRandom.range(1, 30);
+		unsigned long ulPeriod_US = cRandom.range(ulMinPeriod_US, ulMaxPeriod_US);
+
+		for (unsigned long ulDetent = 0; ulDetent < ulDetents; ulDetent++)
+		{
+			uint8_t uiBounces = (uint8_t)cRandom.range(0, uiMaxBounces);
+
+			// Bounce takes up to a quarter of each transition's time
+			encoderScriptDetent(sScript, bForwards, ulPeriod_US, uiBounces, ulPeriod_US / (32 * (uiMaxBounces + 1)));
+		}
+
+		sScript.ulEnd_US += cRandom.range(10000, 100000);
+	}
+
+	return sScript;
+}
+
+// Plays a script into an encoder polled every ulPoll_US. Returns the final position.
+static long playEncoderPolled(AcksenButtonEncoder& cEncoder, const BenchEncoderScript& sScript, unsigned long ulPoll_US)
+{
+	size_t uiNext = 0;
+
+	for (unsigned long ulNow_US = 0; ulNow_US <= sScript.ulEnd_US; ulNow_US += ulPoll_US)
+	{
+		while ((uiNext < sScript.aEdges.size()) && (sScript.aEdges[uiNext].ulTime_US <= ulNow_US))
+		{
+			AcksenButtonHost::setPin(sScript.aEdges[uiNext].uiPin, sScript.aEdges[uiNext].bLevel);
+			uiNext++;
+		}
+
+		AcksenButtonHost::setMicros(ulNow_US);
+		cEncoder.update();
+	}
+
+	return cEncoder.getPosition();
+}
+
+static std::atomic<unsigned long> ulEncoderUpdates(0);
+static std::atomic<bool> bEncoderDone(false);
+
+// Plays a script on the "ISR" thread, calling captureEdge() on every edge. Every 64 detents it waits for the main
+// loop to start a fresh update(), as no more than 127 detents may build up between updates.
+static void encoderIsrThread(AcksenButtonEncoder* pEncoder, const BenchEncoderScript* pScript)
+{
+	unsigned long ulTransitions = 0;
+
+	for (size_t i = 0; i < pScript->aEdges.size(); i++)
+	{
+		AcksenButtonHost::setMicros(pScript->aEdges[i].ulTime_US);
+		AcksenButtonHost::setPin(pScript->aEdges[i].uiPin, pScript->aEdges[i].bLevel);
+		pEncoder->captureEdge();
+
+		// A transition has settled once the next edge is on the other pin
+		bool bSettled = ((i + 1) == pScript->aEdges.size()) || (pScript->aEdges[i + 1].uiPin != pScript->aEdges[i].uiPin);
+
+		if (bSettled && ((++ulTransitions % 256) == 0))
+		{
+			unsigned long ulUpdates = ulEncoderUpdates.load();
+
+			while (ulEncoderUpdates.load() < ulUpdates + 2)
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	bEncoderDone = true;
+}
+
+static void printEncoderResult(const char* szCase, long lPosition, long lExpected, uint8_t uiErrors)
+{
+	printf("%-12s %-22s position %ld/%ld, %u errors, %lu mismatches\n", "encoder", szCase, lPosition, lExpected, (unsigned)uiErrors,
+		(unsigned long)((lPosition != lExpected) || (uiErrors != 0)));
+}
+
+static void benchEncoder()
+{
+	BenchEncoderScript sScript = buildEncoderScript(0xE4C0, 2000, 60000, 3);
+
+	// Polled
+	{
+		AcksenButtonHost::reset();
+
+		AcksenButtonEncoder cEncoder(ENCODER_PIN_A, ENCODER_PIN_B, ACKSEN_BUTTON_MODE_NORMAL, INPUT_PULLUP);
+		long lPosition = playEncoderPolled(cEncoder, sScript, ENCODER_POLL_US);
+
+		printEncoderResult("polled", lPosition, sScript.lDetents, cEncoder.getErrorCount());
+	}
+
+	// Decoded on every edge, and collected every ENCODER_UPDATE_MS - with a push switch, pressed for one second in
+	// every four, sharing an event queue
+	{
+		AcksenButtonHost::reset();
+
+		AcksenButton cSwitch(ENCODER_SWITCH_PIN, ACKSEN_BUTTON_MODE_NORMAL, BENCH_DEBOUNCE_INTERVAL, INPUT);
+		AcksenButtonEncoder cEncoder(ENCODER_PIN_A, ENCODER_PIN_B, ACKSEN_BUTTON_MODE_NORMAL, INPUT_PULLUP);
+		AcksenButtonEventQueue cQueue;
+		unsigned long ulNextUpdate_US = 0;
+		long lEventDetents = 0;
+		unsigned long ulPresses = 0;
+		unsigned long ulReportedPresses = 0;
+		bool bSwitch = false;
+
+		cEncoder.setSwitch(&cSwitch);
+		cEncoder.setEdgeCapture(true);
+		cEncoder.setEventQueue(&cQueue);
+		cSwitch.setEventQueue(&cQueue);
+
+		for (size_t i = 0; i <= sScript.aEdges.size(); i++)
+		{
+			unsigned long ulEdge_US = (i < sScript.aEdges.size()) ? sScript.aEdges[i].ulTime_US : sScript.ulEnd_US;
+
+			while (ulNextUpdate_US <= ulEdge_US)
+			{
+				AcksenButtonEvent sEvent;
+				bool bPressed = ((ulNextUpdate_US / 1000000) % 4) == 3;
+
+				ulPresses += (bPressed && !bSwitch);
+				bSwitch = bPressed;
+
+				AcksenButtonHost::setMicros(ulNextUpdate_US);
+				AcksenButtonHost::setPin(ENCODER_SWITCH_PIN, bPressed);
+				cEncoder.update();
+
+				while (cQueue.pop(sEvent))
+				{
+					lEventDetents += (sEvent.uiType == ACKSEN_BUTTON_EVENT_CLOCKWISE) ? 1 : ((sEvent.uiType == ACKSEN_BUTTON_EVENT_ANTICLOCKWISE) ? -1 : 0);
+					ulReportedPresses += (sEvent.uiType == ACKSEN_BUTTON_EVENT_PRESSED);
+				}
+
+				ulNextUpdate_US += ENCODER_UPDATE_MS * 1000;
+			}
+
+			if (i < sScript.aEdges.size())
+			{
+				AcksenButtonHost::setMicros(ulEdge_US);
+				AcksenButtonHost::setPin(sScript.aEdges[i].uiPin, sScript.aEdges[i].bLevel);
+				cEncoder.captureEdge();
+			}
+		}
+
+		printEncoderResult("interrupt", cEncoder.getPosition(), sScript.lDetents, cEncoder.getErrorCount());
+		printf("%-12s %-22s events %ld/%ld detents, %lu/%lu presses, %u overflows, %lu mismatches\n", "encoder", "interrupt, events",
+			lEventDetents, sScript.lDetents, ulReportedPresses, ulPresses, (unsigned)cQueue.getOverflowCount(),
+			(unsigned long)((lEventDetents != sScript.lDetents) || (ulReportedPresses != ulPresses) || (cQueue.getOverflowCount() != 0)));
+		
+		// update() refreshes the switch from millis(), so a switch in the microsecond time base is refused, and the
+		// switch already attached is kept
+		AcksenButton cMicrosSwitch(ENCODER_SWITCH_PIN, ACKSEN_BUTTON_MODE_NORMAL, BENCH_DEBOUNCE_INTERVAL, INPUT);
+		
+		cMicrosSwitch.setTimeBase(ACKSEN_BUTTON_TIME_MICROS);
+		
+		bool bMicrosAttached = cEncoder.setSwitch(&cMicrosSwitch);
+		
+		printf("%-12s %-22s microsecond switch %s, %lu mismatches\n", "encoder", "switch time base", bMicrosAttached ? "attached" : "refused",
+			(unsigned long)(bMicrosAttached || (cEncoder.getSwitch() != &cSwitch)));
+	}
+
+	// Decoded by a second thread standing in for the ISR
+	{
+		AcksenButtonHost::reset();
+
+		AcksenButtonEncoder cEncoder(ENCODER_PIN_A, ENCODER_PIN_B, ACKSEN_BUTTON_MODE_NORMAL, INPUT_PULLUP);
+
+		cEncoder.setEdgeCapture(true);
+		ulEncoderUpdates = 0;
+		bEncoderDone = false;
+
+		std::thread cIsr(encoderIsrThread, &cEncoder, &sScript);
+
+		while (!bEncoderDone)
+		{
+			cEncoder.update(0);
+			ulEncoderUpdates.fetch_add(1);
+			std::this_thread::yield();
+		}
+
+		cIsr.join();
+		cEncoder.update(0);
+
+		printEncoderResult("interrupt, thread", cEncoder.getPosition(), sScript.lDetents, cEncoder.getErrorCount());
+	}
+
+	// Accelerate mode: a fast turn (accelerated once it has lasted the initial offset delay), a slow turn (never
+	// accelerated), then a fast turn back
+	{
+		static const struct { bool bForwards; unsigned long ulDetents; unsigned long ulPeriod_MS; } asTurns[] =
+		{
+			{ true, 100, 10 }, { true, 20, 60 }, { false, 50, 15 }
+		};
+
+		AcksenButtonHost::reset();
+
+		AcksenButtonEncoder cEncoder(ENCODER_PIN_A, ENCODER_PIN_B, ACKSEN_BUTTON_MODE_ACCELERATE, INPUT_PULLUP);
+		BenchEncoderScript sTurns;
+		long lExpected = 0;
+
+		sTurns.lDetents = 0;
+		sTurns.ulEnd_US = 100000;
+
+		for (size_t t = 0; t < sizeof(asTurns) / sizeof(asTurns[0]); t++)
+		{
+			for (unsigned long d = 0; d < asTurns[t].ulDetents; d++)
+			{
+				// The turn starts at its first detent
+				bool bAccelerated = (asTurns[t].ulPeriod_MS < DEFAULT_ENCODER_ACCELERATION_INTERVAL) &&
+					(d * asTurns[t].ulPeriod_MS >= DEFAULT_ENCODER_ACCELERATION_INITIAL_OFFSET_INTERVAL);
+
+				encoderScriptDetent(sTurns, asTurns[t].bForwards, asTurns[t].ulPeriod_MS * 1000, 0, 0);
+				lExpected += (asTurns[t].bForwards ? 1 : -1) * (bAccelerated ? DEFAULT_ENCODER_ACCELERATION_STEPS : 1);
+			}
+
+			sTurns.ulEnd_US += 500000;
+		}
+
+		long lPosition = playEncoderPolled(cEncoder, sTurns, ENCODER_POLL_US);
+
+		printEncoderResult("accelerate", lPosition, lExpected, cEncoder.getErrorCount());
+	}
+
+	// Fastest steady turn a slow main loop keeps up with, polling
+	unsigned long ulFastest = 0;
+
+	for (unsigned long ulRate = 250; ulRate <= 4000; ulRate += 250)
+	{
+		AcksenButtonHost::reset();
+
+		AcksenButtonEncoder cEncoder(ENCODER_PIN_A, ENCODER_PIN_B, ACKSEN_BUTTON_MODE_NORMAL, INPUT_PULLUP);
+		BenchEncoderScript sFast = buildEncoderScript(0xFA57 + ulRate, 1000000 / ulRate, 1000000 / ulRate, 1);
+		long lPosition = playEncoderPolled(cEncoder, sFast, ENCODER_SLOW_POLL_US);
+
+		if ((lPosition != sFast.lDetents) || (cEncoder.getErrorCount() != 0))
+		{
+			break;
+		}
+
+		ulFastest = ulRate;
+	}
+
+	printf("%-12s %-22s keeps up to %lu detents/s with a %uus loop\n", "encoder", "polled, max rate", ulFastest, (unsigned)ENCODER_SLOW_POLL_US);
+
+	// Cost, with the pins moving a quarter-step on every call - the worst case
+	{
+		static const uint8_t auiStates[4] = { 0x00, 0x02, 0x03, 0x01 };
+
+		AcksenButtonHost::reset();
+
+		AcksenButtonEncoder cPolled(ENCODER_PIN_A, ENCODER_PIN_B, ACKSEN_BUTTON_MODE_ACCELERATE, INPUT_PULLUP);
+		AcksenButtonEncoder cCaptured(ENCODER_PIN_A, ENCODER_PIN_B, ACKSEN_BUTTON_MODE_ACCELERATE, INPUT_PULLUP);
+		double adNs[3];
+
+		cCaptured.setEdgeCapture(true);
+
+		// Case 2 only moves the pins, to remove their cost from the others
+		for (uint8_t uiCase = 0; uiCase < 3; uiCase++)
+		{
+			BenchClock::time_point tStart = BenchClock::now();
+
+			for (unsigned long ulCall = 1; ulCall <= ENCODER_COST_CALLS; ulCall++)
+			{
+				uint8_t uiState = auiStates[ulCall & 3];
+
+				AcksenButtonHost::setPin(ENCODER_PIN_A, (uiState & 0x02) != 0);
+				AcksenButtonHost::setPin(ENCODER_PIN_B, (uiState & 0x01) != 0);
+
+				if (uiCase == 0)
+				{
+					ulBenchSink += cPolled.update(ulCall);
+				}
+				else if (uiCase == 1)
+				{
+					cCaptured.captureEdge();
+				}
+			}
+
+			adNs[uiCase] = elapsedNs(tStart, BenchClock::now()) / ENCODER_COST_CALLS;
+		}
+
+		for (uint8_t uiCase = 0; uiCase < 2; uiCase++)
+		{
+			double dNs = adNs[uiCase] - adNs[2];
+
+			printf("%-12s %-22s %6u  %10.2f ns/call  %8.1f M detents/s max\n", "encoder", (uiCase == 0) ? "update()" : "captureEdge()", 1, dNs, 1.0e3 / (4 * dNs));
+		}
+	}
+}
+
+// ***********************************
+// Main
+// ***********************************
+
+struct BenchSuite
+{
+	const char* szName;
+	void (*pRun)();
+};
+
+static const BenchSuite aSuites[] =
+{
+	{ "refresh", benchRefresh },
+	{ "backend", benchBackend },
+	{ "bank", benchBank },
+	{ "static", benchStatic },
+	{ "compact", benchCompact },
+	{ "group", benchGroup },
+	{ "matrix", benchMatrix },
+	{ "shiftin", benchShiftIn },
+	{ "analog", benchAnalog },
+	{ "gesture", benchGesture },
+	{ "accel", benchAccel },
+	{ "instrument", benchInstrument },
+	{ "tickless", benchTickless },
+	{ "wheel", benchWheel },
+	{ "debounce", benchDebounce },
+	{ "events", benchEvents },
+	{ "capture", benchCapture },
+	{ "timebase", benchTimeBase },
+	{ "encoder", benchEncoder },
+};
+
+int main(int argc, char* argv[])
+{
+	printf("sizeof(AcksenButton) = %u bytes\n\n", (unsigned)sizeof(AcksenButton));
+	printf("%-12s %-22s %6s  %18s  %16s\n", "suite", "case", "btns", "cost", "rate");
+
+	for (size_t s = 0; s < sizeof(aSuites) / sizeof(aSuites[0]); s++)
+	{
+		bool bRun = (argc < 2);
+
+		for (int a = 1; a < argc; a++)
+		{
+			if (strcmp(argv[a], aSuites[s].szName) == 0)
+			{
+				bRun = true;
+			}
+		}
+
+		if (bRun)
+		{
+			aSuites[s].pRun();
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,646 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+
+/*
+Tool:			replay
+Library:		AcksenButton
+
+Description:
+Replays a binary trace written by AcksenButtonTraceRecorder (see AcksenButtonTrace.h) through AcksenButton, on the
+simulated clock, and checks that every event recorded on the device is reported again, by the same button, at the
+same time. The trace is streamed, so traces of any length can be replayed, and the replay rate is reported.
+
+Unless the trace holds refresh records, buttons are refreshed as if every millisecond, but only at the times their
+next deadline or an input change requires - which gives exactly the same events. Buttons using the Integrator or
+Majority strategies sample on a fixed grid while refreshed every millisecond, so when idle they skip ahead to a
+sample time on that grid.
+
+--generate records a synthetic trace of 16 buttons, covering every mode and debounce strategy, with random bouncy
+presses, through the same recorder a sketch would use. With a loop period above 1 millisecond, the buttons are only
+refreshed once per period, and the trace holds refresh records. With 'micros', the buttons are timed in microseconds
+(see AcksenButton::setTimeBase()), bounce for under a millisecond, and the loop period is in microseconds. With
+'mixed', the same, but the even channels are timed in milliseconds.
+
+Buttons are rebuilt in the time base recorded in their config records, and each is refreshed on its own clock.
+
+Usage:			./replay <trace>				Replay a trace ('-' reads standard input)
+				./replay --generate <trace> [presses] [loop] [micros|mixed]
+												Record a synthetic trace with the given number of presses per
+												button (default 10000) and main loop period (default 1 millisecond),
+												optionally in the microsecond time base
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#include "AcksenButton.h"
+#include "AcksenButtonTrace.h"
+#include "AcksenButtonHost.h"
+
+#if !ACKSEN_BUTTON_TRACE
+#error "replay must be built with ACKSEN_BUTTON_TRACE=1 (see Makefile)"
+#endif
+
+// ***********************************
+// Constants
+// ***********************************
+#define REPLAY_BUFFER_SIZE				65536			// Bytes read from the trace at a time
+#define REPLAY_REPORTED_MISMATCHES		10				// Mismatches printed in full, before only being counted
+
+#define GENERATE_DEFAULT_PRESSES		10000			// Presses per button
+#define GENERATE_START_MS				1000			// Time the synthetic trace starts
+#define GENERATE_DEBOUNCE_INTERVAL		20				// Milliseconds
+#define GENERATE_DEBOUNCE_INTERVAL_US	1000			// Microseconds, in the microsecond time base
+
+
+// ***********************************
+// Clock
+// ***********************************
+
+// Sets the simulated clock, in either time base
+static void setTime(unsigned long ulNow, uint8_t uiTimeBase)
+{
+	if (uiTimeBase == ACKSEN_BUTTON_TIME_MICROS)
+	{
+		AcksenButtonHost::setMicros(ulNow);
+	}
+	else
+	{
+		AcksenButtonHost::setMillis(ulNow);
+	}
+}
+
+
+// ***********************************
+// Generate
+// ***********************************
+
+static std::vector<uint8_t> aGenerated;
+
+static void writeGenerated(uint8_t uiByte)
+{
+	aGenerated.push_back(uiByte);
+}
+
+struct GeneratePinEvent
+{
+	unsigned long ulTime_MS;
+	uint8_t uiPin;
+	bool bLevel;
+};
+
+static int generate(const char* szPath, unsigned long ulPresses, unsigned long ulLoop, uint8_t uiTimeBase, bool bMixed)
+{
+	
+	// Times are in the clock's time base, and in a mixed trace the even channels are timed in milliseconds
+	bool bMicros = (uiTimeBase == ACKSEN_BUTTON_TIME_MICROS);
+	unsigned long ulScale = bMicros ? 1000 : 1;
+	unsigned long ulStart = GENERATE_START_MS * ulScale;
+	
+	AcksenButtonHost::reset();
+	setTime(ulStart, uiTimeBase);
+	
+	// Each button's presses - a random gap, a random hold, and up to 6 bounces at each end (under a millisecond each
+	// in the microsecond time base)
+	std::vector<GeneratePinEvent> aSchedule;
+	uint32_t uiRandom = 0x2545F491;
+	
+	auto range = [&](unsigned long ulMin, unsigned long ulMax)
+	{
+		uiRandom ^= uiRandom << 13;
+		uiRandom ^= uiRandom >> 17;
+		uiRandom ^= uiRandom << 5;
+		
+		return ulMin + (uiRandom % (ulMax - ulMin + 1));
+	};
+	
+	for (uint8_t uiPin = 0; uiPin < ACKSEN_BUTTON_TRACE_CHANNELS; uiPin++)
+	{
+		unsigned long ulTime = ulStart;
+		
+		for (unsigned long p = 0; p < ulPresses * 2; p++)
+		{
+			bool bLevel = (p % 2) == 0;
+			
+			ulTime += (bLevel ? range(30, 1500) : range(10, 4000)) * ulScale;
+			
+			for (unsigned long ulBounce = range(0, 3); ulBounce > 0; ulBounce--)
+			{
+				aSchedule.push_back({ ulTime, uiPin, bLevel });
+				ulTime += bMicros ? range(20, 400) : range(1, 3);
+				aSchedule.push_back({ ulTime, uiPin, !bLevel });
+				ulTime += bMicros ? range(20, 400) : range(1, 3);
+			}
+			
+			aSchedule.push_back({ ulTime, uiPin, bLevel });
+		}
+	}
+	
+	std::stable_sort(aSchedule.begin(), aSchedule.end(), [](const GeneratePinEvent& a, const GeneratePinEvent& b) { return a.ulTime_MS < b.ulTime_MS; });
+	
+	// Every mode against every debounce strategy, in turn
+	AcksenButtonTraceRecorder cRecorder(writeGenerated);
+	std::vector<AcksenButton> aButtons;
+	
+	cRecorder.begin((ulLoop > 1) ? ACKSEN_BUTTON_TRACE_FLAG_REFRESHES : 0);
+	aButtons.reserve(ACKSEN_BUTTON_TRACE_CHANNELS);
+	
+	for (uint8_t uiPin = 0; uiPin < ACKSEN_BUTTON_TRACE_CHANNELS; uiPin++)
+	{
+		bool bPinMicros = bMicros && !(bMixed && ((uiPin % 2) == 0));
+		unsigned long ulPinScale = bPinMicros ? 1000 : 1;
+		
+		aButtons.push_back(AcksenButton(uiPin, uiPin % 4, GENERATE_DEBOUNCE_INTERVAL, INPUT));
+		
+		aButtons[uiPin].setTimeBase(bPinMicros ? ACKSEN_BUTTON_TIME_MICROS : ACKSEN_BUTTON_TIME_MILLIS);
+		aButtons[uiPin].setDebounceInterval(bPinMicros ? GENERATE_DEBOUNCE_INTERVAL_US : GENERATE_DEBOUNCE_INTERVAL);
+		aButtons[uiPin].setLongPressInterval(800 * ulPinScale);
+		aButtons[uiPin].setRepeatInitialOffsetDelay(600 * ulPinScale);
+		aButtons[uiPin].setRepeatPressesInterval(200 * ulPinScale);
+		aButtons[uiPin].setAccelerationInitialOffsetDelay(1500 * ulPinScale);
+		aButtons[uiPin].setAccelerationPressesInterval(50 * ulPinScale);
+		aButtons[uiPin].setDebounceStrategy(uiPin % 5);
+	}
+	
+	// Channels are attached once the buttons are in place, as setTraceRecorder() keeps a pointer
+	for (uint8_t uiPin = 0; uiPin < ACKSEN_BUTTON_TRACE_CHANNELS; uiPin++)
+	{
+		aButtons[uiPin].setTraceRecorder(&cRecorder, uiPin);
+	}
+	
+	size_t uiNext = 0;
+	unsigned long ulEnd = aSchedule.back().ulTime_MS + 5000 * ulScale;
+	
+	// The buttons only see the pins when refreshed, so the clock steps a loop period at a time
+	for (unsigned long ulNow = ulStart; ulNow < ulEnd; ulNow += ulLoop)
+	{
+		setTime(ulNow, uiTimeBase);
+		
+		for (; (uiNext < aSchedule.size()) && (aSchedule[uiNext].ulTime_MS <= ulNow); uiNext++)
+		{
+			AcksenButtonHost::setPin(aSchedule[uiNext].uiPin, aSchedule[uiNext].bLevel);
+		}
+		
+		// Each button reads its own clock
+		for (uint8_t uiPin = 0; uiPin < ACKSEN_BUTTON_TRACE_CHANNELS; uiPin++)
+		{
+			aButtons[uiPin].refreshStatus();
+		}
+		
+		if (!bMicros || bMixed)
+		{
+			cRecorder.recordRefresh(AcksenButtonHAL::getMillis(), ACKSEN_BUTTON_TIME_MILLIS);
+		}
+		
+		if (bMicros)
+		{
+			cRecorder.recordRefresh(AcksenButtonHAL::getMicros(), ACKSEN_BUTTON_TIME_MICROS);
+		}
+	}
+	
+	FILE* pFile = fopen(szPath, "wb");
+	
+	if ((pFile == NULL) || (fwrite(aGenerated.data(), 1, aGenerated.size(), pFile) != aGenerated.size()) || (fclose(pFile) != 0))
+	{
+		fprintf(stderr, "replay: cannot write %s\n", szPath);
+		return 1;
+	}
+	
+	printf("%s: %lu bytes, %lu edges over %.1f hours, %lu-%s loop\n", szPath, (unsigned long)aGenerated.size(),
+		(unsigned long)aSchedule.size(), (double)(ulEnd - ulStart) / ulScale / 3600000.0, ulLoop, bMicros ? "microsecond" : "millisecond");
+	
+	return 0;
+	
+}
+
+
+// ***********************************
+// Replay
+// ***********************************
+
+struct ReplayChannel
+{
+	AcksenButton* pButton = NULL;
+	uint8_t uiTimeBase = ACKSEN_BUTTON_TIME_MILLIS;	// Clock the button, and its records, are timed on
+	unsigned long ulNext_MS = 0;					// Next time to refresh, when the trace has no refresh records
+	bool bIdle = false;								// No refresh is needed until the input changes
+	unsigned long ulSamplePeriod_MS = 0;			// Integrator and Majority strategies - time between samples, otherwise 0
+	unsigned long ulSampleTimer_MS = 0;				// Time of the last sample, following AcksenButton::checkSampledDebounce()
+	AcksenButtonEventQueue cQueue;
+	std::deque<AcksenButtonEvent> aExpected;
+};
+
+static ReplayChannel asChannels[ACKSEN_BUTTON_TRACE_CHANNELS];
+
+static unsigned long ulReplayRefreshes;
+static unsigned long ulReplayMismatches;
+static unsigned long ulReplayUnexpected;
+
+static const char* eventName(uint8_t uiType)
+{
+	switch (uiType)
+	{
+		case ACKSEN_BUTTON_EVENT_PRESSED:	return "pressed";
+		case ACKSEN_BUTTON_EVENT_RELEASED:	return "released";
+		case ACKSEN_BUTTON_EVENT_LONGPRESS:	return "long press";
+		case ACKSEN_BUTTON_EVENT_REPEAT:	return "repeat";
+		default:							return "?";
+	}
+}
+
+static void reportMismatch(uint8_t uiChannel, const AcksenButtonEvent* psExpected, const AcksenButtonEvent* psReplayed)
+{
+	if (ulReplayMismatches + ulReplayUnexpected > REPLAY_REPORTED_MISMATCHES)
+	{
+		return;
+	}
+	
+	printf("channel %u: recorded ", uiChannel);
+	
+	if (psExpected != NULL)
+	{
+		printf("%s at %lu", eventName(psExpected->uiType), psExpected->ulTimestamp_MS);
+	}
+	else
+	{
+		printf("nothing");
+	}
+	
+	printf(", replayed %s at %lu\n", eventName(psReplayed->uiType), psReplayed->ulTimestamp_MS);
+}
+
+// Refreshes a button, and checks the events it reports against the trace
+static void refreshChannel(uint8_t uiChannel, unsigned long ulNow_MS)
+{
+	
+	ReplayChannel& sChannel = asChannels[uiChannel];
+	AcksenButtonEvent sEvent;
+	
+	setTime(ulNow_MS, sChannel.uiTimeBase);
+	ulReplayRefreshes++;
+	
+	sChannel.pButton->refreshStatus(ulNow_MS);
+	
+	if ((sChannel.ulSamplePeriod_MS != 0) && (ulNow_MS - sChannel.ulSampleTimer_MS >= sChannel.ulSamplePeriod_MS))
+	{
+		sChannel.ulSampleTimer_MS += sChannel.ulSamplePeriod_MS;
+		
+		if (ulNow_MS - sChannel.ulSampleTimer_MS >= sChannel.ulSamplePeriod_MS)
+		{
+			sChannel.ulSampleTimer_MS = ulNow_MS;
+		}
+	}
+	
+	while (sChannel.pButton->pollEvent(sEvent))
+	{
+		if (sChannel.aExpected.empty())
+		{
+			ulReplayUnexpected++;
+			reportMismatch(uiChannel, NULL, &sEvent);
+			continue;
+		}
+		
+		const AcksenButtonEvent& sExpected = sChannel.aExpected.front();
+		
+		if ((sExpected.uiType != sEvent.uiType) || (sExpected.ulTimestamp_MS != sEvent.ulTimestamp_MS))
+		{
+			ulReplayMismatches++;
+			reportMismatch(uiChannel, &sExpected, &sEvent);
+		}
+		
+		sChannel.aExpected.pop_front();
+	}
+	
+}
+
+// Refreshes every button in a time base at a refresh record
+static void refreshAll(unsigned long ulNow_MS, uint8_t uiTimeBase)
+{
+	for (uint8_t uiChannel = 0; uiChannel < ACKSEN_BUTTON_TRACE_CHANNELS; uiChannel++)
+	{
+		if ((asChannels[uiChannel].pButton != NULL) && (asChannels[uiChannel].uiTimeBase == uiTimeBase))
+		{
+			refreshChannel(uiChannel, ulNow_MS);
+		}
+	}
+}
+
+// Refreshes every button in a time base up to (not including) ulUntil_MS, skipping times at which a button has nothing
+// to do - until its input changes, if it has no deadline
+static void refreshUntil(unsigned long ulUntil_MS, uint8_t uiTimeBase)
+{
+	
+	for (uint8_t uiChannel = 0; uiChannel < ACKSEN_BUTTON_TRACE_CHANNELS; uiChannel++)
+	{
+		ReplayChannel& sChannel = asChannels[uiChannel];
+		
+		if ((sChannel.pButton == NULL) || sChannel.bIdle || (sChannel.uiTimeBase != uiTimeBase))
+		{
+			continue;
+		}
+		
+		while (acksenButtonTimeBefore(sChannel.ulNext_MS, ulUntil_MS))
+		{
+			refreshChannel(uiChannel, sChannel.ulNext_MS);
+			
+			unsigned long ulWake_MS;
+			
+			if (!sChannel.pButton->getNextDeadline(ulWake_MS))
+			{
+				sChannel.bIdle = true;
+				break;
+			}
+			
+			// A sampled button must not miss a sample, unless it lands back on the sample grid (the samples
+			// skipped would all have read the same settled level)
+			unsigned long ulSinceSample_MS = ulWake_MS - sChannel.ulSampleTimer_MS;
+			
+			if ((sChannel.ulSamplePeriod_MS != 0) && (ulSinceSample_MS > sChannel.ulSamplePeriod_MS))
+			{
+				ulWake_MS -= ulSinceSample_MS % sChannel.ulSamplePeriod_MS;
+			}
+			
+			sChannel.ulNext_MS = acksenButtonTimeBefore(sChannel.ulNext_MS, ulWake_MS) ? ulWake_MS : sChannel.ulNext_MS + 1;
+		}
+	}
+	
+}
+
+// Brings forward a button's next refresh when its input changes at ulEdge_MS. Call before the pin is set.
+static void wakeChannel(uint8_t uiChannel, unsigned long ulEdge_MS)
+{
+	
+	ReplayChannel& sChannel = asChannels[uiChannel];
+	
+	if ((sChannel.pButton == NULL) || (!sChannel.bIdle && !acksenButtonTimeBefore(ulEdge_MS, sChannel.ulNext_MS)))
+	{
+		return;
+	}
+	
+	sChannel.bIdle = false;
+	sChannel.ulNext_MS = ulEdge_MS;
+	
+	// A sampled button first catches up to the last sample time on its grid, while the input is unchanged
+	if (sChannel.ulSamplePeriod_MS != 0)
+	{
+		unsigned long ulSinceSample_MS = ulEdge_MS - 1 - sChannel.ulSampleTimer_MS;
+		
+		if (ulSinceSample_MS >= sChannel.ulSamplePeriod_MS)
+		{
+			refreshChannel(uiChannel, ulEdge_MS - 1 - (ulSinceSample_MS % sChannel.ulSamplePeriod_MS));
+		}
+	}
+	
+}
+
+static void configure(const AcksenButtonTraceRecord& sRecord)
+{
+	
+	const AcksenButtonTraceConfig& sConfig = sRecord.sConfig;
+	ReplayChannel& sChannel = asChannels[sRecord.uiChannel];
+	
+	delete sChannel.pButton;
+	
+	// Created with the same state, in the same time base, and with the same time since its last change, as on the
+	// device. setTimeBase() restarts the timers from the present time.
+	sChannel.uiTimeBase = sConfig.uiTimeBase;
+	
+	AcksenButtonHost::setPin(sRecord.uiChannel, sRecord.uiData != 0);
+	setTime(sRecord.ulTimestamp_MS - sConfig.ulAge_MS, sConfig.uiTimeBase);
+	
+	sChannel.pButton = new AcksenButton(sRecord.uiChannel, sConfig.uiMode, sConfig.ulDebounceInterval_MS, INPUT);
+	sChannel.pButton->setTimeBase(sConfig.uiTimeBase);
+	sChannel.pButton->setDebounceInterval(sConfig.ulDebounceInterval_MS);
+	
+	setTime(sRecord.ulTimestamp_MS, sConfig.uiTimeBase);
+	
+	sChannel.pButton->setLongPressInterval(sConfig.ulLongPressInterval_MS);
+	sChannel.pButton->setRepeatPressesInterval(sConfig.ulRepeatPressesInterval_MS);
+	sChannel.pButton->setRepeatInitialOffsetDelay(sConfig.ulRepeatInitialOffsetDelay_MS);
+	sChannel.pButton->setAccelerationPressesInterval(sConfig.ulAccelerationPressesInterval_MS);
+	sChannel.pButton->setAccelerationInitialOffsetDelay(sConfig.ulAccelerationInitialOffsetDelay_MS);
+	sChannel.pButton->setAdaptiveDebounceBounds((uint16_t)sConfig.ulAdaptiveMinimum_MS, (uint16_t)sConfig.ulAdaptiveMaximum_MS);
+	sChannel.pButton->setDebounceSamples(sConfig.uiDebounceSamples);
+	sChannel.pButton->setEventQueue(&sChannel.cQueue);
+	
+	// setDebounceStrategy() sets the debounce timer one debounce interval before the present time
+	setTime(sRecord.ulTimestamp_MS - sConfig.ulDebounceTimerAge_MS + sConfig.ulDebounceInterval_MS, sConfig.uiTimeBase);
+	sChannel.pButton->setDebounceStrategy(sConfig.uiDebounceStrategy);
+	setTime(sRecord.ulTimestamp_MS, sConfig.uiTimeBase);
+	
+	sChannel.ulSamplePeriod_MS = 0;
+	sChannel.ulSampleTimer_MS = sRecord.ulTimestamp_MS - sConfig.ulDebounceTimerAge_MS;
+	
+	if ((sConfig.uiDebounceStrategy == ACKSEN_BUTTON_DEBOUNCE_INTEGRATOR) || (sConfig.uiDebounceStrategy == ACKSEN_BUTTON_DEBOUNCE_MAJORITY))
+	{
+		unsigned long ulSamples = (sConfig.uiDebounceSamples < 1) ? 1 : sConfig.uiDebounceSamples;
+		
+		sChannel.ulSamplePeriod_MS = sConfig.ulDebounceInterval_MS / ulSamples;
+		sChannel.ulSamplePeriod_MS = (sChannel.ulSamplePeriod_MS > 0) ? sChannel.ulSamplePeriod_MS : 1;
+	}
+	
+	sChannel.ulNext_MS = sRecord.ulTimestamp_MS;
+	sChannel.bIdle = false;
+	sChannel.aExpected.clear();
+	
+}
+
+static int replay(const char* szPath)
+{
+	
+	FILE* pFile = (strcmp(szPath, "-") == 0) ? stdin : fopen(szPath, "rb");
+	
+	if (pFile == NULL)
+	{
+		fprintf(stderr, "replay: cannot open %s\n", szPath);
+		return 1;
+	}
+	
+	AcksenButtonHost::reset();
+	
+	AcksenButtonTraceReader cReader;
+	AcksenButtonTraceRecord sRecord;
+	std::vector<uint8_t> auiBuffer(REPLAY_BUFFER_SIZE);
+	size_t uiStart = 0;
+	size_t uiEnd = 0;
+	uint8_t uiStatus = ACKSEN_BUTTON_TRACE_MORE;
+	bool bRefreshRecords = false;
+	bool abClockUsed[2] = { false, false };		// Indexed by time base
+	unsigned long aulLast_MS[2] = { 0, 0 };
+	unsigned long ulBytes = 0;
+	unsigned long ulRecords = 0;
+	unsigned long ulEdges = 0;
+	unsigned long ulEvents = 0;
+	unsigned long ulButtons = 0;
+	
+	std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+	
+	while (true)
+	{
+		size_t uiUsed = 0;
+		
+		uiStatus = cReader.read(&auiBuffer[uiStart], uiEnd - uiStart, uiUsed, sRecord);
+		
+		if (uiStatus == ACKSEN_BUTTON_TRACE_MORE)
+		{
+			// Keep the partial record, and refill the rest of the buffer
+			memmove(&auiBuffer[0], &auiBuffer[uiStart], uiEnd - uiStart);
+			uiEnd -= uiStart;
+			uiStart = 0;
+			
+			size_t uiRead = fread(&auiBuffer[uiEnd], 1, auiBuffer.size() - uiEnd, pFile);
+			
+			if (uiRead == 0)
+			{
+				break;
+			}
+			
+			uiEnd += uiRead;
+			ulBytes += uiRead;
+			continue;
+		}
+		
+		if (uiStatus == ACKSEN_BUTTON_TRACE_ERROR)
+		{
+			break;
+		}
+		
+		uiStart += uiUsed;
+		ulRecords++;
+		
+		// Without refresh records, every time up to this record's is refreshed, on its clock, before it is applied
+		if (!bRefreshRecords && (sRecord.uiType != ACKSEN_BUTTON_TRACE_HEADER))
+		{
+			refreshUntil(sRecord.ulTimestamp_MS, sRecord.uiTimeBase);
+		}
+		
+		uint8_t uiClock = (sRecord.uiTimeBase == ACKSEN_BUTTON_TIME_MICROS) ? 1 : 0;
+		
+		if (!abClockUsed[uiClock] || acksenButtonTimeBefore(aulLast_MS[uiClock], sRecord.ulTimestamp_MS))
+		{
+			abClockUsed[uiClock] = true;
+			aulLast_MS[uiClock] = sRecord.ulTimestamp_MS;
+		}
+		
+		switch (sRecord.uiType)
+		{
+			case ACKSEN_BUTTON_TRACE_HEADER:
+				bRefreshRecords = (sRecord.uiData & ACKSEN_BUTTON_TRACE_FLAG_REFRESHES) != 0;
+				AcksenButtonHost::setMillis(sRecord.ulTimestamp_MS);
+				break;
+			
+			case ACKSEN_BUTTON_TRACE_CONFIG:
+				configure(sRecord);
+				ulButtons++;
+				break;
+			
+			case ACKSEN_BUTTON_TRACE_EDGE:
+				if (!bRefreshRecords)
+				{
+					wakeChannel(sRecord.uiChannel, sRecord.ulTimestamp_MS);
+				}
+				
+				AcksenButtonHost::setPin(sRecord.uiChannel, sRecord.uiData != 0);
+				ulEdges++;
+				break;
+			
+			case ACKSEN_BUTTON_TRACE_EVENT:
+				asChannels[sRecord.uiChannel].aExpected.push_back({ sRecord.ulTimestamp_MS, sRecord.uiData });
+				ulEvents++;
+				break;
+			
+			case ACKSEN_BUTTON_TRACE_REFRESH:
+				refreshAll(sRecord.ulTimestamp_MS, sRecord.uiTimeBase);
+				break;
+		}
+	}
+	
+	// The last millisecond (or microsecond) of the trace
+	if (!bRefreshRecords)
+	{
+		refreshUntil(aulLast_MS[0] + 1, ACKSEN_BUTTON_TIME_MILLIS);
+		refreshUntil(aulLast_MS[1] + 1, ACKSEN_BUTTON_TIME_MICROS);
+	}
+	
+	std::chrono::steady_clock::time_point tEnd = std::chrono::steady_clock::now();
+	double dSeconds = std::chrono::duration_cast<std::chrono::nanoseconds>(tEnd - tStart).count() / 1.0e9;
+	
+	if (pFile != stdin)
+	{
+		fclose(pFile);
+	}
+	
+	unsigned long ulMissed = 0;
+	
+	for (uint8_t uiChannel = 0; uiChannel < ACKSEN_BUTTON_TRACE_CHANNELS; uiChannel++)
+	{
+		ulMissed += asChannels[uiChannel].aExpected.size();
+		delete asChannels[uiChannel].pButton;
+	}
+	
+	printf("%s: %lu bytes, %lu records (%lu edges, %lu events), %lu buttons, %.2f bytes/edge\n", szPath, ulBytes, ulRecords,
+		ulEdges, ulEvents, ulButtons, ulEdges ? (double)ulBytes / ulEdges : 0.0);
+	printf("replayed in %.3f s: %.2f M records/s, %.2f M events/s, %lu refreshes\n", dSeconds, ulRecords / dSeconds / 1.0e6,
+		ulEvents / dSeconds / 1.0e6, ulReplayRefreshes);
+	
+	if (uiStatus == ACKSEN_BUTTON_TRACE_ERROR)
+	{
+		printf("invalid trace after %lu records\n", ulRecords);
+	}
+	else if (uiEnd != uiStart)
+	{
+		printf("trace ends part way through a record\n");
+	}
+	
+	printf("%lu mismatches, %lu missed, %lu unexpected\n", ulReplayMismatches, ulMissed, ulReplayUnexpected);
+	
+	return ((uiStatus == ACKSEN_BUTTON_TRACE_ERROR) || (uiEnd != uiStart) || ulReplayMismatches || ulMissed || ulReplayUnexpected) ? 1 : 0;
+	
+}
+
+
+// ***********************************
+// Main
+// ***********************************
+
+int main(int argc, char* argv[])
+{
+	
+	if ((argc >= 3) && (strcmp(argv[1], "--generate") == 0))
+	{
+		unsigned long ulPresses = (argc >= 4) ? strtoul(argv[3], NULL, 10) : GENERATE_DEFAULT_PRESSES;
+		unsigned long ulLoop = (argc >= 5) ? strtoul(argv[4], NULL, 10) : 1;
+		bool bMixed = (argc >= 6) && (strcmp(argv[5], "mixed") == 0);
+		uint8_t uiTimeBase = (bMixed || ((argc >= 6) && (strcmp(argv[5], "micros") == 0))) ? ACKSEN_BUTTON_TIME_MICROS : ACKSEN_BUTTON_TIME_MILLIS;
+		
+		return generate(argv[2], ulPresses ? ulPresses : 1, ulLoop ? ulLoop : 1, uiTimeBase, bMixed);
+	}
+	
+	if (argc == 2)
+	{
+		return replay(argv[1]);
+	}
+	
+	fprintf(stderr, "Usage: %s <trace>\n       %s --generate <trace> [presses] [loop] [micros|mixed]\n", argv[0], argv[0]);
+	return 2;
+	
+}
@@ -0,0 +1,154 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+
+
+/*
+Tool:			size
+Library:		AcksenButton
+
+Description:
+Code and RAM size of a small sketch built with AcksenButton or with AcksenButtonStatic, for comparing the two (see
+"make size"). Each panel holds one button in each mode, polled every millisecond, with every event read. Build with
+SIZE_STATIC 0 or 1 to choose the class, and SIZE_PANELS 1 or 4 to separate the fixed cost from the cost per button.
+
+The sizes are those of a host build, with unused functions and data discarded by the linker. The host mock GPIO,
+clock and C++ runtime are the same in every build, so only the differences between builds are meaningful. Host code
+is larger than AVR code, and unsigned long and pointers are wider, so the differences indicate, rather than measure,
+the flash and RAM saved on an Arduino.
+*/
+
+#include "AcksenButtonHost.h"
+#include "AcksenButton.h"
+#include "AcksenButtonStatic.h"
+
+#ifndef SIZE_STATIC
+#define SIZE_STATIC					0
+#endif
+
+#ifndef SIZE_PANELS
+#define SIZE_PANELS					1
+#endif
+
+#if (SIZE_PANELS != 1) && (SIZE_PANELS != 4)
+#error "SIZE_PANELS must be 1 or 4"
+#endif
+
+#define SIZE_DEBOUNCE_INTERVAL		20		// Milliseconds
+#define SIZE_SCANS					10000
+
+#if SIZE_STATIC
+
+// Each button's pin is a template parameter, so every panel is its own set of types
+template <uint8_t PIN>
+class SizePanel
+{
+
+public:
+
+	SizePanel() : cNormal(INPUT), cLongPress(INPUT), cRepeat(INPUT), cAccelerate(INPUT) {}
+
+	unsigned long scan()
+	{
+		cNormal.refreshStatus();
+		cLongPress.refreshStatus();
+		cRepeat.refreshStatus();
+		cAccelerate.refreshStatus();
+
+		return cNormal.onPressed() + cNormal.onReleased() + cLongPress.onLongPress() + cRepeat.onPressed() + cAccelerate.onPressed();
+	}
+
+private:
+
+	AcksenButtonStatic<PIN, ACKSEN_BUTTON_MODE_NORMAL, SIZE_DEBOUNCE_INTERVAL> cNormal;
+	AcksenButtonStatic<PIN + 1, ACKSEN_BUTTON_MODE_LONGPRESS, SIZE_DEBOUNCE_INTERVAL> cLongPress;
+	AcksenButtonStatic<PIN + 2, ACKSEN_BUTTON_MODE_REPEAT, SIZE_DEBOUNCE_INTERVAL> cRepeat;
+	AcksenButtonStatic<PIN + 3, ACKSEN_BUTTON_MODE_ACCELERATE, SIZE_DEBOUNCE_INTERVAL> cAccelerate;
+
+};
+
+SizePanel<0> cPanel0;
+#if SIZE_PANELS == 4
+SizePanel<4> cPanel1;
+SizePanel<8> cPanel2;
+SizePanel<12> cPanel3;
+#endif
+
+#else
+
+class SizePanel
+{
+
+public:
+
+	SizePanel(uint8_t uiPin) :
+		cNormal(uiPin, ACKSEN_BUTTON_MODE_NORMAL, SIZE_DEBOUNCE_INTERVAL, INPUT),
+		cLongPress(uiPin + 1, ACKSEN_BUTTON_MODE_LONGPRESS, SIZE_DEBOUNCE_INTERVAL, INPUT),
+		cRepeat(uiPin + 2, ACKSEN_BUTTON_MODE_REPEAT, SIZE_DEBOUNCE_INTERVAL, INPUT),
+		cAccelerate(uiPin + 3, ACKSEN_BUTTON_MODE_ACCELERATE, SIZE_DEBOUNCE_INTERVAL, INPUT)
+	{
+	}
+
+	unsigned long scan()
+	{
+		cNormal.refreshStatus();
+		cLongPress.refreshStatus();
+		cRepeat.refreshStatus();
+		cAccelerate.refreshStatus();
+
+		return cNormal.onPressed() + cNormal.onReleased() + cLongPress.onLongPress() + cRepeat.onPressed() + cAccelerate.onPressed();
+	}
+
+private:
+
+	AcksenButton cNormal;
+	AcksenButton cLongPress;
+	AcksenButton cRepeat;
+	AcksenButton cAccelerate;
+
+};
+
+SizePanel cPanel0(0);
+#if SIZE_PANELS == 4
+SizePanel cPanel1(4);
+SizePanel cPanel2(8);
+SizePanel cPanel3(12);
+#endif
+
+#endif
+
+int main()
+{
+	unsigned long ulEvents = 0;
+
+	for (unsigned long ulScan = 0; ulScan < SIZE_SCANS; ulScan++)
+	{
+		AcksenButtonHost::advanceMillis(1);
+
+		// Press every button for a second in every two
+		for (uint8_t uiPin = 0; uiPin < 4 * SIZE_PANELS; uiPin++)
+		{
+			AcksenButtonHost::setPin(uiPin, ((ulScan / 1000) % 2) == 1);
+		}
+
+		ulEvents += cPanel0.scan();
+#if SIZE_PANELS == 4
+		ulEvents += cPanel1.scan() + cPanel2.scan() + cPanel3.scan();
+#endif
+	}
+
+	return (ulEvents == 0);
+}
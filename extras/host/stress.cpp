@@ -0,0 +1,295 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+
+/*
+Tool:			stress
+Library:		AcksenButton
+
+Description:
+Stress test of the scanner/consumer split (see AcksenButton::setEventChannel()), built against the mock GPIO and
+simulated clock in AcksenButtonHost.cpp.
+
+A scanner thread owns the buttons, the mock GPIO and the clock. It scans 64 buttons in every mode, with random
+bouncy presses, as fast as it can, publishing their events to one channel per consumer thread. Each consumer only
+pops its channel. It checks that each of its buttons' events arrive in a valid order (press, then any long presses
+or repeats, then release) with non-decreasing timestamps. At the end, each consumer's count of every button's
+events must match the scanner's own count.
+
+A scan publishes at most one event per button, so before each scan the scanner waits until every channel has room
+for one event from each of its buttons. No event should ever be dropped. If a consumer stops making progress (e.g.
+because published events never arrive), the run stops and fails.
+
+Build and run under ThreadSanitizer with "make tsan", which fails on any data race.
+
+Usage:			./stress [scans] [consumers]
+				Defaults to 2000000 simulated milliseconds and 4 consumer threads (4 to 8).
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "AcksenButton.h"
+#include "AcksenButtonGroup.h"
+#include "AcksenButtonHost.h"
+
+// ***********************************
+// Constants
+// ***********************************
+#define STRESS_BUTTONS					64
+#define STRESS_MIN_CONSUMERS			4				// So each channel has room for a scan of its buttons
+#define STRESS_MAX_CONSUMERS			8
+#define STRESS_DEFAULT_SCANS			2000000
+#define STRESS_DEFAULT_CONSUMERS		4
+#define STRESS_DEBOUNCE_INTERVAL		10				// Milliseconds
+#define STRESS_STALL_TIMEOUT_MS			2000			// Real time the scanner waits on a consumer, before the run fails
+
+
+// ***********************************
+// Consumer
+// ***********************************
+
+struct StressConsumer
+{
+	AcksenButtonEventChannel cChannel;
+	std::thread cThread;
+	std::atomic<unsigned long> ulConsumed{ 0 };		// Events popped, for the scanner to wait on
+	
+	// Owned by the consumer thread until it is joined
+	unsigned long aulEvents[STRESS_BUTTONS] = { 0 };
+	unsigned long ulOrderErrors = 0;
+	unsigned long ulIdErrors = 0;
+	unsigned long ulSpins = 0;
+};
+
+static std::atomic<bool> bScanning(true);
+
+static void consumerThread(StressConsumer* pConsumer, uint8_t uiConsumer, uint8_t uiConsumers)
+{
+	
+	bool abHeld[STRESS_BUTTONS] = { false };
+	unsigned long aulLast_MS[STRESS_BUTTONS] = { 0 };
+	AcksenButtonChannelEvent sEvent;
+	
+	while (true)
+	{
+		// Read the flag before the channel, so no event published before the scanner stopped is missed
+		bool bFinal = !bScanning.load(std::memory_order_acquire);
+		
+		while (pConsumer->cChannel.pop(sEvent))
+		{
+			uint8_t uiButton = sEvent.uiButtonId;
+			
+			if ((uiButton >= STRESS_BUTTONS) || ((uiButton % uiConsumers) != uiConsumer))
+			{
+				pConsumer->ulIdErrors++;
+				continue;
+			}
+			
+			bool bValid = (sEvent.uiType == ACKSEN_BUTTON_EVENT_PRESSED) ? !abHeld[uiButton] : abHeld[uiButton];
+			
+			if (!bValid || acksenButtonTimeBefore(sEvent.ulTimestamp_MS, aulLast_MS[uiButton]))
+			{
+				pConsumer->ulOrderErrors++;
+			}
+			
+			abHeld[uiButton] = (sEvent.uiType != ACKSEN_BUTTON_EVENT_RELEASED);
+			aulLast_MS[uiButton] = sEvent.ulTimestamp_MS;
+			pConsumer->aulEvents[uiButton]++;
+			pConsumer->ulConsumed.fetch_add(1, std::memory_order_release);
+		}
+		
+		if (bFinal)
+		{
+			break;
+		}
+		
+		pConsumer->ulSpins++;
+		std::this_thread::yield();
+	}
+	
+}
+
+
+// ***********************************
+// Main
+// ***********************************
+
+int main(int argc, char* argv[])
+{
+	
+	unsigned long ulScans = (argc >= 2) ? strtoul(argv[1], NULL, 10) : STRESS_DEFAULT_SCANS;
+	unsigned long ulConsumers = (argc >= 3) ? strtoul(argv[2], NULL, 10) : STRESS_DEFAULT_CONSUMERS;
+	
+	if ((ulScans == 0) || (ulConsumers < STRESS_MIN_CONSUMERS) || (ulConsumers > STRESS_MAX_CONSUMERS))
+	{
+		fprintf(stderr, "Usage: %s [scans] [consumers (%u to %u)]\n", argv[0], STRESS_MIN_CONSUMERS, STRESS_MAX_CONSUMERS);
+		return 2;
+	}
+	
+	uint8_t uiConsumers = (uint8_t)ulConsumers;
+	
+	AcksenButtonHost::reset();
+	
+	// Set up everything the consumers can see before they start
+	std::vector<AcksenButton> aButtons;
+	std::vector<AcksenButtonEventQueue> aQueues(STRESS_BUTTONS);
+	StressConsumer asConsumers[STRESS_MAX_CONSUMERS];
+	AcksenButtonGroup<STRESS_BUTTONS> cGroup;
+	
+	aButtons.reserve(STRESS_BUTTONS);
+	
+	for (uint8_t i = 0; i < STRESS_BUTTONS; i++)
+	{
+		aButtons.push_back(AcksenButton(i, i % 4, STRESS_DEBOUNCE_INTERVAL, INPUT));
+		aButtons[i].setLongPressInterval(300);
+		aButtons[i].setRepeatInitialOffsetDelay(200);
+		aButtons[i].setRepeatPressesInterval(50);
+		aButtons[i].setAccelerationInitialOffsetDelay(400);
+		aButtons[i].setAccelerationPressesInterval(5);
+		cGroup.add(&aButtons[i]);
+	}
+	
+	for (uint8_t i = 0; i < STRESS_BUTTONS; i++)
+	{
+		// The scanner keeps its own count of each button's events, through the button's event queue
+		aButtons[i].setEventQueue(&aQueues[i]);
+		aButtons[i].setEventChannel(&asConsumers[i % uiConsumers].cChannel, i);
+	}
+	
+	for (uint8_t c = 0; c < uiConsumers; c++)
+	{
+		asConsumers[c].cThread = std::thread(consumerThread, &asConsumers[c], c, uiConsumers);
+	}
+	
+	// Scanner - this thread. Each pin flips after a random 20-800 ms, with up to 3 ms of bounce.
+	unsigned long aulProduced[STRESS_BUTTONS] = { 0 };
+	unsigned long aulPublished[STRESS_MAX_CONSUMERS] = { 0 };
+	unsigned long ulWaits = 0;
+	bool bStalled = false;
+	unsigned long ulChannelButtons = (STRESS_BUTTONS + uiConsumers - 1) / uiConsumers;
+	unsigned long aulNextFlip_MS[STRESS_BUTTONS];
+	unsigned long aulLastFlip_MS[STRESS_BUTTONS] = { 0 };
+	bool abLevel[STRESS_BUTTONS] = { false };
+	uint32_t uiRandom = 0x9E3779B9;
+	
+	auto range = [&](unsigned long ulMin, unsigned long ulMax)
+	{
+		uiRandom ^= uiRandom << 13;
+		uiRandom ^= uiRandom >> 17;
+		uiRandom ^= uiRandom << 5;
+		
+		return ulMin + (uiRandom % (ulMax - ulMin + 1));
+	};
+	
+	for (uint8_t i = 0; i < STRESS_BUTTONS; i++)
+	{
+		aulNextFlip_MS[i] = range(1, 800);
+	}
+	
+	std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+	
+	for (unsigned long ulNow_MS = 1; (ulNow_MS <= ulScans) && !bStalled; ulNow_MS++)
+	{
+		AcksenButtonHost::setMillis(ulNow_MS);
+		
+		for (uint8_t c = 0; c < uiConsumers; c++)
+		{
+			std::chrono::steady_clock::time_point tWait = std::chrono::steady_clock::now();
+			
+			while (!bStalled && (aulPublished[c] - asConsumers[c].ulConsumed.load(std::memory_order_acquire) > ACKSEN_BUTTON_EVENT_CHANNEL_SIZE - 1 - ulChannelButtons))
+			{
+				ulWaits++;
+				std::this_thread::yield();
+				
+				bStalled = (std::chrono::steady_clock::now() - tWait) > std::chrono::milliseconds(STRESS_STALL_TIMEOUT_MS);
+			}
+		}
+		
+		for (uint8_t i = 0; i < STRESS_BUTTONS; i++)
+		{
+			if (ulNow_MS >= aulNextFlip_MS[i])
+			{
+				abLevel[i] = !abLevel[i];
+				aulLastFlip_MS[i] = ulNow_MS;
+				aulNextFlip_MS[i] = ulNow_MS + range(20, 800);
+			}
+			
+			// Bounce - at random, the opposite level, for the first few milliseconds after a flip
+			bool bBouncing = (ulNow_MS - aulLastFlip_MS[i] < 3) && (range(0, 1) == 0);
+			
+			AcksenButtonHost::setPin(i, abLevel[i] != bBouncing);
+		}
+		
+		cGroup.refreshAll(ulNow_MS);
+		
+		for (uint8_t i = 0; i < STRESS_BUTTONS; i++)
+		{
+			AcksenButtonEvent sEvent;
+			
+			while (aButtons[i].pollEvent(sEvent))
+			{
+				aulProduced[i]++;
+				aulPublished[i % uiConsumers]++;
+			}
+		}
+	}
+	
+	bScanning.store(false, std::memory_order_release);
+	
+	for (uint8_t c = 0; c < uiConsumers; c++)
+	{
+		asConsumers[c].cThread.join();
+	}
+	
+	std::chrono::steady_clock::time_point tEnd = std::chrono::steady_clock::now();
+	double dSeconds = std::chrono::duration_cast<std::chrono::nanoseconds>(tEnd - tStart).count() / 1.0e9;
+	
+	// Every event the scanner counted must have reached its consumer
+	unsigned long ulProduced = 0;
+	unsigned long ulConsumed = 0;
+	unsigned long ulDropped = 0;
+	unsigned long ulOrderErrors = 0;
+	unsigned long ulIdErrors = 0;
+	unsigned long ulCountErrors = 0;
+	
+	for (uint8_t c = 0; c < uiConsumers; c++)
+	{
+		for (uint8_t i = c; i < STRESS_BUTTONS; i += uiConsumers)
+		{
+			ulProduced += aulProduced[i];
+			ulConsumed += asConsumers[c].aulEvents[i];
+			ulCountErrors += (asConsumers[c].aulEvents[i] != aulProduced[i]);
+		}
+		
+		ulDropped += asConsumers[c].cChannel.getOverflowCount();
+		ulOrderErrors += asConsumers[c].ulOrderErrors;
+		ulIdErrors += asConsumers[c].ulIdErrors;
+	}
+	
+	printf("%lu scans of %u buttons, %u consumers, in %.3f s: %.0f scans/s, %.2f M events/s, scanner waited %lu times\n", ulScans,
+		STRESS_BUTTONS, uiConsumers, dSeconds, ulScans / dSeconds, ulProduced / dSeconds / 1.0e6, ulWaits);
+	printf("%lu events published, %lu consumed, %lu dropped\n", ulProduced, ulConsumed, ulDropped);
+	printf("%lu order errors, %lu id errors, %lu count errors%s\n", ulOrderErrors, ulIdErrors, ulCountErrors,
+		bStalled ? " - stalled waiting for a consumer" : "");
+	
+	return (ulOrderErrors || ulIdErrors || ulCountErrors || ulDropped || bStalled) ? 1 : 0;
+	
+}
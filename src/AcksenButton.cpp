@@ -43,32 +43,107 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 */
 /***********************************************************/
 
-// Acksen Button Library v1.3.0
+// Acksen Button Library v1.4.0
 
-#include "Arduino.h"
+#include "AcksenButtonHAL.h"
 #include "AcksenButton.h"
 
+#if ACKSEN_BUTTON_TRACE
+#include "AcksenButtonTrace.h"
+#endif
+
 AcksenButton::AcksenButton(uint8_t uiButtonPin, uint8_t uiButtonOperationMode, unsigned long ulDebounceInterval_MS, uint8_t uiButtonInputMode)
 {
 	
 	// Setup the I/O Button Pin
-	pinMode(uiButtonPin, uiButtonInputMode);
+	AcksenButtonHAL::setPinMode(uiButtonPin, uiButtonInputMode);
+	
+    this->uiButtonPin = uiButtonPin;
+	
+	// Read the pin's input register directly, where the platform allows (AVR by default) - otherwise digitalRead()
+	setInputBackend(ACKSEN_BUTTON_INPUT_PORT);
+	
+	initialise(uiButtonOperationMode, ulDebounceInterval_MS);
+	
+}
+
+AcksenButton::AcksenButton(const AcksenButtonVirtualInput& sInput, uint8_t uiButtonOperationMode, unsigned long ulDebounceInterval_MS)
+{
+	
+	uiButtonPin = ACKSEN_BUTTON_NO_PIN;
+	
+	pInputRegister = sInput.pInputRegister;
+	uiInputMask = sInput.uiInputMask;
+	
+	initialise(uiButtonOperationMode, ulDebounceInterval_MS);
+	
+}
+
+// Protected: Initialisation common to all constructors, once the input is set up
+void AcksenButton::initialise(uint8_t uiButtonOperationMode, unsigned long ulDebounceInterval_MS)
+{
+	
+	// Start in the default time base, with the default intervals converted to it
+	convertIntervals(ACKSEN_BUTTON_TIME_BASE);
 	
 	// Set the Debounce Interval
 	setDebounceInterval(ulDebounceInterval_MS);
 	
 	// Initialise internal variables
-	ulLastStatusUpdate_MS = millis();
-	bDebouncedButtonState = digitalRead(uiButtonPin);
+	ulLastStatusUpdate_MS = getTime();
+	bDebouncedButtonState = readInput();
 	
 	bLongPressRecorded = false;
 	bLongPressProcessed = false;
+	uiRepeatCount = 0;
 	
-    this->uiButtonPin = uiButtonPin;
+#if ACKSEN_BUTTON_INSTRUMENTATION
+	bInstrumentRawLevel = bDebouncedButtonState;
+	bInstrumentEdgePending = false;
+	ulInstrumentEdge_MS = ulLastStatusUpdate_MS;
+	ulInstrumentEvent_MS = ulLastStatusUpdate_MS;
+	ulInstrumentRefresh_MS = ulLastStatusUpdate_MS;
+	resetStats();
+#endif
 	
 	// Set the Button Mode
 	this->uiButtonOperationMode = uiButtonOperationMode;
 	
+#if ACKSEN_BUTTON_DEBOUNCE_STRATEGIES
+	// Set the Debounce Strategy
+	setDebounceStrategy(ACKSEN_BUTTON_DEBOUNCE_TIMESTAMP);
+#endif
+	
+}
+
+bool AcksenButton::setInputBackend(uint8_t uiInputBackend)
+{
+	
+	// Virtual ports have no pin to fall back on
+	if (uiButtonPin == ACKSEN_BUTTON_NO_PIN)
+	{
+		return false;
+	}
+	
+	if (uiInputBackend == ACKSEN_BUTTON_INPUT_PORT)
+	{
+		const volatile AcksenButtonPort_t* pRegister = AcksenButtonHAL::getInputRegister(uiButtonPin);
+		
+		if (pRegister == NULL)
+		{
+			return false;
+		}
+		
+		uiInputMask = AcksenButtonHAL::getPinBitMask(uiButtonPin);
+		pInputRegister = pRegister;
+	}
+	else
+	{
+		pInputRegister = NULL;
+	}
+	
+	return true;
+	
 }
 
 void AcksenButton::setDebounceInterval(unsigned long ulDebounceInterval_MS)
@@ -76,6 +151,148 @@ void AcksenButton::setDebounceInterval(unsigned long ulDebounceInterval_MS)
   this->ulDebounceInterval_MS = ulDebounceInterval_MS;
 }
 
+#if ACKSEN_BUTTON_DEBOUNCE_STRATEGIES
+
+void AcksenButton::setDebounceStrategy(uint8_t uiDebounceStrategy)
+{
+	
+	this->uiDebounceStrategy = uiDebounceStrategy;
+	
+	// Start from the debounced state, with the Lockout already expired
+	bLastRawLevel = bDebouncedButtonState;
+	ulDebounceTimer_MS = getTime() - ulDebounceInterval_MS;
+	resetDebounceHistory();
+	
+	// The Adaptive strategy starts from the configured interval, and learns from there
+	bAdaptiveConfirming = false;
+	uiLearnedDebounce_MS = (ulDebounceInterval_MS < uiAdaptiveMaximum_MS) ? ulDebounceInterval_MS : uiAdaptiveMaximum_MS;
+	
+	if (uiLearnedDebounce_MS < uiAdaptiveMinimum_MS)
+	{
+		uiLearnedDebounce_MS = uiAdaptiveMinimum_MS;
+	}
+	
+}
+
+void AcksenButton::setDebounceSamples(uint8_t uiDebounceSamples)
+{
+	
+	if (uiDebounceSamples < 1)
+	{
+		uiDebounceSamples = 1;
+	}
+	else if (uiDebounceSamples > ACKSEN_BUTTON_MAX_DEBOUNCE_SAMPLES)
+	{
+		uiDebounceSamples = ACKSEN_BUTTON_MAX_DEBOUNCE_SAMPLES;
+	}
+	
+	this->uiDebounceSamples = uiDebounceSamples;
+	
+	resetDebounceHistory();
+	
+}
+
+void AcksenButton::setAdaptiveDebounceBounds(uint16_t uiMinimum_MS, uint16_t uiMaximum_MS)
+{
+	
+	uiAdaptiveMinimum_MS = uiMinimum_MS;
+	uiAdaptiveMaximum_MS = (uiMaximum_MS > uiMinimum_MS) ? uiMaximum_MS : uiMinimum_MS;
+	
+	// Bring the present window within the new bounds
+	if (uiLearnedDebounce_MS < uiAdaptiveMinimum_MS)
+	{
+		uiLearnedDebounce_MS = uiAdaptiveMinimum_MS;
+	}
+	else if (uiLearnedDebounce_MS > uiAdaptiveMaximum_MS)
+	{
+		uiLearnedDebounce_MS = uiAdaptiveMaximum_MS;
+	}
+	
+}
+
+unsigned long AcksenButton::getLearnedDebounceInterval()
+{
+	return uiLearnedDebounce_MS;
+}
+
+#endif
+
+void AcksenButton::setTimeBase(uint8_t uiTimeBase)
+{
+	
+	if (uiTimeBase == this->uiTimeBase)
+	{
+		return;
+	}
+	
+	convertIntervals(uiTimeBase);
+	
+	// Times taken from the old clock mean nothing on the new one - restart the timers from now
+	unsigned long ulNow_MS = getTime();
+	
+	ulLastStatusUpdate_MS = ulNow_MS;
+	ulButtonOperationStart = ulNow_MS;
+	ulRepeatPressesPeriodEnd = ulNow_MS + ulRepeatInitialOffsetDelay_MS;
+	
+#if ACKSEN_BUTTON_EDGE_CAPTURE
+	ulRawStateChange_MS = ulNow_MS;
+#endif
+	
+#if ACKSEN_BUTTON_INSTRUMENTATION
+	ulInstrumentEdge_MS = ulNow_MS;
+	ulInstrumentEvent_MS = ulNow_MS;
+	ulInstrumentRefresh_MS = ulNow_MS;
+#endif
+	
+#if ACKSEN_BUTTON_DEBOUNCE_STRATEGIES
+	setDebounceStrategy(uiDebounceStrategy);
+#endif
+	
+}
+
+uint8_t AcksenButton::getTimeBase()
+{
+	return uiTimeBase;
+}
+
+// Converts one interval to another time base. Conversions to milliseconds round up, so that no interval
+// becomes shorter.
+static unsigned long convertInterval(unsigned long ulInterval, bool bToMicros)
+{
+	return bToMicros ? (ulInterval * 1000) : ((ulInterval + 999) / 1000);
+}
+
+// Protected: Converts every interval to another time base, and selects it. The 16-bit adaptive bounds saturate.
+// The learned window is not converted - setDebounceStrategy() restarts it from the debounce interval.
+void AcksenButton::convertIntervals(uint8_t uiTimeBase)
+{
+	
+	if (uiTimeBase == this->uiTimeBase)
+	{
+		return;
+	}
+	
+	bool bToMicros = (uiTimeBase == ACKSEN_BUTTON_TIME_MICROS);
+	
+	ulDebounceInterval_MS = convertInterval(ulDebounceInterval_MS, bToMicros);
+	ulLongPressInterval_MS = convertInterval(ulLongPressInterval_MS, bToMicros);
+	ulRepeatPressesInterval_MS = convertInterval(ulRepeatPressesInterval_MS, bToMicros);
+	ulRepeatInitialOffsetDelay_MS = convertInterval(ulRepeatInitialOffsetDelay_MS, bToMicros);
+	ulAccelerationInitialOffsetDelay_MS = convertInterval(ulAccelerationInitialOffsetDelay_MS, bToMicros);
+	ulAccelerationPressesInterval_MS = convertInterval(ulAccelerationPressesInterval_MS, bToMicros);
+	
+#if ACKSEN_BUTTON_DEBOUNCE_STRATEGIES
+	unsigned long ulAdaptiveMinimum_MS = convertInterval(uiAdaptiveMinimum_MS, bToMicros);
+	unsigned long ulAdaptiveMaximum_MS = convertInterval(uiAdaptiveMaximum_MS, bToMicros);
+	
+	uiAdaptiveMinimum_MS = (ulAdaptiveMinimum_MS < 0xFFFF) ? (uint16_t)ulAdaptiveMinimum_MS : 0xFFFF;
+	uiAdaptiveMaximum_MS = (ulAdaptiveMaximum_MS < 0xFFFF) ? (uint16_t)ulAdaptiveMaximum_MS : 0xFFFF;
+#endif
+	
+	this->uiTimeBase = uiTimeBase;
+	
+}
+
 void AcksenButton::setLongPressInterval(unsigned long ulLongPressInterval_MS)
 {
 	this->ulLongPressInterval_MS = ulLongPressInterval_MS;
@@ -101,6 +318,21 @@ void AcksenButton::setAccelerationInitialOffsetDelay(unsigned long ulAcceleratio
 	this->ulAccelerationInitialOffsetDelay_MS = ulAccelerationInitialOffsetDelay_MS;
 }
 
+#if ACKSEN_BUTTON_ACCELERATION_CURVES
+
+void AcksenButton::setAccelerationCurve(const uint16_t* pauiCurve, uint8_t uiLength)
+{
+	pauiAccelerationCurve = (uiLength > 0) ? pauiCurve : NULL;
+	uiAccelerationCurveLength = uiLength;
+}
+
+#endif
+
+uint16_t AcksenButton::getRepeatCount()
+{
+	return uiRepeatCount;
+}
+
 void AcksenButton::setButtonOperatingMode(uint8_t uiButtonOperationMode)
 {
 	this->uiButtonOperationMode = uiButtonOperationMode;
@@ -108,9 +340,21 @@ void AcksenButton::setButtonOperatingMode(uint8_t uiButtonOperationMode)
 
 bool AcksenButton::refreshStatus()
 {
+	return refreshStatus(getTime());
+}
+
+// The clock is read once by the caller, and the same time used throughout the refresh
+bool AcksenButton::refreshStatus(unsigned long ulNow_MS)
+{
+	
+#if ACKSEN_BUTTON_INSTRUMENTATION
+	instrumentRefresh(ulNow_MS);
+#endif
 		
-	if ( checkDebounceStatus() ) 
+	if ( checkDebounceStatus(ulNow_MS) ) 
 	{
+		recordEvent(bDebouncedButtonState ? ACKSEN_BUTTON_EVENT_PRESSED : ACKSEN_BUTTON_EVENT_RELEASED, ulLastStatusUpdate_MS);
+		
 		// Record the Button State Change, so it can be checked later.
         return bStateChangeRecorded = true;
     }
@@ -123,12 +367,15 @@ bool AcksenButton::refreshStatus()
 		{
 			
 			// Check to see if Repeat Period has elapsed
-			if (millis() >= ulRepeatPressesPeriodEnd) 
+			if (!acksenButtonTimeBefore(ulNow_MS, ulRepeatPressesPeriodEnd))
 			{
 				//Serial.println(F("RepeatPress Check triggered another Button Signal"));
 				
 				// Setup for the next repeat period
-				ulRepeatPressesPeriodEnd = millis() + ulRepeatPressesInterval_MS;
+				ulRepeatPressesPeriodEnd = ulNow_MS + ulRepeatPressesInterval_MS;
+				countRepeat();
+				
+				recordEvent(ACKSEN_BUTTON_EVENT_REPEAT, ulNow_MS);
 				
 				// Reset the State Change Recorded flag, so the button-press can be processed/repeated again
 				return bStateChangeRecorded = true;
@@ -140,22 +387,36 @@ bool AcksenButton::refreshStatus()
 		{
 			
 			// Check to see if Repeat Period has elapsed
-			if (millis() >= ulRepeatPressesPeriodEnd) 
+			if (!acksenButtonTimeBefore(ulNow_MS, ulRepeatPressesPeriodEnd))
 			{
 				//Serial.println(F("RepeatPress Check triggered another Button Signal"));
 				
 				// Setup for the next repeat period
-				if ((millis() - ulButtonOperationStart) >= ulAccelerationInitialOffsetDelay_MS)
+#if ACKSEN_BUTTON_ACCELERATION_CURVES
+				if (pauiAccelerationCurve != NULL)
+				{
+					// Acceleration Curve - look up the interval for this repeat. Tables are always in milliseconds.
+					uint8_t uiStep = (uiRepeatCount < uiAccelerationCurveLength) ? (uint8_t)uiRepeatCount : (uint8_t)(uiAccelerationCurveLength - 1);
+					unsigned long ulStep_MS = AcksenButtonHAL::readProgramWord(&pauiAccelerationCurve[uiStep]);
+					
+					ulRepeatPressesPeriodEnd = ulNow_MS + ((uiTimeBase == ACKSEN_BUTTON_TIME_MICROS) ? (ulStep_MS * 1000) : ulStep_MS);
+				}
+				else
+#endif
+				if ((ulNow_MS - ulButtonOperationStart) >= ulAccelerationInitialOffsetDelay_MS)
 				{
 					// Acceleration Mode
-					ulRepeatPressesPeriodEnd = millis() + ulAccelerationPressesInterval_MS;
+					ulRepeatPressesPeriodEnd = ulNow_MS + ulAccelerationPressesInterval_MS;
 				}
 				else
 				{
 					// Repeat Mode
-					ulRepeatPressesPeriodEnd = millis() + ulRepeatPressesInterval_MS;
+					ulRepeatPressesPeriodEnd = ulNow_MS + ulRepeatPressesInterval_MS;
 				}
 				
+				countRepeat();
+				recordEvent(ACKSEN_BUTTON_EVENT_REPEAT, ulNow_MS);
+				
 				// Reset the State Change Recorded flag, so the button-press can be processed/repeated again
 				return bStateChangeRecorded = true;
 			
@@ -170,6 +431,12 @@ bool AcksenButton::refreshStatus()
 	// Reset Long Press system if present button state is low
 	if (bDebouncedButtonState == false)
 	{
+#if ACKSEN_BUTTON_INSTRUMENTATION
+		if ((bLongPressRecorded == true) && (bLongPressProcessed == false) && (sStats.uiDroppedEvents < 0xFFFF))
+		{
+			sStats.uiDroppedEvents++;
+		}
+#endif
 		bLongPressRecorded = false;
 		bLongPressProcessed = false;
 	}
@@ -181,10 +448,12 @@ bool AcksenButton::refreshStatus()
 		if (bLongPressRecorded == false)
 		{
 			// Time Threshold Exceeded - set Long Press as having been executed
-			if ((bDebouncedButtonState == true) && (millis() - ulLastStatusUpdate_MS >= ulLongPressInterval_MS))
+			if ((bDebouncedButtonState == true) && (ulNow_MS - ulLastStatusUpdate_MS >= ulLongPressInterval_MS))
 			{
 				bLongPressRecorded = true;
 				bLongPressProcessed = false;
+				
+				recordEvent(ACKSEN_BUTTON_EVENT_LONGPRESS, ulNow_MS);
 			}
 			else if (bDebouncedButtonState == false)
 			{
@@ -200,9 +469,94 @@ bool AcksenButton::refreshStatus()
 }
 
 
+bool AcksenButton::getNextDeadline(unsigned long& ulDeadline_MS)
+{
+	
+	bool bDeadlineSet = false;
+	bool bPending;
+	unsigned long ulDebounceDeadline_MS = ulLastStatusUpdate_MS + ulDebounceInterval_MS;
+	
+	// A change waiting on the debounce interval
+#if ACKSEN_BUTTON_EDGE_CAPTURE
+	if (pEdgeRing != NULL)
+	{
+		
+		// Captured edges (or an overflow) need draining as soon as possible
+		if (!pEdgeRing->isEmpty() || pEdgeRing->hasOverflowed())
+		{
+			ulDeadline_MS = getTime();
+			return true;
+		}
+		
+		bPending = (bRawButtonState != bDebouncedButtonState);
+	}
+	else
+#endif
+	{
+		bPending = (readInput() != bDebouncedButtonState);
+		
+#if ACKSEN_BUTTON_DEBOUNCE_STRATEGIES
+		if ((uiDebounceStrategy == ACKSEN_BUTTON_DEBOUNCE_INTEGRATOR) || (uiDebounceStrategy == ACKSEN_BUTTON_DEBOUNCE_MAJORITY))
+		{
+			// Sampling continues until the history settles back on the debounced state
+			bPending = bPending || !isDebounceHistorySettled();
+			ulDebounceDeadline_MS = ulDebounceTimer_MS + getDebounceSamplePeriod();
+		}
+		else if (uiDebounceStrategy == ACKSEN_BUTTON_DEBOUNCE_LOCKOUT)
+		{
+			ulDebounceDeadline_MS = ulDebounceTimer_MS + ulDebounceInterval_MS;
+		}
+		else if (uiDebounceStrategy == ACKSEN_BUTTON_DEBOUNCE_ADAPTIVE)
+		{
+			ulDebounceDeadline_MS = ulDebounceTimer_MS + uiLearnedDebounce_MS;
+		}
+#endif
+	}
+	
+	if (bPending)
+	{
+		ulDeadline_MS = ulDebounceDeadline_MS;
+		bDeadlineSet = true;
+	}
+	
+	if (bDebouncedButtonState == true)
+	{
+		
+		unsigned long ulModeDeadline_MS = 0;
+		bool bModeDeadlineSet = false;
+		
+		if ((uiButtonOperationMode == ACKSEN_BUTTON_MODE_REPEAT) || (uiButtonOperationMode == ACKSEN_BUTTON_MODE_ACCELERATE))
+		{
+			ulModeDeadline_MS = ulRepeatPressesPeriodEnd;
+			bModeDeadlineSet = true;
+		}
+		else if ((uiButtonOperationMode == ACKSEN_BUTTON_MODE_LONGPRESS) && (bLongPressRecorded == false))
+		{
+			ulModeDeadline_MS = ulLastStatusUpdate_MS + ulLongPressInterval_MS;
+			bModeDeadlineSet = true;
+		}
+		
+		if (bModeDeadlineSet && (!bDeadlineSet || acksenButtonTimeBefore(ulModeDeadline_MS, ulDeadline_MS)))
+		{
+			ulDeadline_MS = ulModeDeadline_MS;
+			bDeadlineSet = true;
+		}
+		
+	}
+	else if (bLongPressRecorded == true)
+	{
+		// A long press is only cleared by a refresh after the release was accepted
+		ulDeadline_MS = ulLastStatusUpdate_MS;
+		bDeadlineSet = true;
+	}
+	
+	return bDeadlineSet;
+	
+}
+
 unsigned long AcksenButton::getTimeFromLastStateChange()
 {
-  return millis() - ulLastStatusUpdate_MS;
+  return getTime() - ulLastStatusUpdate_MS;
 }
 
 
@@ -213,29 +567,54 @@ bool AcksenButton::getButtonState()
 
 
 // Protected: Check to see if the I/O Pin state has surpassed the Debounce threshold
-bool AcksenButton::checkDebounceStatus() 
+bool AcksenButton::checkDebounceStatus(unsigned long ulNow_MS) 
 {
 	
-	bool bNewButtonState = digitalRead(uiButtonPin);
+#if ACKSEN_BUTTON_EDGE_CAPTURE
+	// Edges captured by interrupt are debounced using their own timestamps instead
+	if (pEdgeRing != NULL)
+	{
+		return checkCapturedEdges(ulNow_MS);
+	}
+#endif
+	
+	bool bNewButtonState = readInput();
+	
+#if ACKSEN_BUTTON_INSTRUMENTATION
+	if (bNewButtonState != bInstrumentRawLevel)
+	{
+		instrumentRawEdge(bNewButtonState, ulNow_MS);
+	}
+#endif
+
+#if ACKSEN_BUTTON_TRACE
+	if ((pTraceRecorder != NULL) && (bNewButtonState != bTraceRawLevel))
+	{
+		bTraceRawLevel = bNewButtonState;
+		pTraceRecorder->recordEdge(uiTraceChannel, bNewButtonState, ulNow_MS);
+	}
+#endif
+
+#if ACKSEN_BUTTON_DEBOUNCE_STRATEGIES
+	if ((uiDebounceStrategy == ACKSEN_BUTTON_DEBOUNCE_INTEGRATOR) || (uiDebounceStrategy == ACKSEN_BUTTON_DEBOUNCE_MAJORITY))
+	{
+		return checkSampledDebounce(bNewButtonState, ulNow_MS);
+	}
+	else if (uiDebounceStrategy == ACKSEN_BUTTON_DEBOUNCE_LOCKOUT)
+	{
+		return checkLockoutDebounce(bNewButtonState, ulNow_MS);
+	}
+	else if (uiDebounceStrategy == ACKSEN_BUTTON_DEBOUNCE_ADAPTIVE)
+	{
+		return checkAdaptiveDebounce(bNewButtonState, ulNow_MS);
+	}
+#endif
 
 	if (bDebouncedButtonState != bNewButtonState ) 
 	{
-  		if (millis() - ulLastStatusUpdate_MS >= ulDebounceInterval_MS) 
+  		if (ulNow_MS - ulLastStatusUpdate_MS >= ulDebounceInterval_MS) 
 		{
-  			ulLastStatusUpdate_MS = millis();
-  			bDebouncedButtonState = bNewButtonState;
-			
-			// Set Repeat Presses if necessary
-			if ((uiButtonOperationMode == ACKSEN_BUTTON_MODE_REPEAT) || (uiButtonOperationMode == ACKSEN_BUTTON_MODE_ACCELERATE))
-			{
-				
-				if (uiButtonOperationMode == ACKSEN_BUTTON_MODE_ACCELERATE)
-				{
-					ulButtonOperationStart = millis();
-				}
-				
-				ulRepeatPressesPeriodEnd = millis() + ulRepeatInitialOffsetDelay_MS;
-			}
+			acceptStateChange(bNewButtonState, ulNow_MS);
 			
   			return true;
 		}
@@ -246,49 +625,558 @@ bool AcksenButton::checkDebounceStatus()
 	
 }
 
-// The onPressed method is true for one scan after the de-bounced input goes from low-to-high.
-bool AcksenButton::onPressed() 
-{ 
-	
-	// Check to see if a Low to High transition was noted in the last Refresh
-	bool bTransitionRecorded = bStateChangeRecorded && bDebouncedButtonState;
+#if ACKSEN_BUTTON_DEBOUNCE_STRATEGIES
 
-	if (bTransitionRecorded == true)
+// Protected: Integrator and Majority strategies - take a sample each sample period, and accept a change
+// once the count saturates, or the majority of the sample history disagrees with the debounced state
+bool AcksenButton::checkSampledDebounce(bool bNewButtonState, unsigned long ulNow_MS)
+{
+	
+	unsigned long ulSamplePeriod_MS = getDebounceSamplePeriod();
+	
+	if (ulNow_MS - ulDebounceTimer_MS < ulSamplePeriod_MS)
 	{
+		return false;
+	}
 	
-		// Reset the State Change Recorded flag, as the button-press has now been acknowledged and returned
-		bStateChangeRecorded = false;
+	// Keep to a regular sample period, unless refreshes have fallen more than a period behind
+	ulDebounceTimer_MS += ulSamplePeriod_MS;
+	
+	if (ulNow_MS - ulDebounceTimer_MS >= ulSamplePeriod_MS)
+	{
+		ulDebounceTimer_MS = ulNow_MS;
 	}
 	
-	return bTransitionRecorded; 
+	bool bSampledState;
 	
-}
-
-// The onLongPress method is true for one onLongPress after the de-bounced input goes from low-to-high for greater than the specified interval.
-bool AcksenButton::onLongPress() 
-{ 
-
-	if (uiButtonOperationMode == ACKSEN_BUTTON_MODE_LONGPRESS)
+	if (uiDebounceStrategy == ACKSEN_BUTTON_DEBOUNCE_INTEGRATOR)
 	{
 		
-		if ((bLongPressRecorded == true) && (bLongPressProcessed == false))
+		if (bNewButtonState && (uiDebounceHistory < uiDebounceSamples))
 		{
-			// Return that a Long Press has been registered
-			bLongPressProcessed = true;
-			
-			return true;
+			uiDebounceHistory++;
+		}
+		else if (!bNewButtonState && (uiDebounceHistory > 0))
+		{
+			uiDebounceHistory--;
+		}
+		
+		if (uiDebounceHistory == uiDebounceSamples)
+		{
+			bSampledState = true;
+		}
+		else if (uiDebounceHistory == 0)
+		{
+			bSampledState = false;
 		}
 		else
 		{
-			// Either there is no onLongPress to return; or it has already been returned.
 			return false;
 		}
-
+		
 	}
 	else
 	{
-		// Always return false when LongPress mode is not enabled
-		return false;
+		
+		uiDebounceHistory = (uiDebounceHistory << 1) | (bNewButtonState ? 1 : 0);
+		
+		uint8_t uiSamples = uiDebounceHistory & (uint8_t)((1U << uiDebounceSamples) - 1);
+		uint8_t uiHighSamples = 0;
+		
+		while (uiSamples != 0)
+		{
+			uiSamples &= uiSamples - 1;
+			uiHighSamples++;
+		}
+		
+		// A tied vote keeps the present state
+		if (uiHighSamples * 2 > uiDebounceSamples)
+		{
+			bSampledState = true;
+		}
+		else if (uiHighSamples * 2 < uiDebounceSamples)
+		{
+			bSampledState = false;
+		}
+		else
+		{
+			return false;
+		}
+		
+	}
+	
+	if (bSampledState != bDebouncedButtonState)
+	{
+		acceptStateChange(bSampledState, ulNow_MS);
+		
+		return true;
+	}
+	
+	return false;
+	
+}
+
+// Protected: Lockout strategy - accept the first edge immediately, then ignore the input until no edge has
+// been seen for the debounce interval
+bool AcksenButton::checkLockoutDebounce(bool bNewButtonState, unsigned long ulNow_MS)
+{
+	
+	bool bLockedOut = (ulNow_MS - ulDebounceTimer_MS < ulDebounceInterval_MS);
+	
+	if (bNewButtonState != bLastRawLevel)
+	{
+		bLastRawLevel = bNewButtonState;
+		
+		// Bounces during the Lockout restart it
+		if (bLockedOut)
+		{
+			ulDebounceTimer_MS = ulNow_MS;
+		}
+	}
+	
+	if ((bNewButtonState != bDebouncedButtonState) && !bLockedOut)
+	{
+		acceptStateChange(bNewButtonState, ulNow_MS);
+		ulDebounceTimer_MS = ulNow_MS;
+		
+		return true;
+	}
+	
+	return false;
+	
+}
+
+// Protected: Adaptive strategy - accept a change once the input has been quiet for the learned window.
+// The longest gap between edges within each bounce is tracked, and the window learned from it when the change
+// is accepted. An edge soon after an accepted change shows the bounce had not finished, so the window grows to
+// cover that gap.
+bool AcksenButton::checkAdaptiveDebounce(bool bNewButtonState, unsigned long ulNow_MS)
+{
+	
+	if (bNewButtonState != bLastRawLevel)
+	{
+		unsigned long ulGap_MS = ulNow_MS - ulDebounceTimer_MS;
+		
+		bLastRawLevel = bNewButtonState;
+		ulDebounceTimer_MS = ulNow_MS;
+		
+		if (bAdaptiveConfirming)
+		{
+			bAdaptiveConfirming = false;
+			
+			// Accepted mid-bounce - too short a window. Longer gaps are more likely a glitch than a bounce.
+			if ((ulGap_MS < 2UL * uiLearnedDebounce_MS) && (ulGap_MS < uiAdaptiveMaximum_MS))
+			{
+				learnDebounceInterval(ulGap_MS, true);
+			}
+		}
+		
+		if (ulGap_MS >= uiLearnedDebounce_MS)
+		{
+			// First edge of a new bounce
+			uiDebounceHistory = 0;
+		}
+		else if (ulGap_MS > uiDebounceHistory)
+		{
+			uiDebounceHistory = (ulGap_MS < uiAdaptiveMaximum_MS) ? ulGap_MS : uiAdaptiveMaximum_MS;
+		}
+	}
+	
+	if ((bNewButtonState != bDebouncedButtonState) && (ulNow_MS - ulDebounceTimer_MS >= uiLearnedDebounce_MS))
+	{
+		acceptStateChange(bNewButtonState, ulNow_MS);
+		learnDebounceInterval(uiDebounceHistory, false);
+		bAdaptiveConfirming = true;
+		
+		return true;
+	}
+	
+	// Confirmation only covers the longest window that could be learned
+	if (bAdaptiveConfirming && (ulNow_MS - ulDebounceTimer_MS >= uiAdaptiveMaximum_MS))
+	{
+		bAdaptiveConfirming = false;
+	}
+	
+	return false;
+	
+}
+
+// Protected: Moves the Adaptive window towards twice a gap seen between bounces, plus a millisecond for sampling.
+// Gaps longer than the window end the bounce early and are never seen, so the margin is generous. The window grows
+// straight away when needed, and otherwise shrinks by an eighth of the difference, so one quiet press does not undo
+// what earlier bounces taught.
+void AcksenButton::learnDebounceInterval(unsigned long ulBounceGap_MS, bool bImmediate)
+{
+	
+	unsigned long ulTarget_MS = (2 * ulBounceGap_MS) + 1;
+	
+	if (ulTarget_MS < uiAdaptiveMinimum_MS)
+	{
+		ulTarget_MS = uiAdaptiveMinimum_MS;
+	}
+	else if (ulTarget_MS > uiAdaptiveMaximum_MS)
+	{
+		ulTarget_MS = uiAdaptiveMaximum_MS;
+	}
+	
+	if (bImmediate || (ulTarget_MS > uiLearnedDebounce_MS))
+	{
+		uiLearnedDebounce_MS = ulTarget_MS;
+	}
+	else
+	{
+		uiLearnedDebounce_MS -= (uiLearnedDebounce_MS - ulTarget_MS + 7) / 8;
+	}
+	
+}
+
+// Protected: Fill the sample history with the debounced state
+void AcksenButton::resetDebounceHistory()
+{
+	
+	if (uiDebounceStrategy == ACKSEN_BUTTON_DEBOUNCE_INTEGRATOR)
+	{
+		uiDebounceHistory = bDebouncedButtonState ? uiDebounceSamples : 0;
+	}
+	else if (uiDebounceStrategy == ACKSEN_BUTTON_DEBOUNCE_ADAPTIVE)
+	{
+		uiDebounceHistory = 0;
+	}
+	else
+	{
+		uiDebounceHistory = bDebouncedButtonState ? 0xFF : 0;
+	}
+	
+}
+
+// Protected: Returns true if the sample history agrees entirely with the debounced state
+bool AcksenButton::isDebounceHistorySettled()
+{
+	
+	if (uiDebounceStrategy == ACKSEN_BUTTON_DEBOUNCE_INTEGRATOR)
+	{
+		return uiDebounceHistory == (bDebouncedButtonState ? uiDebounceSamples : 0);
+	}
+	
+	uint8_t uiMask = (uint8_t)((1U << uiDebounceSamples) - 1);
+	
+	return (uiDebounceHistory & uiMask) == (bDebouncedButtonState ? uiMask : 0);
+	
+}
+
+// Protected: Returns the time between samples for the Integrator and Majority strategies
+unsigned long AcksenButton::getDebounceSamplePeriod()
+{
+	
+	unsigned long ulSamplePeriod_MS = ulDebounceInterval_MS / uiDebounceSamples;
+	
+	return (ulSamplePeriod_MS > 0) ? ulSamplePeriod_MS : 1;
+	
+}
+
+#endif
+
+#if ACKSEN_BUTTON_EDGE_CAPTURE
+
+// Protected: Drain captured edges, applying the Debounce threshold at the time each edge occurred.
+// At most one state change is accepted per call, so that it can be reported by onPressed()/onReleased() - 
+// any remaining edges stay in the ring for the next refresh.
+// ulNow_MS must be read before draining - edges pushed after that point are left in the ring, so that no edge is
+// judged against a clock reading older than itself.
+bool AcksenButton::checkCapturedEdges(unsigned long ulNow_MS)
+{
+	
+	AcksenButtonEdge sEdge;
+	
+	while (pEdgeRing->peek(sEdge))
+	{
+		
+		// Leave edges captured after ulNow_MS for the next refresh
+		if ((long)(sEdge.ulTimestamp_MS - ulNow_MS) > 0)
+		{
+			break;
+		}
+		
+		pEdgeRing->pop(sEdge);
+		
+#if ACKSEN_BUTTON_INSTRUMENTATION
+		instrumentRawEdge(sEdge.bLevel, sEdge.ulTimestamp_MS);
+#endif
+		
+		bRawButtonState = sEdge.bLevel;
+		ulRawStateChange_MS = sEdge.ulTimestamp_MS;
+		
+		if ((bDebouncedButtonState != bRawButtonState) && (ulRawStateChange_MS - ulLastStatusUpdate_MS >= ulDebounceInterval_MS))
+		{
+			acceptStateChange(bRawButtonState, ulRawStateChange_MS);
+			
+			return true;
+		}
+	}
+	
+	// Edges were dropped while the ring was full, so the last one drained may not be the pin's present level. Once
+	// the ring is empty, take the level from the pin instead, as of this refresh.
+	if (pEdgeRing->hasOverflowed() && pEdgeRing->isEmpty())
+	{
+		pEdgeRing->clearOverflow();
+		
+		bool bLevel = readInput();
+		
+		if (bLevel != bRawButtonState)
+		{
+			
+#if ACKSEN_BUTTON_INSTRUMENTATION
+			instrumentRawEdge(bLevel, ulNow_MS);
+#endif
+			
+			bRawButtonState = bLevel;
+			ulRawStateChange_MS = ulNow_MS;
+		}
+	}
+	
+	// An edge that arrived inside the debounce interval, and has not since been reversed, is accepted once the
+	// interval has passed - timed from when polling would first have seen it.
+	if ((bDebouncedButtonState != bRawButtonState) && (ulNow_MS - ulLastStatusUpdate_MS >= ulDebounceInterval_MS))
+	{
+		unsigned long ulChangeTime_MS = ulLastStatusUpdate_MS + ulDebounceInterval_MS;
+		
+		if ((long)(ulRawStateChange_MS - ulChangeTime_MS) > 0)
+		{
+			ulChangeTime_MS = ulRawStateChange_MS;
+		}
+		
+		acceptStateChange(bRawButtonState, ulChangeTime_MS);
+		
+		return true;
+	}
+	
+	return false;
+	
+}
+
+#endif
+
+// Protected: Record a debounced state change that occurred at the specified time
+void AcksenButton::acceptStateChange(bool bNewButtonState, unsigned long ulChangeTime_MS)
+{
+	
+	ulLastStatusUpdate_MS = ulChangeTime_MS;
+	bDebouncedButtonState = bNewButtonState;
+	
+#if ACKSEN_BUTTON_INSTRUMENTATION
+	if (sStats.uiAcceptedEdges < 0xFFFF)
+	{
+		sStats.uiAcceptedEdges++;
+	}
+	
+	// A press is timed from its first raw edge, so latency includes the time spent debouncing
+	ulInstrumentEvent_MS = bInstrumentEdgePending ? ulInstrumentEdge_MS : ulChangeTime_MS;
+	bInstrumentEdgePending = false;
+#endif
+	
+	// Set Repeat Presses if necessary
+	if ((uiButtonOperationMode == ACKSEN_BUTTON_MODE_REPEAT) || (uiButtonOperationMode == ACKSEN_BUTTON_MODE_ACCELERATE))
+	{
+		
+		if (uiButtonOperationMode == ACKSEN_BUTTON_MODE_ACCELERATE)
+		{
+			ulButtonOperationStart = ulChangeTime_MS;
+		}
+		
+		ulRepeatPressesPeriodEnd = ulChangeTime_MS + ulRepeatInitialOffsetDelay_MS;
+		uiRepeatCount = 0;
+	}
+	
+}
+
+#if ACKSEN_BUTTON_EDGE_CAPTURE
+
+void AcksenButton::setEdgeCapture(AcksenButtonEdgeRing* pEdgeRing)
+{
+	
+	// Start from the present pin level, so the first captured edge is a genuine change
+	bRawButtonState = readInput();
+	ulRawStateChange_MS = getTime();
+	uiCapturedLevel = bRawButtonState;
+	
+	if (pEdgeRing != NULL)
+	{
+		pEdgeRing->clearOverflow();
+	}
+	
+	this->pEdgeRing = pEdgeRing;
+	
+}
+
+#endif
+
+#if ACKSEN_BUTTON_EVENTS
+
+void AcksenButton::setEventQueue(AcksenButtonEventQueue* pEventQueue)
+{
+	this->pEventQueue = pEventQueue;
+}
+
+void AcksenButton::setEventChannel(AcksenButtonEventChannel* pEventChannel, uint8_t uiButtonId)
+{
+	this->pEventChannel = pEventChannel;
+	uiEventChannelId = uiButtonId;
+}
+
+bool AcksenButton::pollEvent(AcksenButtonEvent& sEvent)
+{
+	
+	if (pEventQueue == NULL)
+	{
+		return false;
+	}
+	
+	return pEventQueue->pop(sEvent);
+	
+}
+
+uint8_t AcksenButton::getEventOverflowCount()
+{
+	
+	if (pEventQueue == NULL)
+	{
+		return 0;
+	}
+	
+	return pEventQueue->getOverflowCount();
+	
+}
+
+#endif
+
+// Protected: Add an event to the event queue and event channel, if attached.
+// A full queue or channel drops the new event, and counts the overflow, rather than overwriting unread events.
+void AcksenButton::recordEvent(uint8_t uiType, unsigned long ulTimestamp_MS)
+{
+	
+	// Both are unused when no event consumer is built in
+	(void)uiType;
+	(void)ulTimestamp_MS;
+	
+#if ACKSEN_BUTTON_INSTRUMENTATION
+	if (uiType == ACKSEN_BUTTON_EVENT_REPEAT)
+	{
+		ulInstrumentEvent_MS = ulTimestamp_MS;
+	}
+#endif
+
+#if ACKSEN_BUTTON_TRACE
+	if (pTraceRecorder != NULL)
+	{
+		pTraceRecorder->recordEvent(uiTraceChannel, uiType, ulTimestamp_MS);
+	}
+#endif
+	
+#if ACKSEN_BUTTON_EVENTS
+	if (pEventChannel != NULL)
+	{
+		AcksenButtonChannelEvent sChannelEvent;
+		sChannelEvent.ulTimestamp_MS = ulTimestamp_MS;
+		sChannelEvent.uiType = uiType;
+		sChannelEvent.uiButtonId = uiEventChannelId;
+		
+		pEventChannel->push(sChannelEvent);
+	}
+	
+	if (pEventQueue == NULL)
+	{
+		return;
+	}
+	
+	AcksenButtonEvent sEvent;
+	sEvent.ulTimestamp_MS = ulTimestamp_MS;
+	sEvent.uiType = uiType;
+	
+	pEventQueue->push(sEvent);
+#endif
+	
+}
+
+#if ACKSEN_BUTTON_EDGE_CAPTURE
+
+// Called from the pin-change ISR - the only code that pushes to the edge ring
+void AcksenButton::captureEdge()
+{
+	
+	bool bLevel = readInput();
+	
+	if ((pEdgeRing == NULL) || (bLevel == uiCapturedLevel))
+	{
+		return;
+	}
+	
+	AcksenButtonEdge sEdge;
+	sEdge.ulTimestamp_MS = getTime();
+	sEdge.bLevel = bLevel;
+	
+	// If the ring is full the edge is lost, and the ring flags the overflow for refreshStatus() to resynchronise
+	// from the pin. The level pushed last is then no longer the level the consumer will end up with, so the next
+	// call pushes whatever level it reads.
+	if (pEdgeRing->push(sEdge))
+	{
+		uiCapturedLevel = bLevel;
+	}
+	else
+	{
+		uiCapturedLevel = ACKSEN_BUTTON_CAPTURED_LEVEL_UNKNOWN;
+	}
+	
+}
+
+#endif
+
+// The onPressed method is true for one scan after the de-bounced input goes from low-to-high.
+bool AcksenButton::onPressed() 
+{ 
+	
+	// Check to see if a Low to High transition was noted in the last Refresh
+	bool bTransitionRecorded = bStateChangeRecorded && bDebouncedButtonState;
+
+	if (bTransitionRecorded == true)
+	{
+	
+		// Reset the State Change Recorded flag, as the button-press has now been acknowledged and returned
+		bStateChangeRecorded = false;
+		
+#if ACKSEN_BUTTON_INSTRUMENTATION
+		instrumentLatency(getTime() - ulInstrumentEvent_MS);
+#endif
+	}
+	
+	return bTransitionRecorded; 
+	
+}
+
+// The onLongPress method is true for one onLongPress after the de-bounced input goes from low-to-high for greater than the specified interval.
+bool AcksenButton::onLongPress() 
+{ 
+
+	if (uiButtonOperationMode == ACKSEN_BUTTON_MODE_LONGPRESS)
+	{
+		
+		if ((bLongPressRecorded == true) && (bLongPressProcessed == false))
+		{
+			// Return that a Long Press has been registered
+			bLongPressProcessed = true;
+			
+			return true;
+		}
+		else
+		{
+			// Either there is no onLongPress to return; or it has already been returned.
+			return false;
+		}
+
+	}
+	else
+	{
+		// Always return false when LongPress mode is not enabled
+		return false;
 	}
 }
 
@@ -310,3 +1198,157 @@ bool AcksenButton::onReleased()
 	
 }
 
+#if ACKSEN_BUTTON_INSTRUMENTATION
+
+const AcksenButtonStats& AcksenButton::getStats()
+{
+	return sStats;
+}
+
+void AcksenButton::resetStats()
+{
+	sStats.uiRawEdges = 0;
+	sStats.uiAcceptedEdges = 0;
+	sStats.uiDroppedEvents = 0;
+	sStats.ulMaxRefreshGap_MS = 0;
+	sStats.uiLatencyCount = 0;
+	sStats.uiLatencyMin_MS = 0xFFFF;
+	sStats.uiLatencyMax_MS = 0;
+	sStats.ulLatencyTotal_MS = 0;
+	
+	for (uint8_t uiBucket = 0; uiBucket < ACKSEN_BUTTON_LATENCY_BUCKETS; uiBucket++)
+	{
+		sStats.auiLatencyHistogram[uiBucket] = 0;
+	}
+}
+
+// Protected: Track the gap since the last refresh, and count a press or repeat left unread since then
+void AcksenButton::instrumentRefresh(unsigned long ulNow_MS)
+{
+	
+	unsigned long ulGap_MS = ulNow_MS - ulInstrumentRefresh_MS;
+	
+	if (ulGap_MS > sStats.ulMaxRefreshGap_MS)
+	{
+		sStats.ulMaxRefreshGap_MS = ulGap_MS;
+	}
+	
+	ulInstrumentRefresh_MS = ulNow_MS;
+	
+	// Releases are not counted, as many sketches never read them
+	if ((bStateChangeRecorded == true) && (bDebouncedButtonState == true) && (sStats.uiDroppedEvents < 0xFFFF))
+	{
+		sStats.uiDroppedEvents++;
+	}
+	
+}
+
+// Protected: Count a raw input change, and note when the input first moved away from the debounced state
+void AcksenButton::instrumentRawEdge(bool bLevel, unsigned long ulEdge_MS)
+{
+	
+	bInstrumentRawLevel = bLevel;
+	
+	if (sStats.uiRawEdges < 0xFFFF)
+	{
+		sStats.uiRawEdges++;
+	}
+	
+	if (bLevel == bDebouncedButtonState)
+	{
+		bInstrumentEdgePending = false;
+	}
+	else if (bInstrumentEdgePending == false)
+	{
+		bInstrumentEdgePending = true;
+		ulInstrumentEdge_MS = ulEdge_MS;
+	}
+	
+}
+
+// Protected: Record the time from a press or repeat to onPressed() returning it
+void AcksenButton::instrumentLatency(unsigned long ulLatency_MS)
+{
+	
+	uint16_t uiLatency_MS = (ulLatency_MS < 0xFFFF) ? (uint16_t)ulLatency_MS : 0xFFFF;
+	uint8_t uiBucket = 0;
+	
+	while ((uiBucket < ACKSEN_BUTTON_LATENCY_BUCKETS - 1) && (uiLatency_MS >= (1U << uiBucket)))
+	{
+		uiBucket++;
+	}
+	
+	if (sStats.uiLatencyCount < 0xFFFF)
+	{
+		sStats.uiLatencyCount++;
+		sStats.ulLatencyTotal_MS += uiLatency_MS;
+		
+		if (sStats.auiLatencyHistogram[uiBucket] < 0xFFFF)
+		{
+			sStats.auiLatencyHistogram[uiBucket]++;
+		}
+	}
+	
+	if (uiLatency_MS < sStats.uiLatencyMin_MS)
+	{
+		sStats.uiLatencyMin_MS = uiLatency_MS;
+	}
+	
+	if (uiLatency_MS > sStats.uiLatencyMax_MS)
+	{
+		sStats.uiLatencyMax_MS = uiLatency_MS;
+	}
+	
+}
+
+#endif
+
+#if ACKSEN_BUTTON_TRACE
+
+void AcksenButton::setTraceRecorder(AcksenButtonTraceRecorder* pTraceRecorder, uint8_t uiChannel)
+{
+	
+	this->pTraceRecorder = pTraceRecorder;
+	uiTraceChannel = uiChannel;
+	
+	if (pTraceRecorder == NULL)
+	{
+		return;
+	}
+	
+	unsigned long ulNow_MS = getTime();
+	AcksenButtonTraceConfig sConfig;
+	
+	sConfig.uiMode = uiButtonOperationMode;
+	sConfig.uiTimeBase = uiTimeBase;
+	sConfig.ulAge_MS = ulNow_MS - ulLastStatusUpdate_MS;
+	sConfig.ulDebounceInterval_MS = ulDebounceInterval_MS;
+	sConfig.ulLongPressInterval_MS = ulLongPressInterval_MS;
+	sConfig.ulRepeatPressesInterval_MS = ulRepeatPressesInterval_MS;
+	sConfig.ulRepeatInitialOffsetDelay_MS = ulRepeatInitialOffsetDelay_MS;
+	sConfig.ulAccelerationPressesInterval_MS = ulAccelerationPressesInterval_MS;
+	sConfig.ulAccelerationInitialOffsetDelay_MS = ulAccelerationInitialOffsetDelay_MS;
+	
+#if ACKSEN_BUTTON_DEBOUNCE_STRATEGIES
+	sConfig.uiDebounceStrategy = uiDebounceStrategy;
+	sConfig.uiDebounceSamples = uiDebounceSamples;
+	sConfig.ulDebounceTimerAge_MS = ulNow_MS - ulDebounceTimer_MS;
+	sConfig.ulAdaptiveMinimum_MS = uiAdaptiveMinimum_MS;
+	sConfig.ulAdaptiveMaximum_MS = uiAdaptiveMaximum_MS;
+#else
+	// Without the strategies every button uses the Timestamp strategy, which keeps no other state
+	sConfig.uiDebounceStrategy = ACKSEN_BUTTON_DEBOUNCE_TIMESTAMP;
+	sConfig.uiDebounceSamples = DEFAULT_DEBOUNCE_SAMPLES;
+	sConfig.ulDebounceTimerAge_MS = ulDebounceInterval_MS;
+	sConfig.ulAdaptiveMinimum_MS = DEFAULT_ADAPTIVE_DEBOUNCE_MINIMUM;
+	sConfig.ulAdaptiveMaximum_MS = DEFAULT_ADAPTIVE_DEBOUNCE_MAXIMUM;
+#endif
+	
+	// The replay starts from the debounced state, so any difference in the raw level is recorded as an edge at the next refresh
+	bTraceRawLevel = bDebouncedButtonState;
+	
+	pTraceRecorder->recordConfig(uiChannel, bDebouncedButtonState, sConfig, ulNow_MS);
+	
+}
+
+#endif
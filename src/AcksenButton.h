@@ -19,8 +19,37 @@ Neither the name of the copyright holder nor the names of its contributors may b
 THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 ***********************************************************/
 
-// Acksen Button Library v1.3.0
+// Acksen Button Library v1.4.0
 
+// v1.4.0	16 Oct 2026
+// - Route all clock and I/O pin access through AcksenButtonHAL, so the library can be built on a host PC
+// - Add host build with mock GPIO, simulated clock and refreshStatus() benchmark suite (extras/host)
+// - Add AcksenButtonBank, debouncing 8/16/32/64 buttons per input word with vertical counters
+// - Add optional interrupt-driven edge capture, via a lock-free timestamped edge ring drained by refreshStatus()
+// - Add optional per-button event queue with timestamps and overflow count, read with pollEvent()
+// - Add AcksenButtonStatic, with pin, mode and intervals fixed at compile time
+// - Add AcksenButtonCompact, with bit-packed flags, 16-bit timers and shared interval configuration
+// - Add refreshStatus(ulNow_MS), reading the clock once per refresh, and AcksenButtonGroup to refresh many buttons from one clock read
+// - Add getNextDeadline() to AcksenButton and AcksenButtonGroup, for tickless scheduling
+// - Make repeat and acceleration period checks wrap-safe across millis() rollover
+// - Add AcksenButtonTimerWheel, so that only buttons with an expiring deadline are refreshed
+// - Add setDebounceStrategy(), with Integrator, Majority and Lockout strategies alongside the existing Timestamp debounce
+// - Add Adaptive debounce strategy, learning each button's debounce window from its own bounce
+// - Read pins through their input register, resolved once at construction, instead of digitalRead() on AVR (other cores opt in with ACKSEN_BUTTON_ENABLE_PORT_INPUT)
+// - Add constructor for buttons read from a virtual port (a bit of a word in memory)
+// - Add AcksenButtonMatrix, scanning keypad matrices with ghosting detection and a settle time after each row, and writePin() and delayMicros() to AcksenButtonHAL
+// - Add AcksenButtonShiftIn, reading chained 74HC165 shift registers in one SPI (or bit-banged) transfer per scan
+// - Add AcksenButtonAnalog, reading resistor ladder keypads with filtered, non-blocking ADC conversions, handed between ladders in turn
+// - Add AcksenButtonGestures, detecting clicks, multi-clicks and two-button chords, each reported as early as it can be decided
+// - Add setAccelerationCurve(), with exponential and linear curve tables generated at compile time into PROGMEM, and getRepeatCount()
+// - Add optional instrumentation (ACKSEN_BUTTON_INSTRUMENTATION): raw/accepted edges, dropped events, refresh gaps and press latency
+// - Add optional binary trace recording (ACKSEN_BUTTON_TRACE) of raw input edges and events, with a host replay tool
+// - getNextDeadline() now reports a deadline after a release while a long press is still to be cleared
+// - Add setEventChannel(), publishing events tagged with a button id to a lock-free SPSC channel, for scanner/consumer task splits
+// - Add setTimeBase(), timing a button with micros() for sub-millisecond debounce, and getMicros() to AcksenButtonHAL
+// - Add AcksenButtonEncoder, decoding quadrature rotary encoders by table, polled or by interrupt, with accelerated turns and a push switch
+// - Debounce strategies, edge capture, event queues/channels and acceleration curves are compiled in only when their options are set (ACKSEN_BUTTON_DEBOUNCE_STRATEGIES, ACKSEN_BUTTON_EDGE_CAPTURE, ACKSEN_BUTTON_EVENTS, ACKSEN_BUTTON_ACCELERATION_CURVES), so buttons without them stay close to v1.3.0 in size
+//
 // v1.3.0	22 Jul 2022
 // - Add licence, other cosmetic/comments changes for preparation for open source release
 // - Fix DEEFAULT_REPEAT_INITIAL_OFFSET_INTERVAL to DEFAULT_REPEAT_INITIAL_OFFSET_INTERVAL typo
@@ -41,9 +70,37 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 #ifndef AcksenButton_h
 #define AcksenButton_h
 
-#define AcksenButton_ver   130	///< Constant used to set the present library version. Can be used to ensure any code using this library, is correctly updated with necessary changes in subsequent versions, before compilation.
+#define AcksenButton_ver   140	///< Constant used to set the present library version. Can be used to ensure any code using this library, is correctly updated with necessary changes in subsequent versions, before compilation.
 
 #include <inttypes.h>
+#include <stddef.h>
+
+#include "AcksenButtonHAL.h"
+#include "AcksenButtonRing.h"
+
+// Options - these change the layout of AcksenButton, so must be set for every file (e.g. as a build flag, or by
+// editing the default here), not with a #define in a sketch, which AcksenButton.cpp would not see
+#ifndef ACKSEN_BUTTON_INSTRUMENTATION
+#define ACKSEN_BUTTON_INSTRUMENTATION					0		///< Set to 1 to collect AcksenButtonStats for every button. When 0 it costs no memory or time
+#endif
+#ifndef ACKSEN_BUTTON_TRACE
+#define ACKSEN_BUTTON_TRACE								0		///< Set to 1 to allow buttons to write to an AcksenButtonTraceRecorder (see AcksenButtonTrace.h)
+#endif
+#ifndef ACKSEN_BUTTON_DEBOUNCE_STRATEGIES
+#define ACKSEN_BUTTON_DEBOUNCE_STRATEGIES				0		///< Set to 1 for setDebounceStrategy() and the Integrator, Majority, Lockout and Adaptive strategies. When 0 every button uses the Timestamp strategy
+#endif
+#ifndef ACKSEN_BUTTON_EDGE_CAPTURE
+#define ACKSEN_BUTTON_EDGE_CAPTURE						0		///< Set to 1 for interrupt-driven edge capture, with setEdgeCapture() and captureEdge()
+#endif
+#ifndef ACKSEN_BUTTON_EVENTS
+#define ACKSEN_BUTTON_EVENTS							0		///< Set to 1 for event queues and channels, with setEventQueue(), setEventChannel() and pollEvent()
+#endif
+#ifndef ACKSEN_BUTTON_ACCELERATION_CURVES
+#define ACKSEN_BUTTON_ACCELERATION_CURVES				0		///< Set to 1 for setAccelerationCurve()
+#endif
+#ifndef ACKSEN_BUTTON_TIME_BASE
+#define ACKSEN_BUTTON_TIME_BASE							ACKSEN_BUTTON_TIME_MILLIS	///< Time base every button starts with (see setTimeBase())
+#endif
 
 // Constants
 #define DEFAULT_LONG_PRESS_INTERVAL						2000	///< Default interval that button must be held to register a Long Press when in Long Press Mode (Milliseconds)
@@ -58,6 +115,136 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 #define ACKSEN_BUTTON_MODE_REPEAT						2		///< Button operates in Repeat mode (if held down, onPressed() fires repeatedly on a timer basis)
 #define ACKSEN_BUTTON_MODE_ACCELERATE					3		///< Button operates in Accelerate mode (if held down, onPressed() fires on an increasingly frequent timer basis)
 
+#define ACKSEN_BUTTON_DEBOUNCE_TIMESTAMP				0		///< Debounce strategy: accept a change once the debounce interval has passed since the last accepted change (default)
+#define ACKSEN_BUTTON_DEBOUNCE_INTEGRATOR				1		///< Debounce strategy: a counter sampled across the debounce interval, accepting a change when it saturates
+#define ACKSEN_BUTTON_DEBOUNCE_MAJORITY					2		///< Debounce strategy: a shift register of samples across the debounce interval, accepting the level held by the majority
+#define ACKSEN_BUTTON_DEBOUNCE_LOCKOUT					3		///< Debounce strategy: accept a change immediately, then ignore the input until it has been quiet for the debounce interval
+
+#define ACKSEN_BUTTON_DEBOUNCE_ADAPTIVE					4		///< Debounce strategy: accept a change once the input has been quiet for a window learned from the switch's own bounce
+
+#define DEFAULT_DEBOUNCE_SAMPLES						4		///< Default samples per debounce interval, for the Integrator and Majority strategies
+#define ACKSEN_BUTTON_MAX_DEBOUNCE_SAMPLES				8		///< Maximum samples per debounce interval
+#define DEFAULT_ADAPTIVE_DEBOUNCE_MINIMUM				2		///< Default shortest window the Adaptive strategy may learn (Milliseconds)
+#define DEFAULT_ADAPTIVE_DEBOUNCE_MAXIMUM				50		///< Default longest window the Adaptive strategy may learn (Milliseconds)
+
+#define ACKSEN_BUTTON_TIME_MILLIS						0		///< Time base: times and intervals are in milliseconds, read with millis() (default)
+#define ACKSEN_BUTTON_TIME_MICROS						1		///< Time base: times and intervals are in microseconds, read with micros()
+
+#define ACKSEN_BUTTON_INPUT_DIGITALREAD					0		///< Input backend: read the pin with digitalRead()
+#define ACKSEN_BUTTON_INPUT_PORT						1		///< Input backend: read the pin's input register directly, resolved once (default on AVR)
+
+#define ACKSEN_BUTTON_NO_PIN							0xFF	///< Pin number of a button reading a virtual port
+
+#define ACKSEN_BUTTON_EDGE_RING_SIZE					16		///< Number of slots in an AcksenButtonEdgeRing (power of two, holds one fewer edge)
+#define ACKSEN_BUTTON_CAPTURED_LEVEL_UNKNOWN			0xFF	///< Level last captured by captureEdge() after the edge ring overflowed
+#define ACKSEN_BUTTON_EVENT_QUEUE_SIZE					8		///< Number of slots in an AcksenButtonEventQueue (power of two, holds one fewer event)
+#define ACKSEN_BUTTON_EVENT_CHANNEL_SIZE				32		///< Number of slots in an AcksenButtonEventChannel (power of two, holds one fewer event)
+
+#define ACKSEN_BUTTON_EVENT_PRESSED						0		///< Event: button transitioned from LOW to HIGH
+#define ACKSEN_BUTTON_EVENT_RELEASED					1		///< Event: button transitioned from HIGH to LOW
+#define ACKSEN_BUTTON_EVENT_LONGPRESS					2		///< Event: button held for the Long Press interval (Long Press mode)
+#define ACKSEN_BUTTON_EVENT_REPEAT						3		///< Event: repeated press while held (Repeat and Accelerate modes)
+#define ACKSEN_BUTTON_EVENT_CLOCKWISE					4		///< Event: encoder turned one detent forwards (AcksenButtonEncoder)
+#define ACKSEN_BUTTON_EVENT_ANTICLOCKWISE				5		///< Event: encoder turned one detent backwards (AcksenButtonEncoder)
+
+#define ACKSEN_BUTTON_LATENCY_BUCKETS					8		///< Latency histogram buckets: 0, 1, 2-3, 4-7, 8-15, 16-31, 32-63 and 64+ milliseconds
+
+/**************************************************************************/
+/*!
+    @brief  Wrap-safe comparison of two millis() (or two micros()) values.
+    @param  ulTimeA
+            The first time.
+    @param  ulTimeB
+            The second time.
+    @return Returns true if ulTimeA is earlier than ulTimeB.
+			Correct across clock rollover, provided the two times are less than half the clock range apart.
+*/
+/**************************************************************************/
+inline bool acksenButtonTimeBefore(unsigned long ulTimeA, unsigned long ulTimeB)
+{
+	return (long)(ulTimeA - ulTimeB) < 0;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Bit of a word in memory read by a button instead of an I/O pin (a virtual port)
+*/
+/**************************************************************************/
+struct AcksenButtonVirtualInput
+{
+	AcksenButtonVirtualInput(const volatile AcksenButtonPort_t* pInputRegister, AcksenButtonPort_t uiInputMask) : pInputRegister(pInputRegister), uiInputMask(uiInputMask) {}
+
+	const volatile AcksenButtonPort_t* pInputRegister;	///< Word holding the input, kept up to date by the caller
+	AcksenButtonPort_t uiInputMask;						///< Bit of the word that holds the input
+};
+
+/**************************************************************************/
+/*! 
+    @brief  Raw input edge captured by AcksenButton::captureEdge()
+*/
+/**************************************************************************/
+struct AcksenButtonEdge
+{
+	unsigned long ulTimestamp_MS;	///< Time the edge was captured, in milliseconds
+	bool bLevel;					///< Input level after the edge
+};
+
+typedef AcksenButtonRing<AcksenButtonEdge, ACKSEN_BUTTON_EDGE_RING_SIZE> AcksenButtonEdgeRing;	///< Ring of raw edges passed from an ISR to refreshStatus()
+
+/**************************************************************************/
+/*! 
+    @brief  Button event recorded by refreshStatus() into an AcksenButtonEventQueue
+*/
+/**************************************************************************/
+struct AcksenButtonEvent
+{
+	unsigned long ulTimestamp_MS;	///< Time the event occurred, in milliseconds
+	uint8_t uiType;					///< One of the ACKSEN_BUTTON_EVENT_* constants
+};
+
+typedef AcksenButtonRing<AcksenButtonEvent, ACKSEN_BUTTON_EVENT_QUEUE_SIZE> AcksenButtonEventQueue;	///< Queue of events passed from refreshStatus() to pollEvent()
+
+/**************************************************************************/
+/*! 
+    @brief  Button event published by refreshStatus() into an AcksenButtonEventChannel shared by several buttons
+*/
+/**************************************************************************/
+struct AcksenButtonChannelEvent
+{
+	unsigned long ulTimestamp_MS;	///< Time the event occurred, in milliseconds
+	uint8_t uiType;					///< One of the ACKSEN_BUTTON_EVENT_* constants
+	uint8_t uiButtonId;				///< Id given to the button by setEventChannel()
+};
+
+typedef AcksenButtonRing<AcksenButtonChannelEvent, ACKSEN_BUTTON_EVENT_CHANNEL_SIZE> AcksenButtonEventChannel;	///< Channel of events passed from a scanning task to one consumer task
+
+#if ACKSEN_BUTTON_INSTRUMENTATION
+
+/**************************************************************************/
+/*! 
+    @brief  Health and latency statistics of one button, collected when ACKSEN_BUTTON_INSTRUMENTATION is 1.
+			Counters saturate rather than wrap.
+*/
+/**************************************************************************/
+struct AcksenButtonStats
+{
+	uint16_t uiRawEdges;								///< Input changes seen by refreshStatus() (or captured by interrupt), including bounce
+	uint16_t uiAcceptedEdges;							///< Debounced state changes
+	uint16_t uiDroppedEvents;							///< Presses, repeats and long presses not read with onPressed()/onLongPress() before they were cleared
+	unsigned long ulMaxRefreshGap_MS;					///< Longest time between two refreshStatus() calls
+	uint16_t uiLatencyCount;							///< Presses and repeats read with onPressed()
+	uint16_t uiLatencyMin_MS;							///< Shortest time from a press (its first raw edge) or repeat, to onPressed() returning it
+	uint16_t uiLatencyMax_MS;							///< Longest such time
+	unsigned long ulLatencyTotal_MS;					///< Sum of those times - divide by uiLatencyCount for the mean
+	uint16_t auiLatencyHistogram[ACKSEN_BUTTON_LATENCY_BUCKETS];	///< Count of those times in each bucket (see ACKSEN_BUTTON_LATENCY_BUCKETS)
+};
+
+#endif
+
+#if ACKSEN_BUTTON_TRACE
+class AcksenButtonTraceRecorder;
+#endif
+
 /**************************************************************************/
 /*! 
     @brief  Class that defines the AcksenButton state and functions
@@ -90,6 +277,35 @@ public:
 */
 /**************************************************************************/
 	AcksenButton(uint8_t uiButtonPin, uint8_t uiButtonOperationMode, unsigned long ulDebounceInterval_MS, uint8_t uiButtonInputMode);
+
+/**************************************************************************/
+/*!
+    @brief  Class initialisation for a button read from a virtual port.
+            The button reads one bit of a word in memory instead of an I/O pin, so that inputs gathered by other
+			means (a keypad matrix, shift registers, an analog ladder...) get the full debounce and mode behaviour.
+    @param  sInput
+            The word holding the button's input, and the bit within it. The word is not copied, so must outlive the button.
+    @param  uiButtonOperationMode
+            The operating mode for the button (see above).
+    @param  ulDebounceInterval_MS
+            The debounce interval applied to the button, in milliseconds.
+    @return No return value.
+*/
+/**************************************************************************/
+	AcksenButton(const AcksenButtonVirtualInput& sInput, uint8_t uiButtonOperationMode, unsigned long ulDebounceInterval_MS);
+
+/**************************************************************************/
+/*!
+    @brief  Selects how the button's I/O pin is read.
+    @param  uiInputBackend
+            The input backend. Options are:
+			ACKSEN_BUTTON_INPUT_PORT - Read the pin's input register directly, with the register and bit mask resolved once (default on AVR, or where ACKSEN_BUTTON_ENABLE_PORT_INPUT is defined)
+			ACKSEN_BUTTON_INPUT_DIGITALREAD - Read the pin with digitalRead() on every refresh
+    @return Returns true if the backend was selected.
+			Returns false if the pin's input register is not read directly on this platform (see AcksenButtonHAL.h), or the button reads a virtual port.
+*/
+/**************************************************************************/
+	bool setInputBackend(uint8_t uiInputBackend);
 	
 /**************************************************************************/
 /*!
@@ -100,6 +316,89 @@ public:
 */
 /**************************************************************************/
 	void setDebounceInterval(unsigned long ulDebounceInterval_MS); 
+
+#if ACKSEN_BUTTON_DEBOUNCE_STRATEGIES
+
+/**************************************************************************/
+/*!
+    @brief  Sets the algorithm used to debounce the polled I/O pin.
+			Interrupt-driven edge capture (see setEdgeCapture()) always uses ACKSEN_BUTTON_DEBOUNCE_TIMESTAMP.
+    @param  uiDebounceStrategy
+            The debounce strategy. Options are:
+			ACKSEN_BUTTON_DEBOUNCE_TIMESTAMP - Accept a change once the debounce interval has passed since the last accepted change (default)
+			ACKSEN_BUTTON_DEBOUNCE_INTEGRATOR - Sample the input setDebounceSamples() times per debounce interval, counting up while HIGH and down while LOW, and accept a change when the count reaches either end
+			ACKSEN_BUTTON_DEBOUNCE_MAJORITY - Sample the input setDebounceSamples() times per debounce interval, and accept the level held by the majority of the most recent samples
+			ACKSEN_BUTTON_DEBOUNCE_LOCKOUT - Accept a change immediately, then ignore the input until it has been quiet for the debounce interval
+			ACKSEN_BUTTON_DEBOUNCE_ADAPTIVE - Accept a change once the input has been quiet for a window learned from the button's own bounce (see setAdaptiveDebounceBounds())
+    @return No return value.
+*/
+/**************************************************************************/
+	void setDebounceStrategy(uint8_t uiDebounceStrategy);
+
+/**************************************************************************/
+/*!
+    @brief  Sets the number of samples taken per debounce interval, for the Integrator and Majority strategies.
+    @param  uiDebounceSamples
+            Samples per debounce interval, from 1 to ACKSEN_BUTTON_MAX_DEBOUNCE_SAMPLES (default DEFAULT_DEBOUNCE_SAMPLES).
+    @return No return value.
+*/
+/**************************************************************************/
+	void setDebounceSamples(uint8_t uiDebounceSamples);
+
+/**************************************************************************/
+/*!
+    @brief  Sets the limits of the window learned by the Adaptive debounce strategy.
+			The window starts at the debounce interval. After each accepted change it shrinks towards twice the
+			longest gap seen between bounces, and it grows straight away if a change turns out to have been
+			accepted in the middle of a bounce.
+    @param  uiMinimum_MS
+            The shortest window, in milliseconds (default DEFAULT_ADAPTIVE_DEBOUNCE_MINIMUM). Glitches shorter than this are always rejected.
+    @param  uiMaximum_MS
+            The longest window, in milliseconds (default DEFAULT_ADAPTIVE_DEBOUNCE_MAXIMUM).
+    @return No return value.
+*/
+/**************************************************************************/
+	void setAdaptiveDebounceBounds(uint16_t uiMinimum_MS, uint16_t uiMaximum_MS);
+
+/**************************************************************************/
+/*!
+    @brief  Returns the window presently used by the Adaptive debounce strategy.
+    @return Returns the learned debounce window, in milliseconds.
+*/
+/**************************************************************************/
+	unsigned long getLearnedDebounceInterval();
+
+#endif
+
+/**************************************************************************/
+/*!
+    @brief  Selects the clock that times the button.
+			In the microsecond time base, refreshStatus() and captureEdge() read micros() instead of millis(), and
+			every time and interval the button takes or returns - the debounce, long press, repeat and acceleration
+			intervals, refreshStatus(ulNow_MS), getNextDeadline(), getTimeFromLastStateChange(), event timestamps and
+			adaptive bounds - is in microseconds, so switches can be debounced in well under a millisecond.
+			Intervals already set are converted to the new base, so the defaults keep their durations. Acceleration
+			curve tables stay in milliseconds. Adaptive bounds are 16-bit, so limited to 65535us. All comparisons are
+			wrap-safe, so timing is unaffected by micros() rolling over (every 71 minutes on 32-bit cores).
+			Call while the button is idle (e.g. in setup()) - its timers restart from the present time.
+			The initial time base of every button is set by ACKSEN_BUTTON_TIME_BASE. AcksenButtonTimerWheel,
+			AcksenButtonGestures and AcksenButtonEncoder::setSwitch() time in milliseconds, so only accept buttons in
+			the millisecond time base.
+    @param  uiTimeBase
+            The time base. Options are:
+			ACKSEN_BUTTON_TIME_MILLIS - Time the button in milliseconds, with millis() (default)
+			ACKSEN_BUTTON_TIME_MICROS - Time the button in microseconds, with micros()
+    @return No return value.
+*/
+/**************************************************************************/
+	void setTimeBase(uint8_t uiTimeBase);
+
+/**************************************************************************/
+/*!
+    @brief  Returns the button's time base, ACKSEN_BUTTON_TIME_MILLIS or ACKSEN_BUTTON_TIME_MICROS.
+*/
+/**************************************************************************/
+	uint8_t getTimeBase();
 	
 /**************************************************************************/
 /*!
@@ -109,6 +408,18 @@ public:
 */
 /**************************************************************************/
 	bool refreshStatus(); 
+
+/**************************************************************************/
+/*!
+    @brief  Updates the Button states, using the state of the assigned Arduino I/O Pin and a time supplied by the caller.
+			Lets a scan of many buttons read the clock once, so every button sees the same time (see AcksenButtonGroup).
+    @param  ulNow_MS
+            The present time, in milliseconds (i.e. the value of millis() at the start of the scan).
+    @return Returns true if the state changed.
+			Returns false if the state did not change.
+*/
+/**************************************************************************/
+	bool refreshStatus(unsigned long ulNow_MS); 
 	
 /**************************************************************************/
 /*!
@@ -160,6 +471,33 @@ public:
 /**************************************************************************/
 	void setAccelerationInitialOffsetDelay(unsigned long ulAccelerationInitialOffsetDelay_MS);
 	
+#if ACKSEN_BUTTON_ACCELERATION_CURVES
+
+/**************************************************************************/
+/*!
+    @brief  Set an Acceleration Curve, replacing the two-stage Accelerate mode timing with a table of intervals.
+			After the Repeat Initial Offset Delay, the interval to each further press is looked up by the number of
+			repeats so far, holding at the last entry. Tables can be generated at compile time (see AcksenButtonCurve.h).
+    @param  pauiCurve
+            The table of intervals, in milliseconds, declared PROGMEM. It is not copied, so must outlive the button.
+			NULL returns to the two-stage timing.
+    @param  uiLength
+            The number of entries in the table.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setAccelerationCurve(const uint16_t* pauiCurve, uint8_t uiLength);
+
+#endif
+	
+/**************************************************************************/
+/*!
+    @brief  Returns the number of repeated presses since the button was pressed (Repeat and Accelerate modes),
+			e.g. to increase the step applied to a value as it accelerates. Saturates at 65535.
+*/
+/**************************************************************************/
+	uint16_t getRepeatCount();
+	
 	
 /**************************************************************************/
 /*!
@@ -225,15 +563,184 @@ public:
 */
 /**************************************************************************/
 	bool onReleased();
+
+/**************************************************************************/
+/*!
+    @brief  Returns the next time the button needs refreshStatus() to be called, other than on a pin change.
+			This is the earliest of: the end of the debounce interval (while the input differs from the debounced
+			state), the Long Press interval, and the next repeat/acceleration press. Together with a pin-change
+			wakeup, it allows a scheduler to sleep instead of calling refreshStatus() continuously.
+    @param  ulDeadline_MS
+            Receives the deadline, in milliseconds. It may already have passed, in which case a refresh is due now.
+    @return Returns true if a deadline was set.
+			Returns false if nothing will happen until the input changes.
+*/
+/**************************************************************************/
+	bool getNextDeadline(unsigned long& ulDeadline_MS);
+
+#if ACKSEN_BUTTON_EDGE_CAPTURE
+
+/**************************************************************************/
+/*!
+    @brief  Enables or disables interrupt-driven edge capture.
+			When enabled, refreshStatus() no longer reads the I/O pin. Instead captureEdge() must be called from a
+			pin-change interrupt, and refreshStatus() debounces the captured edges using the time each edge occurred,
+			so presses are not missed, or their timing distorted, when the main loop is slow to call refreshStatus().
+    @param  pEdgeRing
+            The ring that captured edges are passed through (one per button), or NULL to return to polling the pin.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setEdgeCapture(AcksenButtonEdgeRing* pEdgeRing);
+
+/**************************************************************************/
+/*!
+    @brief  Captures the present level of the I/O pin, with a timestamp, into the edge ring.
+			Intended to be called from a pin-change (CHANGE) interrupt handler attached to the button pin.
+			Calls where the level has not changed since the last captured edge are ignored.
+			If the ring is full, the edge is dropped and counted by the ring's getOverflowCount(). Once the ring has
+			been drained, refreshStatus() then reads the pin to recover the level that was lost.
+    @return No return value.
+*/
+/**************************************************************************/
+	void captureEdge();
+
+#endif
+
+#if ACKSEN_BUTTON_EVENTS
+
+/**************************************************************************/
+/*!
+    @brief  Attaches an event queue to the button.
+			While attached, refreshStatus() records every press, release, long press and repeat press into the queue,
+			with the time it occurred. Unlike onPressed()/onReleased(), which only hold the result of the most recent
+			refresh, queued events are kept until read with pollEvent(), so bursts can be processed in batches.
+			onPressed(), onReleased() and onLongPress() continue to work alongside the queue.
+    @param  pEventQueue
+            The queue to record events into (one per button), or NULL to stop recording events.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setEventQueue(AcksenButtonEventQueue* pEventQueue);
+
+/**************************************************************************/
+/*!
+    @brief  Publishes the button's events to a channel, for a scanner/consumer split between tasks, threads or cores.
+			While attached, refreshStatus() pushes every press, release, long press and repeat press into the
+			channel, tagged with the button's id. The channel is a lock-free single-producer/single-consumer ring, so
+			one task may call refreshStatus() for any number of buttons while another pops their events from the
+			channel, without locks. The consuming task must only use the channel - onPressed(), onReleased(),
+			onLongPress(), getButtonState() and pollEvent() belong to the scanning task. Give each consumer its own
+			channel. Events published to a full channel are dropped, and counted by its getOverflowCount().
+			Call before the scanning task starts.
+    @param  pEventChannel
+            The channel to publish to (may be shared by any number of buttons with the same scanner and consumer), or
+			NULL to stop publishing.
+    @param  uiButtonId
+            The id carried by the button's events, to tell them apart from the other buttons on the channel.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setEventChannel(AcksenButtonEventChannel* pEventChannel, uint8_t uiButtonId);
+
+/**************************************************************************/
+/*!
+    @brief  Removes the oldest event from the attached event queue.
+    @param  sEvent
+            Receives the event.
+    @return Returns true if an event was returned.
+			Returns false if there are no events waiting, or no event queue is attached.
+*/
+/**************************************************************************/
+	bool pollEvent(AcksenButtonEvent& sEvent);
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of events dropped because the event queue was full (saturates at 255).
+*/
+/**************************************************************************/
+	uint8_t getEventOverflowCount();
+
+#endif
+
+#if ACKSEN_BUTTON_INSTRUMENTATION
+
+/**************************************************************************/
+/*!
+    @brief  Returns the statistics collected since the button was created, or resetStats() was called.
+*/
+/**************************************************************************/
+	const AcksenButtonStats& getStats();
+
+/**************************************************************************/
+/*!
+    @brief  Clears the statistics.
+    @return No return value.
+*/
+/**************************************************************************/
+	void resetStats();
+
+#endif
+
+#if ACKSEN_BUTTON_TRACE
+
+/**************************************************************************/
+/*!
+    @brief  Attaches a trace recorder, and records the button's present settings and time base. Call once the
+			button is configured, including its time base, after AcksenButtonTraceRecorder::begin().
+    @param  pTraceRecorder
+            The recorder to write to (may be shared by up to ACKSEN_BUTTON_TRACE_CHANNELS buttons), or NULL to stop recording.
+    @param  uiChannel
+            The button's channel in the trace, 0 to 15.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setTraceRecorder(AcksenButtonTraceRecorder* pTraceRecorder, uint8_t uiChannel);
+
+#endif
   
 protected:
   
-  bool checkDebounceStatus();
+  void initialise(uint8_t uiButtonOperationMode, unsigned long ulDebounceInterval_MS);
+  
+  // Reads the clock of the selected time base
+  unsigned long getTime() { return (uiTimeBase == ACKSEN_BUTTON_TIME_MICROS) ? AcksenButtonHAL::getMicros() : AcksenButtonHAL::getMillis(); }
+  
+  void convertIntervals(uint8_t uiTimeBase);
+  
+  // Reads the input through the selected backend
+  bool readInput() { return (pInputRegister != NULL) ? ((*pInputRegister & uiInputMask) != 0) : AcksenButtonHAL::readPin(uiButtonPin); }
+  
+  // Counts a repeated press, saturating
+  void countRepeat() { if (uiRepeatCount < 0xFFFF) { uiRepeatCount++; } }
+
+#if ACKSEN_BUTTON_INSTRUMENTATION
+  void instrumentRefresh(unsigned long ulNow_MS);
+  void instrumentRawEdge(bool bLevel, unsigned long ulEdge_MS);
+  void instrumentLatency(unsigned long ulLatency_MS);
+#endif
+  
+  bool checkDebounceStatus(unsigned long ulNow_MS);
+#if ACKSEN_BUTTON_EDGE_CAPTURE
+  bool checkCapturedEdges(unsigned long ulNow_MS);
+#endif
+#if ACKSEN_BUTTON_DEBOUNCE_STRATEGIES
+  bool checkSampledDebounce(bool bNewButtonState, unsigned long ulNow_MS);
+  bool checkLockoutDebounce(bool bNewButtonState, unsigned long ulNow_MS);
+  bool checkAdaptiveDebounce(bool bNewButtonState, unsigned long ulNow_MS);
+  void learnDebounceInterval(unsigned long ulBounceGap_MS, bool bImmediate);
+  void resetDebounceHistory();
+  bool isDebounceHistorySettled();
+  unsigned long getDebounceSamplePeriod();
+#endif
+  void acceptStateChange(bool bNewButtonState, unsigned long ulChangeTime_MS);
+  void recordEvent(uint8_t uiType, unsigned long ulTimestamp_MS);
   
   uint8_t uiButtonOperationMode;
+  uint8_t uiTimeBase = ACKSEN_BUTTON_TIME_MILLIS;
   
   unsigned long ulLastStatusUpdate_MS;
-  unsigned long ulDebounceInterval_MS;
+  unsigned long ulDebounceInterval_MS = 0;	// Set by initialise(), after the default intervals are converted to the starting time base
   unsigned long ulLongPressInterval_MS = DEFAULT_LONG_PRESS_INTERVAL;
   
   bool bDebouncedButtonState;
@@ -251,9 +758,65 @@ protected:
   unsigned long ulRepeatPressesPeriodEnd;
   unsigned long ulButtonOperationStart;
   
+#if ACKSEN_BUTTON_ACCELERATION_CURVES
+  // Acceleration curve - a PROGMEM table indexed by uiRepeatCount
+  const uint16_t* pauiAccelerationCurve = NULL;
+  uint8_t uiAccelerationCurveLength = 0;
+#endif
+  uint16_t uiRepeatCount;
+  
   
   uint8_t uiButtonPin;
   
+  // Input backend - digitalRead() is used while pInputRegister is NULL
+  const volatile AcksenButtonPort_t* pInputRegister = NULL;
+  AcksenButtonPort_t uiInputMask = 0;
+  
+#if ACKSEN_BUTTON_DEBOUNCE_STRATEGIES
+  // Debounce strategy
+  uint8_t uiDebounceStrategy = ACKSEN_BUTTON_DEBOUNCE_TIMESTAMP;
+  uint8_t uiDebounceSamples = DEFAULT_DEBOUNCE_SAMPLES;
+  uint16_t uiDebounceHistory;			// Integrator count, Majority shift register (newest sample in bit 0), or Adaptive longest gap in the present bounce (same units as the adaptive bounds)
+  bool bLastRawLevel;					// Last level seen by the Lockout and Adaptive strategies
+  unsigned long ulDebounceTimer_MS;		// Time of the last sample, start of the Lockout, or last Adaptive edge
+  
+  // Adaptive debounce
+  uint16_t uiAdaptiveMinimum_MS = DEFAULT_ADAPTIVE_DEBOUNCE_MINIMUM;
+  uint16_t uiAdaptiveMaximum_MS = DEFAULT_ADAPTIVE_DEBOUNCE_MAXIMUM;
+  uint16_t uiLearnedDebounce_MS;
+  bool bAdaptiveConfirming;			// A change has been accepted, and no edge seen since
+#endif
+  
+#if ACKSEN_BUTTON_EDGE_CAPTURE
+  // Interrupt-driven edge capture
+  AcksenButtonEdgeRing* pEdgeRing = NULL;
+  volatile uint8_t uiCapturedLevel;	// Last level pushed by captureEdge(), or ACKSEN_BUTTON_CAPTURED_LEVEL_UNKNOWN once an edge has been dropped - ISR side only
+  bool bRawButtonState;				// Last raw level drained from the ring
+  unsigned long ulRawStateChange_MS;	// Time bRawButtonState was captured
+#endif
+  
+#if ACKSEN_BUTTON_EVENTS
+  AcksenButtonEventQueue* pEventQueue = NULL;
+  
+  AcksenButtonEventChannel* pEventChannel = NULL;
+  uint8_t uiEventChannelId = 0;
+#endif
+
+#if ACKSEN_BUTTON_INSTRUMENTATION
+  AcksenButtonStats sStats;
+  bool bInstrumentRawLevel;				// Last raw level seen
+  bool bInstrumentEdgePending;			// The raw level differs from the debounced state
+  unsigned long ulInstrumentEdge_MS;		// First raw edge since the raw level last matched the debounced state
+  unsigned long ulInstrumentEvent_MS;		// Start of the last press or repeat, for latency
+  unsigned long ulInstrumentRefresh_MS;	// Time of the last refreshStatus()
+#endif
+
+#if ACKSEN_BUTTON_TRACE
+  AcksenButtonTraceRecorder* pTraceRecorder = NULL;
+  uint8_t uiTraceChannel;
+  bool bTraceRawLevel;					// Last raw level recorded
+#endif
+  
 };
 
 #endif
@@ -0,0 +1,319 @@
+/*!
+@file AcksenButtonAnalog.h
+
+*/
+
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+// Resistor ladder (analog keypad) input for the Acksen Button Library.
+//
+// AcksenButtonAnalog reads several buttons sharing one analog pin through a resistor ladder, where each button
+// pulls the pin to a different voltage. Each ADC reading is classified into a key with a threshold table, built
+// once from the nominal reading of every key, and a key is only accepted once a number of consecutive readings
+// agree, which rejects noise and the readings passed through while the voltage moves between levels.
+//
+// Each key is an ordinary AcksenButton reading its bit of the result (see AcksenButtonVirtualInput), so every mode,
+// debounce strategy and event queue still applies. Call update() as often as convenient - it never waits for the
+// ADC, but collects a finished conversion and starts the next one. Ladders on different pins share the ADC in turn:
+// a ladder that finds the ADC in use is queued, and each finished conversion hands the ADC to the next queued ladder,
+// so a ladder updated less often than the others is slowed down, but never starved.
+// A ladder reports one key at a time, normally the one nearest the ground end of the ladder.
+
+#ifndef AcksenButtonAnalog_h
+#define AcksenButtonAnalog_h
+
+#include "AcksenButtonHAL.h"
+#include "AcksenButton.h"
+
+#define DEFAULT_ANALOG_FILTER_SAMPLES		4		///< Consecutive readings that must agree before a key changes
+#define ACKSEN_BUTTON_ANALOG_NO_KEY			0xFF	///< Returned by getKey() while no key is pressed
+#define ACKSEN_BUTTON_ANALOG_MAX_LADDERS	16		///< Ladders that take separate turns on the ADC - further ladders share the turns of the first ones
+#define ACKSEN_BUTTON_ANALOG_NO_LADDER		0xFF	///< Owner of the ADC while it is free for any ladder
+
+// The ADC is shared by every ladder - one conversion runs at a time, and the ladders take turns
+struct AcksenButtonAnalogAdc
+{
+	uint8_t uiLadders = 0;									///< Ladders constructed so far, each given the next turn
+	uint8_t uiOwner = ACKSEN_BUTTON_ANALOG_NO_LADDER;		///< Ladder whose conversion is running, or that the ADC has been handed to
+	bool bBusy = false;										///< A conversion has been started and not yet collected
+	uint16_t uiWaiting = 0;									///< One bit per ladder that found the ADC in use, and is waiting for its turn
+};
+
+inline AcksenButtonAnalogAdc& acksenButtonAnalogAdc()
+{
+	static AcksenButtonAnalogAdc sAdc;
+
+	return sAdc;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Class that defines the buttons of a resistor ladder on one analog pin, read by AcksenButton instances
+    @tparam KEYS
+            The number of buttons on the ladder.
+*/
+/**************************************************************************/
+template <uint8_t KEYS>
+class AcksenButtonAnalog
+{
+
+public:
+
+/**************************************************************************/
+/*!
+    @brief  Class initialisation.
+    @param  uiAnalogPin
+            The analog pin the ladder is connected to.
+    @param  auiKeyLevels
+            The nominal ADC reading while each key is pressed, KEYS entries in any order.
+    @param  uiIdleLevel
+            The nominal ADC reading while no key is pressed.
+    @return No return value.
+*/
+/**************************************************************************/
+	AcksenButtonAnalog(uint8_t uiAnalogPin, const uint16_t* auiKeyLevels, uint16_t uiIdleLevel) : uiAnalogPin(uiAnalogPin)
+	{
+		static_assert((KEYS >= 1) && (KEYS < ACKSEN_BUTTON_ANALOG_NO_KEY), "AcksenButtonAnalog KEYS must be from 1 to 254");
+
+		AcksenButtonHAL::setPinMode(uiAnalogPin, INPUT);
+
+		uiLadder = (uint8_t)(acksenButtonAnalogAdc().uiLadders++ % ACKSEN_BUTTON_ANALOG_MAX_LADDERS);
+
+		setKeyLevels(auiKeyLevels, uiIdleLevel);
+		uiFilterSamples = DEFAULT_ANALOG_FILTER_SAMPLES;
+		uiCandidateKey = ACKSEN_BUTTON_ANALOG_NO_KEY;
+		uiCandidateCount = 0;
+		uiKey = ACKSEN_BUTTON_ANALOG_NO_KEY;
+		uiLastReading = uiIdleLevel;
+		bConverting = false;
+
+		for (uint8_t uiWord = 0; uiWord < WORDS; uiWord++)
+		{
+			auiInputs[uiWord] = 0;
+		}
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Rebuilds the threshold table, e.g. after calibration. Each threshold lies midway between adjacent levels.
+    @param  auiKeyLevels
+            The nominal ADC reading while each key is pressed, KEYS entries in any order.
+    @param  uiIdleLevel
+            The nominal ADC reading while no key is pressed.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setKeyLevels(const uint16_t* auiKeyLevels, uint16_t uiIdleLevel)
+	{
+		uint16_t auiLevels[KEYS + 1];
+
+		// Insertion sort of the levels, carrying the key each belongs to
+		for (uint8_t i = 0; i <= KEYS; i++)
+		{
+			uint16_t uiLevel = (i < KEYS) ? auiKeyLevels[i] : uiIdleLevel;
+			uint8_t j = i;
+
+			while ((j > 0) && (auiLevels[j - 1] > uiLevel))
+			{
+				auiLevels[j] = auiLevels[j - 1];
+				auiOrder[j] = auiOrder[j - 1];
+				j--;
+			}
+
+			auiLevels[j] = uiLevel;
+			auiOrder[j] = (i < KEYS) ? i : ACKSEN_BUTTON_ANALOG_NO_KEY;
+		}
+
+		for (uint8_t i = 0; i < KEYS; i++)
+		{
+			auiThresholds[i] = (uint16_t)(((uint32_t)auiLevels[i] + auiLevels[i + 1] + 1) / 2);
+		}
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Sets the number of consecutive readings that must agree before the key reported changes.
+    @param  uiFilterSamples
+            The number of readings, from 1 (no filtering) upwards. Default is 4.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setFilterSamples(uint8_t uiFilterSamples) { this->uiFilterSamples = (uiFilterSamples > 0) ? uiFilterSamples : 1; }
+
+/**************************************************************************/
+/*!
+    @brief  Returns the input of one key, for constructing the AcksenButton that reads it.
+    @param  uiKey
+            The key, from 0 to KEYS-1, as ordered in the level table.
+*/
+/**************************************************************************/
+	AcksenButtonVirtualInput getInput(uint8_t uiKey)
+	{
+		return AcksenButtonVirtualInput(&auiInputs[uiKey / 8], (AcksenButtonPort_t)(1 << (uiKey % 8)));
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Collects a finished ADC conversion, if there is one, and starts the next. Never waits for the ADC.
+			While other ladders are waiting, the ADC is handed to the next of them instead, and this ladder's next
+			conversion starts once each of them has had its turn. A ladder handed the ADC starts its conversion at its
+			next update(), so call update() for every ladder regularly.
+    @return Returns true if a new reading was taken (and the key inputs may have changed).
+			Returns false if the conversion is still running, or the ADC is in use by another ladder.
+*/
+/**************************************************************************/
+	bool update()
+	{
+		AcksenButtonAnalogAdc& sAdc = acksenButtonAnalogAdc();
+		bool bSampled = false;
+
+		if (bConverting)
+		{
+			if (!AcksenButtonHAL::isAnalogReadComplete())
+			{
+				return false;
+			}
+
+			uiLastReading = AcksenButtonHAL::getAnalogResult();
+			bConverting = false;
+			sAdc.bBusy = false;
+			sAdc.uiOwner = nextWaiting(sAdc);
+
+			filterKey(classify(uiLastReading));
+			bSampled = true;
+		}
+
+		// Start the next conversion if the ADC is free, or has been handed to this ladder, otherwise wait for a turn
+		if (!sAdc.bBusy && ((sAdc.uiOwner == ACKSEN_BUTTON_ANALOG_NO_LADDER) || (sAdc.uiOwner == uiLadder)))
+		{
+			AcksenButtonHAL::startAnalogRead(uiAnalogPin);
+			bConverting = true;
+			sAdc.bBusy = true;
+			sAdc.uiOwner = uiLadder;
+			sAdc.uiWaiting &= (uint16_t)~(1U << uiLadder);
+		}
+		else if (!bConverting)
+		{
+			sAdc.uiWaiting |= (uint16_t)(1U << uiLadder);
+		}
+
+		return bSampled;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Returns the key currently accepted, from 0 to KEYS-1, or ACKSEN_BUTTON_ANALOG_NO_KEY.
+*/
+/**************************************************************************/
+	uint8_t getKey() { return uiKey; }
+
+/**************************************************************************/
+/*!
+    @brief  Returns the last ADC reading, before classification, e.g. for calibrating the key levels.
+*/
+/**************************************************************************/
+	uint16_t getLastReading() { return uiLastReading; }
+
+protected:
+
+	static const uint8_t WORDS = (KEYS + 7) / 8;
+
+	// Returns the first waiting ladder after this one, in turn order, or ACKSEN_BUTTON_ANALOG_NO_LADDER if none is waiting
+	uint8_t nextWaiting(const AcksenButtonAnalogAdc& sAdc)
+	{
+		for (uint8_t i = 1; i <= ACKSEN_BUTTON_ANALOG_MAX_LADDERS; i++)
+		{
+			uint8_t uiNext = (uint8_t)((uiLadder + i) % ACKSEN_BUTTON_ANALOG_MAX_LADDERS);
+
+			if (sAdc.uiWaiting & (1U << uiNext))
+			{
+				return uiNext;
+			}
+		}
+
+		return ACKSEN_BUTTON_ANALOG_NO_LADDER;
+	}
+
+	// Binary search of the threshold table, returning the key whose band holds the reading
+	uint8_t classify(uint16_t uiReading)
+	{
+		uint8_t uiLow = 0;
+		uint8_t uiHigh = KEYS;
+
+		while (uiLow < uiHigh)
+		{
+			uint8_t uiMiddle = (uint8_t)((uiLow + uiHigh) / 2);
+
+			if (uiReading < auiThresholds[uiMiddle])
+			{
+				uiHigh = uiMiddle;
+			}
+			else
+			{
+				uiLow = (uint8_t)(uiMiddle + 1);
+			}
+		}
+
+		return auiOrder[uiLow];
+	}
+
+	void filterKey(uint8_t uiReadingKey)
+	{
+		if (uiReadingKey != uiCandidateKey)
+		{
+			uiCandidateKey = uiReadingKey;
+			uiCandidateCount = 0;
+		}
+
+		if (uiCandidateCount < uiFilterSamples)
+		{
+			uiCandidateCount++;
+		}
+
+		if ((uiCandidateCount >= uiFilterSamples) && (uiCandidateKey != uiKey))
+		{
+			if (uiKey != ACKSEN_BUTTON_ANALOG_NO_KEY)
+			{
+				auiInputs[uiKey / 8] &= (AcksenButtonPort_t)~(1 << (uiKey % 8));
+			}
+
+			if (uiCandidateKey != ACKSEN_BUTTON_ANALOG_NO_KEY)
+			{
+				auiInputs[uiCandidateKey / 8] |= (AcksenButtonPort_t)(1 << (uiCandidateKey % 8));
+			}
+
+			uiKey = uiCandidateKey;
+		}
+	}
+
+	uint8_t uiAnalogPin;
+	uint8_t uiLadder;					///< Turn of the ladder on the shared ADC
+	uint8_t uiFilterSamples;
+	uint8_t uiCandidateKey;
+	uint8_t uiCandidateCount;
+	uint8_t uiKey;
+	bool bConverting;
+	uint16_t uiLastReading;
+
+	uint16_t auiThresholds[KEYS];		///< Upper bound (exclusive) of each band, ascending
+	uint8_t auiOrder[KEYS + 1];			///< Key of each band, ascending, including ACKSEN_BUTTON_ANALOG_NO_KEY
+
+	volatile AcksenButtonPort_t auiInputs[WORDS];		///< One bit per key - read by the keys' AcksenButtons
+
+};
+
+#endif
@@ -0,0 +1,484 @@
+/*!
+@file AcksenButtonBank.h
+
+*/
+
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+// Bit-parallel button bank for the Acksen Button Library.
+//
+// Debounces up to 8/16/32/64 inputs held in a single word (e.g. a whole I/O port) in one pass, using
+// SWAR vertical counters: each lane has a 2-bit counter spread across two words, so a handful of bitwise
+// operations advance every lane at once. A lane changes state once its input has disagreed with the
+// debounced state for four consecutive samples, with samples taken every quarter of the debounce interval.
+//
+// The per-button modes (Long Press, Repeat, Accelerate) are available per lane. Timed processing only
+// visits lanes that are held down in a timed mode, so idle lanes cost nothing beyond the bitwise pass.
+
+#ifndef AcksenButtonBank_h
+#define AcksenButtonBank_h
+
+#include "AcksenButtonHAL.h"
+#include "AcksenButton.h"
+
+#define ACKSEN_BUTTON_BANK_SAMPLES		4		///< Consecutive samples a lane must disagree for before it changes state
+
+/**************************************************************************/
+/*!
+    @brief  Class that defines a bank of buttons debounced in parallel, one per bit of the input word
+    @tparam T
+            Unsigned integer type holding one bit per button (uint8_t, uint16_t, uint32_t or uint64_t).
+*/
+/**************************************************************************/
+template <typename T>
+class AcksenButtonBank
+{
+
+public:
+
+	static const uint8_t LANES = sizeof(T) * 8;		///< Number of buttons handled by the bank
+
+/**************************************************************************/
+/*!
+    @brief  Class initialisation.
+            All lanes start released, in ACKSEN_BUTTON_MODE_NORMAL.
+    @param  ulDebounceInterval_MS
+            The debounce interval applied to every lane, in milliseconds.
+    @return No return value.
+*/
+/**************************************************************************/
+	AcksenButtonBank(unsigned long ulDebounceInterval_MS)
+	{
+		uState = 0;
+		uCount0 = 0;
+		uCount1 = 0;
+		uInvertMask = 0;
+
+		uLongPressModeMask = 0;
+		uRepeatModeMask = 0;
+		uAccelerateModeMask = 0;
+
+		uPressedMask = 0;
+		uReleasedMask = 0;
+		uRepeatMask = 0;
+		uUnreportedMask = 0;
+		uLongPressRecordedMask = 0;
+		uLongPressProcessedMask = 0;
+
+		ulLastSample_MS = AcksenButtonHAL::getMillis();
+
+		// Every lane is timed from construction, until its first state change or mode change
+		for (uint8_t uiLane = 0; uiLane < LANES; uiLane++)
+		{
+			aulLastStateChange_MS[uiLane] = ulLastSample_MS;
+			aulRepeatPressesPeriodEnd[uiLane] = ulLastSample_MS + ulRepeatInitialOffsetDelay_MS;
+		}
+
+		setDebounceInterval(ulDebounceInterval_MS);
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Sets the Debounce interval applied to every lane.
+    @param  ulDebounceInterval_MS
+            The debounce interval, in milliseconds. Inputs are sampled every quarter of this interval.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setDebounceInterval(unsigned long ulDebounceInterval_MS)
+	{
+		ulSampleInterval_MS = ulDebounceInterval_MS / ACKSEN_BUTTON_BANK_SAMPLES;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Selects lanes whose input is active-low (e.g. INPUT_PULLUP buttons switching to ground).
+    @param  uInvertMask
+            Lanes with a bit set are inverted before debouncing, so a LOW input reads as pressed.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setInputInversion(T uInvertMask)
+	{
+		this->uInvertMask = uInvertMask;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Sets the Operating Mode of a single lane.
+    @param  uiLane
+            The lane (bit number) to change. Lanes from LANES upwards are ignored.
+    @param  uiButtonOperationMode
+            One of the ACKSEN_BUTTON_MODE_* constants.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setLaneOperatingMode(uint8_t uiLane, uint8_t uiButtonOperationMode)
+	{
+		if (uiLane >= LANES)
+		{
+			return;
+		}
+
+		T uBit = (T)1 << uiLane;
+
+		uLongPressModeMask &= (T)~uBit;
+		uRepeatModeMask &= (T)~uBit;
+		uAccelerateModeMask &= (T)~uBit;
+
+		if (uiButtonOperationMode == ACKSEN_BUTTON_MODE_LONGPRESS)
+		{
+			uLongPressModeMask |= uBit;
+		}
+		else if (uiButtonOperationMode == ACKSEN_BUTTON_MODE_REPEAT)
+		{
+			uRepeatModeMask |= uBit;
+		}
+		else if (uiButtonOperationMode == ACKSEN_BUTTON_MODE_ACCELERATE)
+		{
+			uAccelerateModeMask |= uBit;
+		}
+
+		// A held lane in a newly timed mode starts timing from now
+		aulLastStateChange_MS[uiLane] = AcksenButtonHAL::getMillis();
+		aulRepeatPressesPeriodEnd[uiLane] = aulLastStateChange_MS[uiLane] + ulRepeatInitialOffsetDelay_MS;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Sets the Long Press interval shared by all lanes.
+    @param  ulLongPressInterval_MS
+            The long press interval applied to every lane in Long Press mode, in milliseconds.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setLongPressInterval(unsigned long ulLongPressInterval_MS)
+	{
+		this->ulLongPressInterval_MS = ulLongPressInterval_MS;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Sets the Repeat Presses interval shared by all lanes.
+    @param  ulRepeatPressesInterval_MS
+            The repeat presses interval applied to every lane in Repeat or Accelerate mode, in milliseconds.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setRepeatPressesInterval(unsigned long ulRepeatPressesInterval_MS)
+	{
+		this->ulRepeatPressesInterval_MS = ulRepeatPressesInterval_MS;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Sets the Repeat Initial Offset Delay shared by all lanes.
+    @param  ulRepeatInitialOffsetDelay_MS
+            The repeat presses initial offset delay applied to every lane in Repeat or Accelerate mode, in milliseconds.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setRepeatInitialOffsetDelay(unsigned long ulRepeatInitialOffsetDelay_MS)
+	{
+		this->ulRepeatInitialOffsetDelay_MS = ulRepeatInitialOffsetDelay_MS;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Sets the Acceleration Presses interval shared by all lanes.
+    @param  ulAccelerationPressesInterval_MS
+            The repeat presses acceleration rate applied to every lane in Accelerate mode, in milliseconds.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setAccelerationPressesInterval(unsigned long ulAccelerationPressesInterval_MS)
+	{
+		this->ulAccelerationPressesInterval_MS = ulAccelerationPressesInterval_MS;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Sets the Acceleration Initial Offset Delay shared by all lanes.
+    @param  ulAccelerationInitialOffsetDelay_MS
+            The acceleration initial offset delay applied to every lane in Accelerate mode, in milliseconds.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setAccelerationInitialOffsetDelay(unsigned long ulAccelerationInitialOffsetDelay_MS)
+	{
+		this->ulAccelerationInitialOffsetDelay_MS = ulAccelerationInitialOffsetDelay_MS;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Updates every lane from a raw input word, using the current time.
+    @param  uRawInput
+            The raw input levels, one bit per lane (e.g. the value of an input port register).
+    @return Returns a mask of the lanes that changed state or fired a repeat press.
+*/
+/**************************************************************************/
+	T refreshStatus(T uRawInput)
+	{
+		return refreshStatus(uRawInput, AcksenButtonHAL::getMillis());
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Updates every lane from a raw input word.
+    @param  uRawInput
+            The raw input levels, one bit per lane (e.g. the value of an input port register).
+    @param  ulNow_MS
+            The present time, in milliseconds.
+    @return Returns a mask of the lanes that changed state or fired a repeat press.
+*/
+/**************************************************************************/
+	T refreshStatus(T uRawInput, unsigned long ulNow_MS)
+	{
+		T uToggle = 0;
+
+		// Vertical counter debounce - only clocked once per sample interval
+		if (ulNow_MS - ulLastSample_MS >= ulSampleInterval_MS)
+		{
+			ulLastSample_MS = ulNow_MS;
+
+			T uDelta = (uRawInput ^ uInvertMask) ^ uState;
+
+			uCount1 = (uCount1 ^ uCount0) & uDelta;
+			uCount0 = (T)~uCount0 & uDelta;
+			uToggle = uDelta & (T)~(uCount0 | uCount1);
+
+			uState ^= uToggle;
+		}
+
+		uPressedMask = uToggle & uState;
+		uReleasedMask = uToggle & (T)~uState;
+		uRepeatMask = 0;
+
+		// Long Press latches are cleared as soon as a lane is released
+		uLongPressRecordedMask &= uState;
+		uLongPressProcessedMask &= uState;
+
+		// Record the time of the state change for lanes in timed modes
+		T uTimedModeMask = uLongPressModeMask | uRepeatModeMask | uAccelerateModeMask;
+		T uLanes = uToggle & uTimedModeMask;
+
+		while (uLanes != 0)
+		{
+			uint8_t uiLane = lowestLane(uLanes);
+			uLanes &= uLanes - 1;
+
+			aulLastStateChange_MS[uiLane] = ulNow_MS;
+			aulRepeatPressesPeriodEnd[uiLane] = ulNow_MS + ulRepeatInitialOffsetDelay_MS;
+		}
+
+		// Service held lanes in timed modes (other than those that have just changed)
+		uLanes = uState & (T)~uToggle & (uRepeatModeMask | uAccelerateModeMask | (uLongPressModeMask & (T)~uLongPressRecordedMask));
+
+		while (uLanes != 0)
+		{
+			uint8_t uiLane = lowestLane(uLanes);
+			T uBit = (T)1 << uiLane;
+			uLanes &= uLanes - 1;
+
+			if (uLongPressModeMask & uBit)
+			{
+				if (ulNow_MS - aulLastStateChange_MS[uiLane] >= ulLongPressInterval_MS)
+				{
+					uLongPressRecordedMask |= uBit;
+				}
+			}
+			else if (!acksenButtonTimeBefore(ulNow_MS, aulRepeatPressesPeriodEnd[uiLane]))
+			{
+				if ((uAccelerateModeMask & uBit) && (ulNow_MS - aulLastStateChange_MS[uiLane] >= ulAccelerationInitialOffsetDelay_MS))
+				{
+					aulRepeatPressesPeriodEnd[uiLane] = ulNow_MS + ulAccelerationPressesInterval_MS;
+				}
+				else
+				{
+					aulRepeatPressesPeriodEnd[uiLane] = ulNow_MS + ulRepeatPressesInterval_MS;
+				}
+
+				uRepeatMask |= uBit;
+			}
+		}
+
+		// As with AcksenButton, press and release events are only available until the next refresh
+		uUnreportedMask = uToggle | uRepeatMask;
+
+		return uUnreportedMask;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Returns the lanes that transitioned from released to pressed in the last refresh.
+*/
+/**************************************************************************/
+	T getPressedMask() { return uPressedMask; }
+
+/**************************************************************************/
+/*!
+    @brief  Returns the lanes that transitioned from pressed to released in the last refresh.
+*/
+/**************************************************************************/
+	T getReleasedMask() { return uReleasedMask; }
+
+/**************************************************************************/
+/*!
+    @brief  Returns the debounced state of every lane (a set bit is held down).
+*/
+/**************************************************************************/
+	T getHeldMask() { return uState; }
+
+/**************************************************************************/
+/*!
+    @brief  Returns the lanes in Repeat or Accelerate mode that fired a repeat press in the last refresh.
+*/
+/**************************************************************************/
+	T getRepeatMask() { return uRepeatMask; }
+
+/**************************************************************************/
+/*!
+    @brief  Returns the debounced state of a single lane.
+    @param  uiLane
+            The lane (bit number) to check.
+    @return Returns true if the lane is held down.
+			Returns false for lanes from LANES upwards.
+*/
+/**************************************************************************/
+	bool getButtonState(uint8_t uiLane) { return (uiLane < LANES) && ((uState >> uiLane) & 1); }
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of milliseconds a lane in a timed mode has been in its present state.
+    @param  uiLane
+            The lane (bit number) to check. Returns 0 for lanes from LANES upwards.
+*/
+/**************************************************************************/
+	unsigned long getTimeFromLastStateChange(uint8_t uiLane) { return (uiLane < LANES) ? (AcksenButtonHAL::getMillis() - aulLastStateChange_MS[uiLane]) : 0; }
+
+/**************************************************************************/
+/*!
+    @brief  Per-lane equivalent of AcksenButton::onPressed().
+			Returns true once after the lane was pressed, or fired a repeat press, in the last refresh.
+    @param  uiLane
+            The lane (bit number) to check. Returns false for lanes from LANES upwards.
+*/
+/**************************************************************************/
+	bool onPressed(uint8_t uiLane) { return consume(uiLane, uPressedMask | uRepeatMask); }
+
+/**************************************************************************/
+/*!
+    @brief  Per-lane equivalent of AcksenButton::onReleased().
+			Returns true once after the lane was released in the last refresh.
+    @param  uiLane
+            The lane (bit number) to check. Returns false for lanes from LANES upwards.
+*/
+/**************************************************************************/
+	bool onReleased(uint8_t uiLane) { return consume(uiLane, uReleasedMask); }
+
+/**************************************************************************/
+/*!
+    @brief  Per-lane equivalent of AcksenButton::onLongPress().
+			Returns true once after a lane in Long Press mode has been held for the Long Press interval.
+    @param  uiLane
+            The lane (bit number) to check. Returns false for lanes from LANES upwards.
+*/
+/**************************************************************************/
+	bool onLongPress(uint8_t uiLane)
+	{
+		if (uiLane >= LANES)
+		{
+			return false;
+		}
+
+		T uBit = (T)1 << uiLane;
+
+		if ((uLongPressRecordedMask & (T)~uLongPressProcessedMask) & uBit)
+		{
+			uLongPressProcessedMask |= uBit;
+			return true;
+		}
+
+		return false;
+	}
+
+protected:
+
+	bool consume(uint8_t uiLane, T uEventMask)
+	{
+		if (uiLane >= LANES)
+		{
+			return false;
+		}
+
+		T uBit = (T)1 << uiLane;
+
+		if (uUnreportedMask & uEventMask & uBit)
+		{
+			uUnreportedMask &= (T)~uBit;
+			return true;
+		}
+
+		return false;
+	}
+
+	static uint8_t lowestLane(T uLanes)
+	{
+		return (uint8_t)__builtin_ctzll((unsigned long long)uLanes);
+	}
+
+	// Debounced state and vertical counter
+	T uState;
+	T uCount0;
+	T uCount1;
+	T uInvertMask;
+
+	// Lane modes
+	T uLongPressModeMask;
+	T uRepeatModeMask;
+	T uAccelerateModeMask;
+
+	// Events from the last refresh
+	T uPressedMask;
+	T uReleasedMask;
+	T uRepeatMask;
+	T uUnreportedMask;
+
+	T uLongPressRecordedMask;
+	T uLongPressProcessedMask;
+
+	unsigned long ulLastSample_MS;
+	unsigned long ulSampleInterval_MS;
+
+	unsigned long ulLongPressInterval_MS = DEFAULT_LONG_PRESS_INTERVAL;
+	unsigned long ulRepeatPressesInterval_MS = DEFAULT_REPEAT_PRESS_INTERVAL;
+	unsigned long ulRepeatInitialOffsetDelay_MS = DEFAULT_REPEAT_INITIAL_OFFSET_INTERVAL;
+	unsigned long ulAccelerationInitialOffsetDelay_MS = DEFAULT_ACCELERATION_INITIAL_OFFSET_INTERVAL;
+	unsigned long ulAccelerationPressesInterval_MS = DEFAULT_ACCELERATION_PRESSES_INTERVAL;
+
+	// Per-lane timing, only maintained for lanes in timed modes
+	unsigned long aulLastStateChange_MS[LANES];
+	unsigned long aulRepeatPressesPeriodEnd[LANES];
+
+};
+
+typedef AcksenButtonBank<uint8_t>	AcksenButtonBank8;		///< Bank of 8 buttons (e.g. one AVR port)
+typedef AcksenButtonBank<uint16_t>	AcksenButtonBank16;		///< Bank of 16 buttons
+typedef AcksenButtonBank<uint32_t>	AcksenButtonBank32;		///< Bank of 32 buttons
+typedef AcksenButtonBank<uint64_t>	AcksenButtonBank64;		///< Bank of 64 buttons
+
+#endif
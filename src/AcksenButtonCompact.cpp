@@ -0,0 +1,224 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+#include "AcksenButtonHAL.h"
+#include "AcksenButtonCompact.h"
+
+// Layout of uiFlags
+#define ACKSEN_COMPACT_DEBOUNCED_STATE			0x01	// Debounced button state
+#define ACKSEN_COMPACT_STATE_CHANGE_RECORDED	0x02	// Equivalent of AcksenButton::bStateChangeRecorded
+#define ACKSEN_COMPACT_ELAPSED_SATURATED		0x04	// Time since last state change has passed ACKSEN_BUTTON_COMPACT_MAX_INTERVAL
+#define ACKSEN_COMPACT_LONG_PRESS_RECORDED		0x08	// Long Press mode: bLongPressRecorded
+#define ACKSEN_COMPACT_LONG_PRESS_PROCESSED		0x10	// Long Press mode: bLongPressProcessed
+#define ACKSEN_COMPACT_REPEAT_STARTED			0x08	// Repeat/Accelerate modes: the initial offset delay has passed (shares a bit with Long Press mode)
+#define ACKSEN_COMPACT_REPEAT_ACCELERATED		0x10	// Accelerate mode: next repeat uses the acceleration interval (shares a bit with Long Press mode)
+#define ACKSEN_COMPACT_MODE_FLAGS				0x18	// Bits whose meaning depends on the mode
+#define ACKSEN_COMPACT_MODE_SHIFT				5		// Operating mode, bits 5-6
+#define ACKSEN_COMPACT_MODE_MASK				0x60
+
+AcksenButtonCompact::AcksenButtonCompact(uint8_t uiButtonPin, uint8_t uiButtonOperationMode, const AcksenButtonCompactConfig* pConfig, uint8_t uiButtonInputMode)
+{
+	
+	// Setup the I/O Button Pin
+	AcksenButtonHAL::setPinMode(uiButtonPin, uiButtonInputMode);
+	
+	this->uiButtonPin = uiButtonPin;
+	this->pConfig = pConfig;
+	
+	// Initialise internal variables
+	uiLastStateChange_MS = (uint16_t)AcksenButtonHAL::getMillis();
+	uiLastRepeat_MS = uiLastStateChange_MS;
+	uiFlags = AcksenButtonHAL::readPin(uiButtonPin) ? ACKSEN_COMPACT_DEBOUNCED_STATE : 0;
+	
+	setButtonOperatingMode(uiButtonOperationMode);
+	
+}
+
+void AcksenButtonCompact::setButtonOperatingMode(uint8_t uiButtonOperationMode)
+{
+	uiFlags = (uint8_t)((uiFlags & ~(ACKSEN_COMPACT_MODE_MASK | ACKSEN_COMPACT_MODE_FLAGS)) | ((uiButtonOperationMode << ACKSEN_COMPACT_MODE_SHIFT) & ACKSEN_COMPACT_MODE_MASK));
+}
+
+// Protected: Time since the last state change, saturating once it passes ACKSEN_BUTTON_COMPACT_MAX_INTERVAL
+uint16_t AcksenButtonCompact::getElapsed(uint16_t uiNow_MS)
+{
+	
+	if (uiFlags & ACKSEN_COMPACT_ELAPSED_SATURATED)
+	{
+		return 0xFFFF;
+	}
+	
+	uint16_t uiElapsed = (uint16_t)(uiNow_MS - uiLastStateChange_MS);
+	
+	if (uiElapsed > ACKSEN_BUTTON_COMPACT_MAX_INTERVAL)
+	{
+		uiFlags |= ACKSEN_COMPACT_ELAPSED_SATURATED;
+		return 0xFFFF;
+	}
+	
+	return uiElapsed;
+	
+}
+
+bool AcksenButtonCompact::refreshStatus()
+{
+	return refreshStatus(AcksenButtonHAL::getMillis());
+}
+
+// Mirrors AcksenButton::refreshStatus() and AcksenButton::checkDebounceStatus() step for step
+bool AcksenButtonCompact::refreshStatus(unsigned long ulNow_MS)
+{
+	
+	uint16_t uiNow_MS = (uint16_t)ulNow_MS;
+	uint16_t uiElapsed = getElapsed(uiNow_MS);
+	uint8_t uiMode = (uiFlags & ACKSEN_COMPACT_MODE_MASK) >> ACKSEN_COMPACT_MODE_SHIFT;
+	bool bState = uiFlags & ACKSEN_COMPACT_DEBOUNCED_STATE;
+	
+	// Debounce
+	if ((AcksenButtonHAL::readPin(uiButtonPin) != bState) && (uiElapsed >= pConfig->uiDebounceInterval_MS))
+	{
+		uiLastStateChange_MS = uiNow_MS;
+		uiLastRepeat_MS = uiNow_MS;
+		
+		// Toggle the state, and restart the repeat sequence if in Repeat/Accelerate mode
+		uiFlags ^= ACKSEN_COMPACT_DEBOUNCED_STATE;
+		uiFlags &= (uint8_t)~ACKSEN_COMPACT_ELAPSED_SATURATED;
+		uiFlags |= ACKSEN_COMPACT_STATE_CHANGE_RECORDED;
+		
+		if (uiMode >= ACKSEN_BUTTON_MODE_REPEAT)
+		{
+			uiFlags &= (uint8_t)~ACKSEN_COMPACT_MODE_FLAGS;
+		}
+		
+		return true;
+	}
+	
+	if (bState)
+	{
+		
+		if (uiMode >= ACKSEN_BUTTON_MODE_REPEAT)
+		{
+			
+			uint16_t uiWait_MS;
+			
+			if (!(uiFlags & ACKSEN_COMPACT_REPEAT_STARTED))
+			{
+				uiWait_MS = pConfig->uiRepeatInitialOffsetDelay_MS;
+			}
+			else if (uiFlags & ACKSEN_COMPACT_REPEAT_ACCELERATED)
+			{
+				uiWait_MS = pConfig->uiAccelerationPressesInterval_MS;
+			}
+			else
+			{
+				uiWait_MS = pConfig->uiRepeatPressesInterval_MS;
+			}
+			
+			// Check to see if Repeat Period has elapsed
+			if ((uint16_t)(uiNow_MS - uiLastRepeat_MS) >= uiWait_MS)
+			{
+				uiLastRepeat_MS = uiNow_MS;
+				uiFlags |= ACKSEN_COMPACT_REPEAT_STARTED | ACKSEN_COMPACT_STATE_CHANGE_RECORDED;
+				
+				// Select the interval for the next repeat, as AcksenButton does when it sets the next period end
+				if ((uiMode == ACKSEN_BUTTON_MODE_ACCELERATE) && (uiElapsed >= pConfig->uiAccelerationInitialOffsetDelay_MS))
+				{
+					uiFlags |= ACKSEN_COMPACT_REPEAT_ACCELERATED;
+				}
+				
+				return true;
+			}
+			
+		}
+		else if ((uiMode == ACKSEN_BUTTON_MODE_LONGPRESS) && !(uiFlags & ACKSEN_COMPACT_LONG_PRESS_RECORDED))
+		{
+			
+			// Time Threshold Exceeded - set Long Press as having been executed
+			if (uiElapsed >= pConfig->uiLongPressInterval_MS)
+			{
+				uiFlags = (uint8_t)((uiFlags & ~ACKSEN_COMPACT_LONG_PRESS_PROCESSED) | ACKSEN_COMPACT_LONG_PRESS_RECORDED);
+			}
+			
+		}
+		
+	}
+	else if (uiMode == ACKSEN_BUTTON_MODE_LONGPRESS)
+	{
+		// Reset Long Press system if present button state is low
+		uiFlags &= (uint8_t)~ACKSEN_COMPACT_MODE_FLAGS;
+	}
+	
+	// Reset the State Change Recorded flag, as no transition has occurred this refresh
+	uiFlags &= (uint8_t)~ACKSEN_COMPACT_STATE_CHANGE_RECORDED;
+	
+	return false;
+	
+}
+
+bool AcksenButtonCompact::getButtonState()
+{
+	return uiFlags & ACKSEN_COMPACT_DEBOUNCED_STATE;
+}
+
+unsigned long AcksenButtonCompact::getTimeFromLastStateChange()
+{
+	return getElapsed((uint16_t)AcksenButtonHAL::getMillis());
+}
+
+bool AcksenButtonCompact::onPressed()
+{
+	
+	if ((uiFlags & (ACKSEN_COMPACT_STATE_CHANGE_RECORDED | ACKSEN_COMPACT_DEBOUNCED_STATE)) == (ACKSEN_COMPACT_STATE_CHANGE_RECORDED | ACKSEN_COMPACT_DEBOUNCED_STATE))
+	{
+		uiFlags &= (uint8_t)~ACKSEN_COMPACT_STATE_CHANGE_RECORDED;
+		return true;
+	}
+	
+	return false;
+	
+}
+
+bool AcksenButtonCompact::onLongPress()
+{
+	
+	if (((uiFlags & ACKSEN_COMPACT_MODE_MASK) >> ACKSEN_COMPACT_MODE_SHIFT) != ACKSEN_BUTTON_MODE_LONGPRESS)
+	{
+		// Always return false when LongPress mode is not enabled
+		return false;
+	}
+	
+	if ((uiFlags & (ACKSEN_COMPACT_LONG_PRESS_RECORDED | ACKSEN_COMPACT_LONG_PRESS_PROCESSED)) == ACKSEN_COMPACT_LONG_PRESS_RECORDED)
+	{
+		uiFlags |= ACKSEN_COMPACT_LONG_PRESS_PROCESSED;
+		return true;
+	}
+	
+	return false;
+	
+}
+
+bool AcksenButtonCompact::onReleased()
+{
+	
+	if ((uiFlags & (ACKSEN_COMPACT_STATE_CHANGE_RECORDED | ACKSEN_COMPACT_DEBOUNCED_STATE)) == ACKSEN_COMPACT_STATE_CHANGE_RECORDED)
+	{
+		uiFlags &= (uint8_t)~ACKSEN_COMPACT_STATE_CHANGE_RECORDED;
+		return true;
+	}
+	
+	return false;
+	
+}
@@ -0,0 +1,179 @@
+/*!
+@file AcksenButtonCompact.h
+
+*/
+
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+// Compact button for the Acksen Button Library.
+//
+// AcksenButtonCompact behaves exactly like a polled AcksenButton, but packs its state into a few bytes: the mode
+// and all flags share one byte, and timers are 16-bit stamps of the millisecond clock. The intervals live in an
+// AcksenButtonCompactConfig shared by any number of buttons.
+//
+// 16-bit stamps limit intervals to ACKSEN_BUTTON_COMPACT_MAX_INTERVAL, and refreshStatus() must be called at least
+// that often. Time since the last state change is tracked until it passes ACKSEN_BUTTON_COMPACT_MAX_INTERVAL,
+// after which it saturates - every interval has then expired, so behaviour is unaffected.
+
+#ifndef AcksenButtonCompact_h
+#define AcksenButtonCompact_h
+
+#include "AcksenButton.h"
+
+#define ACKSEN_BUTTON_COMPACT_MAX_INTERVAL			32767	///< Longest interval supported by AcksenButtonCompact, and longest allowed gap between refreshes (Milliseconds)
+
+/**************************************************************************/
+/*! 
+    @brief  Interval configuration shared by a set of AcksenButtonCompact buttons (all values in milliseconds)
+*/
+/**************************************************************************/
+struct AcksenButtonCompactConfig
+{
+	
+/**************************************************************************/
+/*!
+    @brief  Initialisation, using the same default intervals as AcksenButton.
+    @param  uiDebounceInterval_MS
+            The debounce interval applied to the buttons, in milliseconds.
+*/
+/**************************************************************************/
+	AcksenButtonCompactConfig(uint16_t uiDebounceInterval_MS) :
+		uiDebounceInterval_MS(uiDebounceInterval_MS),
+		uiLongPressInterval_MS(DEFAULT_LONG_PRESS_INTERVAL),
+		uiRepeatPressesInterval_MS(DEFAULT_REPEAT_PRESS_INTERVAL),
+		uiRepeatInitialOffsetDelay_MS(DEFAULT_REPEAT_INITIAL_OFFSET_INTERVAL),
+		uiAccelerationInitialOffsetDelay_MS(DEFAULT_ACCELERATION_INITIAL_OFFSET_INTERVAL),
+		uiAccelerationPressesInterval_MS(DEFAULT_ACCELERATION_PRESSES_INTERVAL)
+	{
+	}
+	
+	uint16_t uiDebounceInterval_MS;					///< Debounce interval
+	uint16_t uiLongPressInterval_MS;				///< Long Press interval (Long Press mode)
+	uint16_t uiRepeatPressesInterval_MS;			///< Repeat Presses interval (Repeat and Accelerate modes)
+	uint16_t uiRepeatInitialOffsetDelay_MS;			///< Repeat Initial Offset Delay (Repeat and Accelerate modes)
+	uint16_t uiAccelerationInitialOffsetDelay_MS;	///< Acceleration Initial Offset Delay (Accelerate mode)
+	uint16_t uiAccelerationPressesInterval_MS;		///< Acceleration Presses interval (Accelerate mode)
+};
+
+/**************************************************************************/
+/*! 
+    @brief  Class that defines a button with compact state, and intervals shared through an AcksenButtonCompactConfig
+*/
+/**************************************************************************/
+class AcksenButtonCompact
+{
+
+public:
+
+/**************************************************************************/
+/*!
+    @brief  Class initialisation.
+    @param  uiButtonPin
+            The Arduino I/O pin assigned to the button.
+    @param  uiButtonOperationMode
+            The operating mode for the button (one of the ACKSEN_BUTTON_MODE_* constants).
+    @param  pConfig
+            The interval configuration used by the button. It is not copied, so must outlive the button.
+    @param  uiButtonInputMode
+            Used to specify the input type on the specified I/O pin (INPUT or INPUT_PULLUP)
+    @return No return value.
+*/
+/**************************************************************************/
+	AcksenButtonCompact(uint8_t uiButtonPin, uint8_t uiButtonOperationMode, const AcksenButtonCompactConfig* pConfig, uint8_t uiButtonInputMode);
+
+/**************************************************************************/
+/*!
+    @brief  Set the Button Operating Mode.
+    @param  uiButtonOperationMode
+            The operating mode for the button (one of the ACKSEN_BUTTON_MODE_* constants).
+    @return No return value.
+*/
+/**************************************************************************/
+	void setButtonOperatingMode(uint8_t uiButtonOperationMode);
+
+/**************************************************************************/
+/*!
+    @brief  Updates the Button states, using the state of the assigned Arduino I/O Pin.
+    @return Returns true if the state changed, or a repeat press fired.
+			Returns false if the state did not change.
+*/
+/**************************************************************************/
+	bool refreshStatus();
+
+/**************************************************************************/
+/*!
+    @brief  Updates the Button states, using a time supplied by the caller.
+    @param  ulNow_MS
+            The present time, in milliseconds (i.e. the value of millis() at the start of the scan).
+    @return Returns true if the state changed, or a repeat press fired.
+			Returns false if the state did not change.
+*/
+/**************************************************************************/
+	bool refreshStatus(unsigned long ulNow_MS);
+
+/**************************************************************************/
+/*!
+    @brief  Returns the debounced state of the button.
+*/
+/**************************************************************************/
+	bool getButtonState();
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of milliseconds the button has been in the current state.
+    @return Returns the number of milliseconds, or a value greater than ACKSEN_BUTTON_COMPACT_MAX_INTERVAL
+			once it has been in the current state for longer than that.
+*/
+/**************************************************************************/
+	unsigned long getTimeFromLastStateChange();
+
+/**************************************************************************/
+/*!
+    @brief  Equivalent to AcksenButton::onPressed().
+*/
+/**************************************************************************/
+	bool onPressed();
+
+/**************************************************************************/
+/*!
+    @brief  Equivalent to AcksenButton::onLongPress().
+*/
+/**************************************************************************/
+	bool onLongPress();
+
+/**************************************************************************/
+/*!
+    @brief  Equivalent to AcksenButton::onReleased().
+*/
+/**************************************************************************/
+	bool onReleased();
+
+protected:
+
+	uint16_t getElapsed(uint16_t uiNow_MS);
+
+	const AcksenButtonCompactConfig* pConfig;
+
+	uint16_t uiLastStateChange_MS;		// Low 16 bits of the clock at the last state change
+	uint16_t uiLastRepeat_MS;			// Low 16 bits of the clock at the press, or the last repeat press
+
+	uint8_t uiButtonPin;
+	uint8_t uiFlags;					// Mode and flags - see ACKSEN_COMPACT_* in AcksenButtonCompact.cpp
+
+};
+
+#endif
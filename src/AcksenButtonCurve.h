@@ -0,0 +1,148 @@
+/*!
+@file AcksenButtonCurve.h
+
+*/
+
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+// Acceleration curves for the Acksen Button Library.
+//
+// AcksenButton::setAccelerationCurve() takes a table of repeat intervals, indexed by the number of repeats since
+// the button was pressed. The templates here generate such tables at compile time, into PROGMEM, so that a curve
+// costs no RAM on AVR and refreshStatus() only has to look up the next interval:
+//
+//	typedef AcksenButtonExponentialCurve<400, 20, 32> SetpointCurve;	// 400ms falling to 20ms over 32 repeats
+//	btnUp.setAccelerationCurve(SetpointCurve::auiTable, SetpointCurve::LENGTH);
+//
+// A stepped curve can equally be written out by hand, e.g. const uint16_t auiCurve[] PROGMEM = { 500, 500, 250, 100 };
+// setAccelerationCurve() needs the library built with ACKSEN_BUTTON_ACCELERATION_CURVES set to 1 (see AcksenButton.h).
+// Only C++11 constexpr is used, as supported by the Arduino AVR toolchain.
+
+#ifndef AcksenButtonCurve_h
+#define AcksenButtonCurve_h
+
+#include "AcksenButtonHAL.h"
+
+/**************************************************************************/
+/*!
+    @brief  Interval reached after a number of steps of an exponential curve, each multiplying the interval by
+			uiRatio/1024 (rounded down, so it always falls), never falling below uiEnd.
+*/
+/**************************************************************************/
+constexpr uint16_t acksenButtonCurveDecay(uint32_t ulInterval, uint16_t uiRatio, uint16_t uiSteps, uint16_t uiEnd)
+{
+	return (ulInterval <= uiEnd) ? uiEnd :
+		((uiSteps == 0) ? (uint16_t)ulInterval : acksenButtonCurveDecay((ulInterval * uiRatio) >> 10, uiRatio, uiSteps - 1, uiEnd));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Largest ratio (in 1024ths, from uiLow to uiHigh) with which an exponential curve falls from uiStart to
+			uiEnd within uiSteps steps - i.e. the smoothest curve that still reaches uiEnd. Found by binary search.
+*/
+/**************************************************************************/
+constexpr uint16_t acksenButtonCurveRatio(uint16_t uiStart, uint16_t uiEnd, uint16_t uiSteps, uint16_t uiLow, uint16_t uiHigh)
+{
+	return (uiLow >= uiHigh) ? uiLow :
+		((acksenButtonCurveDecay(uiStart, (uint16_t)((uiLow + uiHigh + 1) / 2), uiSteps, uiEnd) <= uiEnd) ?
+			acksenButtonCurveRatio(uiStart, uiEnd, uiSteps, (uint16_t)((uiLow + uiHigh + 1) / 2), uiHigh) :
+			acksenButtonCurveRatio(uiStart, uiEnd, uiSteps, uiLow, (uint16_t)((uiLow + uiHigh + 1) / 2 - 1)));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Interval at one step of a linear curve from uiStart to uiEnd over uiSteps entries.
+*/
+/**************************************************************************/
+constexpr uint16_t acksenButtonCurveLinear(uint16_t uiStart, uint16_t uiEnd, uint16_t uiSteps, uint16_t uiStep)
+{
+	return (uiSteps <= 1) ? uiEnd : (uint16_t)((int32_t)uiStart + ((int32_t)uiEnd - (int32_t)uiStart) * uiStep / (uiSteps - 1));
+}
+
+// Compile-time list of the indices 0 to COUNT-1, used to generate each entry of a table
+template <uint16_t... INDICES>
+struct AcksenButtonCurveIndices {};
+
+template <uint16_t COUNT, uint16_t... INDICES>
+struct AcksenButtonCurveIndexRange : AcksenButtonCurveIndexRange<COUNT - 1, COUNT - 1, INDICES...> {};
+
+template <uint16_t... INDICES>
+struct AcksenButtonCurveIndexRange<0, INDICES...>
+{
+	typedef AcksenButtonCurveIndices<INDICES...> Type;
+};
+
+/**************************************************************************/
+/*! 
+    @brief  Exponential acceleration curve, generated at compile time into PROGMEM
+    @tparam START_MS
+            The interval to the first repeat after the Repeat Initial Offset Delay, in milliseconds.
+    @tparam END_MS
+            The shortest interval, reached at the last entry, in milliseconds.
+    @tparam STEPS
+            The number of entries, from 2 to 255.
+*/
+/**************************************************************************/
+template <uint16_t START_MS, uint16_t END_MS, uint8_t STEPS, typename INDICES = typename AcksenButtonCurveIndexRange<STEPS>::Type>
+struct AcksenButtonExponentialCurve;
+
+template <uint16_t START_MS, uint16_t END_MS, uint8_t STEPS, uint16_t... INDICES>
+struct AcksenButtonExponentialCurve<START_MS, END_MS, STEPS, AcksenButtonCurveIndices<INDICES...> >
+{
+	static_assert((STEPS >= 2) && (START_MS >= END_MS), "AcksenButtonExponentialCurve needs 2 or more STEPS, falling from START_MS to END_MS");
+
+	static const uint8_t LENGTH = STEPS;												///< Number of entries in auiTable
+	static const uint16_t RATIO = acksenButtonCurveRatio(START_MS, END_MS, STEPS - 1, 0, 1023);	///< Interval multiplier per step, in 1024ths
+	static const uint16_t auiTable[STEPS];												///< The intervals, in PROGMEM
+};
+
+template <uint16_t START_MS, uint16_t END_MS, uint8_t STEPS, uint16_t... INDICES>
+const uint16_t AcksenButtonExponentialCurve<START_MS, END_MS, STEPS, AcksenButtonCurveIndices<INDICES...> >::auiTable[STEPS] PROGMEM =
+{
+	acksenButtonCurveDecay(START_MS, RATIO, INDICES, END_MS)...
+};
+
+/**************************************************************************/
+/*! 
+    @brief  Linear acceleration curve, generated at compile time into PROGMEM
+    @tparam START_MS
+            The interval to the first repeat after the Repeat Initial Offset Delay, in milliseconds.
+    @tparam END_MS
+            The interval at the last entry, in milliseconds.
+    @tparam STEPS
+            The number of entries, from 2 to 255.
+*/
+/**************************************************************************/
+template <uint16_t START_MS, uint16_t END_MS, uint8_t STEPS, typename INDICES = typename AcksenButtonCurveIndexRange<STEPS>::Type>
+struct AcksenButtonLinearCurve;
+
+template <uint16_t START_MS, uint16_t END_MS, uint8_t STEPS, uint16_t... INDICES>
+struct AcksenButtonLinearCurve<START_MS, END_MS, STEPS, AcksenButtonCurveIndices<INDICES...> >
+{
+	static_assert(STEPS >= 2, "AcksenButtonLinearCurve needs 2 or more STEPS");
+
+	static const uint8_t LENGTH = STEPS;												///< Number of entries in auiTable
+	static const uint16_t auiTable[STEPS];												///< The intervals, in PROGMEM
+};
+
+template <uint16_t START_MS, uint16_t END_MS, uint8_t STEPS, uint16_t... INDICES>
+const uint16_t AcksenButtonLinearCurve<START_MS, END_MS, STEPS, AcksenButtonCurveIndices<INDICES...> >::auiTable[STEPS] PROGMEM =
+{
+	acksenButtonCurveLinear(START_MS, END_MS, STEPS, INDICES)...
+};
+
+#endif
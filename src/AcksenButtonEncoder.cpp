@@ -0,0 +1,341 @@
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+#include "AcksenButtonHAL.h"
+#include "AcksenButtonEncoder.h"
+
+#define ACKSEN_ENCODER_INVALID		2		// Quadrature table entry: both outputs changed, so a state was missed
+
+// Quarter-steps moved by each transition, indexed by (previous state << 2) | present state, where a state is
+// A in bit 1 and B in bit 0. Moving forwards, A leads: 00 -> 10 -> 11 -> 01 -> 00.
+static const int8_t aiQuadratureTable[16] =
+{
+	0,						-1,						1,						ACKSEN_ENCODER_INVALID,		// From 00
+	1,						0,						ACKSEN_ENCODER_INVALID,	-1,							// From 01
+	-1,						ACKSEN_ENCODER_INVALID,	0,						1,							// From 10
+	ACKSEN_ENCODER_INVALID,	1,						-1,						0							// From 11
+};
+
+// Position of each state in the forwards sequence
+static const uint8_t auiQuadraturePhase[4] = { 0, 3, 1, 2 };
+
+AcksenButtonEncoder::AcksenButtonEncoder(uint8_t uiPinA, uint8_t uiPinB, uint8_t uiEncoderOperationMode, uint8_t uiInputMode)
+{
+	
+	// Setup the I/O Pins
+	AcksenButtonHAL::setPinMode(uiPinA, uiInputMode);
+	AcksenButtonHAL::setPinMode(uiPinB, uiInputMode);
+	
+	this->uiPinA = uiPinA;
+	this->uiPinB = uiPinB;
+	
+	// Read the pins' input registers directly, where the platform allows
+	pInputRegisterA = AcksenButtonHAL::getInputRegister(uiPinA);
+	pInputRegisterB = AcksenButtonHAL::getInputRegister(uiPinB);
+	
+	if ((pInputRegisterA == NULL) || (pInputRegisterB == NULL))
+	{
+		pInputRegisterA = NULL;
+		pInputRegisterB = NULL;
+	}
+	else
+	{
+		uiInputMaskA = AcksenButtonHAL::getPinBitMask(uiPinA);
+		uiInputMaskB = AcksenButtonHAL::getPinBitMask(uiPinB);
+	}
+	
+	this->uiEncoderOperationMode = uiEncoderOperationMode;
+	
+	uiCollectedDetents = 0;
+	uiErrorCount = 0;
+	ulLastDetent_MS = AcksenButtonHAL::getMillis();
+	ulTurnStart_MS = ulLastDetent_MS;
+	
+	setStepsPerDetent(DEFAULT_ENCODER_STEPS_PER_DETENT);
+	
+}
+
+void AcksenButtonEncoder::setStepsPerDetent(uint8_t uiStepsPerDetent)
+{
+	
+	this->uiStepsPerDetent = ((uiStepsPerDetent == 1) || (uiStepsPerDetent == 2)) ? uiStepsPerDetent : 4;
+	
+	// Start at rest, on a detent
+	uiLastState = readState();
+	uiDetentPhase = auiQuadraturePhase[uiLastState];
+	iQuarterSteps = 0;
+	
+}
+
+void AcksenButtonEncoder::setEncoderOperatingMode(uint8_t uiEncoderOperationMode)
+{
+	this->uiEncoderOperationMode = uiEncoderOperationMode;
+}
+
+void AcksenButtonEncoder::setAccelerationInterval(unsigned long ulAccelerationInterval_MS)
+{
+	this->ulAccelerationInterval_MS = ulAccelerationInterval_MS;
+}
+
+void AcksenButtonEncoder::setAccelerationInitialOffsetDelay(unsigned long ulAccelerationInitialOffsetDelay_MS)
+{
+	this->ulAccelerationInitialOffsetDelay_MS = ulAccelerationInitialOffsetDelay_MS;
+}
+
+void AcksenButtonEncoder::setAccelerationSteps(uint8_t uiAccelerationSteps)
+{
+	this->uiAccelerationSteps = uiAccelerationSteps;
+}
+
+bool AcksenButtonEncoder::setSwitch(AcksenButton* pSwitch)
+{
+	
+	// update() refreshes the switch from millis()
+	if ((pSwitch != NULL) && (pSwitch->getTimeBase() != ACKSEN_BUTTON_TIME_MILLIS))
+	{
+		return false;
+	}
+	
+	this->pSwitch = pSwitch;
+	
+	return true;
+	
+}
+
+AcksenButton* AcksenButtonEncoder::getSwitch()
+{
+	return pSwitch;
+}
+
+void AcksenButtonEncoder::setEdgeCapture(bool bEnable)
+{
+	
+	// Start from the present state, and nothing left to collect
+	uiLastState = readState();
+	iQuarterSteps = 0;
+	uiCollectedDetents = cCapturedDetents.load();
+	
+	bEdgeCapture = bEnable;
+	
+}
+
+// Called from the pin-change ISR - the only code that decodes while interrupt-driven decoding is enabled
+void AcksenButtonEncoder::captureEdge()
+{
+	
+	if (!bEdgeCapture)
+	{
+		return;
+	}
+	
+	uint8_t uiState = readState();
+	
+	if (uiState == uiLastState)
+	{
+		return;
+	}
+	
+	int8_t iDetent = decode(uiState);
+	
+	if (iDetent != 0)
+	{
+		cCapturedDetents.store((uint8_t)(cCapturedDetents.loadOwned() + iDetent));
+	}
+	
+}
+
+bool AcksenButtonEncoder::update()
+{
+	return update(AcksenButtonHAL::getMillis());
+}
+
+bool AcksenButtonEncoder::update(unsigned long ulNow_MS)
+{
+	
+	long lPreviousPosition = lPosition;
+	
+	if (bEdgeCapture)
+	{
+		// Collect the detents counted by the ISR since the last update - the running count wraps, so the
+		// difference is correct for up to 127 detents either way
+		uint8_t uiCaptured = cCapturedDetents.load();
+		
+		applyDetents((int8_t)(uint8_t)(uiCaptured - uiCollectedDetents), ulNow_MS);
+		uiCollectedDetents = uiCaptured;
+	}
+	else
+	{
+		uint8_t uiState = readState();
+		
+		if (uiState != uiLastState)
+		{
+			applyDetents(decode(uiState), ulNow_MS);
+		}
+	}
+	
+	if (pSwitch != NULL)
+	{
+		pSwitch->refreshStatus(ulNow_MS);
+	}
+	
+	return lPosition != lPreviousPosition;
+	
+}
+
+long AcksenButtonEncoder::getPosition()
+{
+	return lPosition;
+}
+
+void AcksenButtonEncoder::setPosition(long lPosition)
+{
+	this->lPosition = lPosition;
+	lReportedPosition = lPosition;
+}
+
+long AcksenButtonEncoder::getSteps()
+{
+	
+	long lSteps = lPosition - lReportedPosition;
+	
+	lReportedPosition = lPosition;
+	
+	return lSteps;
+	
+}
+
+uint8_t AcksenButtonEncoder::getErrorCount()
+{
+	
+	uint16_t uiErrors = (uint16_t)uiErrorCount + cCapturedErrors.load();
+	
+	return (uiErrors < 0xFF) ? (uint8_t)uiErrors : 0xFF;
+	
+}
+
+uint16_t AcksenButtonEncoder::getTurnLength()
+{
+	return uiTurnLength;
+}
+
+void AcksenButtonEncoder::setEventQueue(AcksenButtonEventQueue* pEventQueue)
+{
+	this->pEventQueue = pEventQueue;
+}
+
+// Protected: Decode a change of state. Returns the detent reached (1 forwards, -1 backwards), or 0 if the encoder
+// is not at rest on a detent, or has returned to the one it left.
+// The quarter-steps since the last detent are rounded to the nearest detent, so a state missed on the way
+// (counted as an error, as its direction is unknown) does not lose the detent.
+int8_t AcksenButtonEncoder::decode(uint8_t uiState)
+{
+	
+	int8_t iDelta = aiQuadratureTable[(uiLastState << 2) | uiState];
+	
+	uiLastState = uiState;
+	
+	if (iDelta == ACKSEN_ENCODER_INVALID)
+	{
+		if (bEdgeCapture)
+		{
+			uint8_t uiErrors = cCapturedErrors.loadOwned();
+			
+			if (uiErrors < 0xFF)
+			{
+				cCapturedErrors.store(uiErrors + 1);
+			}
+		}
+		else if (uiErrorCount < 0xFF)
+		{
+			uiErrorCount++;
+		}
+		
+		iDelta = 0;
+	}
+	
+	iQuarterSteps += iDelta;
+	
+	// Between detents
+	if (((auiQuadraturePhase[uiState] - uiDetentPhase) & (uiStepsPerDetent - 1)) != 0)
+	{
+		return 0;
+	}
+	
+	int8_t iDetent = 0;
+	
+	if (2 * iQuarterSteps >= uiStepsPerDetent)
+	{
+		iDetent = 1;
+	}
+	else if (2 * iQuarterSteps <= -uiStepsPerDetent)
+	{
+		iDetent = -1;
+	}
+	
+	iQuarterSteps = 0;
+	
+	return iDetent;
+	
+}
+
+// Protected: Move the position by a number of detents reached by the given time.
+// As in AcksenButton's Accelerate mode, a turn starts at single steps, and once it has continued for the initial
+// offset delay, each detent moves uiAccelerationSteps. A turn continues while detents arrive within the
+// acceleration interval of each other, on average over the detents collected - and ends on reversing.
+void AcksenButtonEncoder::applyDetents(int8_t iDetents, unsigned long ulNow_MS)
+{
+	
+	if (iDetents == 0)
+	{
+		return;
+	}
+	
+	int8_t iDirection = (iDetents > 0) ? 1 : -1;
+	uint8_t uiDetents = (iDetents > 0) ? iDetents : -iDetents;
+	
+	if ((iDirection != iTurnDirection) || ((ulNow_MS - ulLastDetent_MS) / uiDetents >= ulAccelerationInterval_MS))
+	{
+		// A new turn
+		iTurnDirection = iDirection;
+		uiTurnLength = 0;
+		ulTurnStart_MS = ulNow_MS;
+	}
+	
+	ulLastDetent_MS = ulNow_MS;
+	
+	uint8_t uiSteps = 1;
+	
+	if ((uiEncoderOperationMode == ACKSEN_BUTTON_MODE_ACCELERATE) && ((ulNow_MS - ulTurnStart_MS) >= ulAccelerationInitialOffsetDelay_MS))
+	{
+		uiSteps = uiAccelerationSteps;
+	}
+	
+	lPosition += (long)iDirection * uiSteps * uiDetents;
+	uiTurnLength = (uiTurnLength < 0xFFFF - uiDetents) ? (uiTurnLength + uiDetents) : 0xFFFF;
+	
+	if (pEventQueue != NULL)
+	{
+		AcksenButtonEvent sEvent;
+		sEvent.ulTimestamp_MS = ulNow_MS;
+		sEvent.uiType = (iDirection > 0) ? ACKSEN_BUTTON_EVENT_CLOCKWISE : ACKSEN_BUTTON_EVENT_ANTICLOCKWISE;
+		
+		for (uint8_t i = 0; i < uiDetents; i++)
+		{
+			pEventQueue->push(sEvent);
+		}
+	}
+	
+}
@@ -0,0 +1,306 @@
+/*!
+@file AcksenButtonEncoder.h
+
+*/
+
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+
+// Quadrature rotary encoder input for the Acksen Button Library.
+//
+// AcksenButtonEncoder decodes the two quadrature outputs (A and B) of a rotary encoder with a 16-entry table,
+// indexed by the previous and present levels of both outputs. Each valid transition moves a quarter-step
+// forwards or backwards, and contact bounce on one output just moves back and forth between two states, so no
+// debounce interval is needed. Transitions that change both outputs at once mean a state was missed, and are
+// counted as errors. Steps are only counted as the encoder comes to rest on a detent, so a turn that is abandoned
+// half way, or a missed state, never leaves the count out of step with the detents.
+//
+// The outputs are either polled by update(), or decoded by captureEdge() called from pin-change interrupts on both
+// pins, in which case update() collects the detents counted by the interrupt handler without reading the pins.
+//
+// In Accelerate mode, detents turned quickly are worth several steps, following the two-stage timing of an
+// AcksenButton in ACKSEN_BUTTON_MODE_ACCELERATE: once the encoder has been turned continuously (each detent within
+// the acceleration interval of the last) for the initial offset delay, each detent moves setAccelerationSteps()
+// steps. Turning slowly, or reversing, returns to single steps.
+//
+// The encoder's push switch is an ordinary AcksenButton, in any mode, refreshed by update() from the same clock read.
+
+#ifndef AcksenButtonEncoder_h
+#define AcksenButtonEncoder_h
+
+#include "AcksenButtonHAL.h"
+#include "AcksenButton.h"
+#include "AcksenButtonRing.h"
+
+#define DEFAULT_ENCODER_STEPS_PER_DETENT						4		///< Default quadrature transitions per detent (most mechanical encoders; some have 2 or 1)
+#define DEFAULT_ENCODER_ACCELERATION_INTERVAL					40		///< Default longest time between detents of a continuous turn, in Accelerate mode (Milliseconds)
+#define DEFAULT_ENCODER_ACCELERATION_INITIAL_OFFSET_INTERVAL	200		///< Default time a turn must continue before detents are accelerated, in Accelerate mode (Milliseconds)
+#define DEFAULT_ENCODER_ACCELERATION_STEPS						5		///< Default steps per detent once accelerated, in Accelerate mode
+
+/**************************************************************************/
+/*! 
+    @brief  Class that defines a quadrature rotary encoder, with optional push switch
+*/
+/**************************************************************************/
+class AcksenButtonEncoder
+{
+
+public:
+
+/**************************************************************************/
+/*!
+    @brief  Class initialisation.
+    @param  uiPinA
+            The I/O pin connected to output A. The position increases when A changes before B - swap the pins to
+			reverse the direction.
+    @param  uiPinB
+            The I/O pin connected to output B.
+    @param  uiEncoderOperationMode
+            The operating mode for the encoder. Options are:
+			ACKSEN_BUTTON_MODE_NORMAL - Each detent moves one step
+			ACKSEN_BUTTON_MODE_ACCELERATE - Detents of a fast, continuous turn move several steps
+    @param  uiInputMode
+            Used to specify the input type on both I/O pins (INPUT or INPUT_PULLUP)
+    @return No return value.
+*/
+/**************************************************************************/
+	AcksenButtonEncoder(uint8_t uiPinA, uint8_t uiPinB, uint8_t uiEncoderOperationMode, uint8_t uiInputMode);
+
+/**************************************************************************/
+/*!
+    @brief  Sets the number of quadrature transitions between detents. The encoder's present position is taken as
+			a detent.
+    @param  uiStepsPerDetent
+            1, 2 or 4 (default DEFAULT_ENCODER_STEPS_PER_DETENT).
+    @return No return value.
+*/
+/**************************************************************************/
+	void setStepsPerDetent(uint8_t uiStepsPerDetent);
+
+/**************************************************************************/
+/*!
+    @brief  Set the Encoder Operating Mode.
+    @param  uiEncoderOperationMode
+            ACKSEN_BUTTON_MODE_NORMAL or ACKSEN_BUTTON_MODE_ACCELERATE.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setEncoderOperatingMode(uint8_t uiEncoderOperationMode);
+
+/**************************************************************************/
+/*!
+    @brief  Set the Acceleration Interval - the longest time between detents that counts as a continuous turn.
+    @param  ulAccelerationInterval_MS
+            The acceleration interval, in milliseconds.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setAccelerationInterval(unsigned long ulAccelerationInterval_MS);
+
+/**************************************************************************/
+/*!
+    @brief  Set the Acceleration Initial Offset Delay - how long a turn must continue before it is accelerated.
+    @param  ulAccelerationInitialOffsetDelay_MS
+            The acceleration initial offset delay, in milliseconds.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setAccelerationInitialOffsetDelay(unsigned long ulAccelerationInitialOffsetDelay_MS);
+
+/**************************************************************************/
+/*!
+    @brief  Set the number of steps each detent moves once a turn is accelerated.
+    @param  uiAccelerationSteps
+            The steps per accelerated detent.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setAccelerationSteps(uint8_t uiAccelerationSteps);
+
+/**************************************************************************/
+/*!
+    @brief  Attaches the encoder's push switch, to be refreshed by update(). It keeps its own mode, intervals and
+			events, and is read with onPressed() etc. as usual. It must be timed in milliseconds, and must not be
+			switched to the microsecond time base once attached.
+    @param  pSwitch
+            The button reading the push switch, or NULL for none. It is not copied, so must outlive the encoder.
+    @return Returns true if the switch was attached (or detached, for NULL).
+			Returns false, leaving the previous switch attached, if the button uses the microsecond time base.
+*/
+/**************************************************************************/
+	bool setSwitch(AcksenButton* pSwitch);
+
+/**************************************************************************/
+/*!
+    @brief  Returns the push switch attached with setSwitch(), or NULL.
+*/
+/**************************************************************************/
+	AcksenButton* getSwitch();
+
+/**************************************************************************/
+/*!
+    @brief  Enables or disables interrupt-driven decoding.
+			When enabled, update() no longer reads the I/O pins. Instead captureEdge() must be called from a
+			pin-change interrupt on both pins, and update() collects the detents it has counted. Up to 127 detents
+			may be counted between calls to update(). Call before attaching the interrupts.
+    @param  bEnable
+            true to decode in captureEdge(), false to return to polling the pins in update().
+    @return No return value.
+*/
+/**************************************************************************/
+	void setEdgeCapture(bool bEnable);
+
+/**************************************************************************/
+/*!
+    @brief  Decodes the present level of both pins. Intended to be called from a pin-change (CHANGE) interrupt
+			handler attached to both encoder pins, once interrupt-driven decoding is enabled.
+    @return No return value.
+*/
+/**************************************************************************/
+	void captureEdge();
+
+/**************************************************************************/
+/*!
+    @brief  Updates the encoder position (reading both pins, unless decoding by interrupt), and refreshes the push
+			switch, if attached.
+    @return Returns true if the position changed.
+			Returns false if the position did not change.
+*/
+/**************************************************************************/
+	bool update();
+
+/**************************************************************************/
+/*!
+    @brief  Updates the encoder position and push switch using a time supplied by the caller.
+    @param  ulNow_MS
+            The present time, in milliseconds (i.e. the value of millis() at the start of the scan).
+    @return Returns true if the position changed.
+			Returns false if the position did not change.
+*/
+/**************************************************************************/
+	bool update(unsigned long ulNow_MS);
+
+/**************************************************************************/
+/*!
+    @brief  Returns the position of the encoder, in steps (accelerated detents count several steps).
+*/
+/**************************************************************************/
+	long getPosition();
+
+/**************************************************************************/
+/*!
+    @brief  Sets the position of the encoder, e.g. to the value it is adjusting.
+    @param  lPosition
+            The new position, in steps.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setPosition(long lPosition);
+
+/**************************************************************************/
+/*!
+    @brief  Returns the steps moved since the last call, positive for increasing position, e.g. to adjust a value.
+    @return Returns the change in position since getSteps() was last called.
+*/
+/**************************************************************************/
+	long getSteps();
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of transitions where both outputs changed at once, so a state was missed - the
+			pins are not being read fast enough (saturates at 255).
+*/
+/**************************************************************************/
+	uint8_t getErrorCount();
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of detents moved in the same direction, each within the acceleration interval of
+			the last, e.g. to show that a turn is accelerating. Saturates at 65535.
+*/
+/**************************************************************************/
+	uint16_t getTurnLength();
+
+/**************************************************************************/
+/*!
+    @brief  Attaches an event queue. While attached, update() records an ACKSEN_BUTTON_EVENT_CLOCKWISE or
+			ACKSEN_BUTTON_EVENT_ANTICLOCKWISE event for every detent, with the time update() counted it. The same
+			queue can be given to the push switch (with ACKSEN_BUTTON_EVENTS set to 1), so that turns and presses are
+			read in the order they happened.
+    @param  pEventQueue
+            The queue to record events into, or NULL to stop recording events.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setEventQueue(AcksenButtonEventQueue* pEventQueue);
+
+protected:
+
+  // Reads both outputs as a 2-bit state, A in bit 1 and B in bit 0
+  uint8_t readState()
+  {
+	  bool bA = (pInputRegisterA != NULL) ? ((*pInputRegisterA & uiInputMaskA) != 0) : AcksenButtonHAL::readPin(uiPinA);
+	  bool bB = (pInputRegisterB != NULL) ? ((*pInputRegisterB & uiInputMaskB) != 0) : AcksenButtonHAL::readPin(uiPinB);
+	  
+	  return (bA ? 0x02 : 0x00) | (bB ? 0x01 : 0x00);
+  }
+  
+  int8_t decode(uint8_t uiState);
+  void applyDetents(int8_t iDetents, unsigned long ulNow_MS);
+  
+  uint8_t uiPinA;
+  uint8_t uiPinB;
+  
+  // Input backend - digitalRead() is used while the register is NULL
+  const volatile AcksenButtonPort_t* pInputRegisterA = NULL;
+  const volatile AcksenButtonPort_t* pInputRegisterB = NULL;
+  AcksenButtonPort_t uiInputMaskA = 0;
+  AcksenButtonPort_t uiInputMaskB = 0;
+  
+  // Decoder - owned by update() when polling, and by captureEdge() when decoding by interrupt
+  uint8_t uiStepsPerDetent = DEFAULT_ENCODER_STEPS_PER_DETENT;
+  uint8_t uiDetentPhase;				// Quadrature phase (0-3) of the detents
+  volatile uint8_t uiLastState;			// Last state decoded
+  volatile int8_t iQuarterSteps;		// Transitions since the last detent
+  
+  // Interrupt-driven decoding - running counts written by captureEdge(), and how far update() has collected them
+  bool bEdgeCapture = false;
+  AcksenButtonSharedByte cCapturedDetents;
+  AcksenButtonSharedByte cCapturedErrors;
+  uint8_t uiCollectedDetents;
+  uint8_t uiErrorCount;				// Polled errors, saturating
+  
+  // Position
+  uint8_t uiEncoderOperationMode;
+  long lPosition = 0;
+  long lReportedPosition = 0;
+  
+  // Acceleration - modelled on AcksenButton's Accelerate mode
+  unsigned long ulAccelerationInterval_MS = DEFAULT_ENCODER_ACCELERATION_INTERVAL;
+  unsigned long ulAccelerationInitialOffsetDelay_MS = DEFAULT_ENCODER_ACCELERATION_INITIAL_OFFSET_INTERVAL;
+  uint8_t uiAccelerationSteps = DEFAULT_ENCODER_ACCELERATION_STEPS;
+  int8_t iTurnDirection = 0;
+  uint16_t uiTurnLength = 0;
+  unsigned long ulTurnStart_MS;
+  unsigned long ulLastDetent_MS;
+  
+  AcksenButton* pSwitch = NULL;
+  AcksenButtonEventQueue* pEventQueue = NULL;
+  
+};
+
+#endif
@@ -0,0 +1,385 @@
+/*!
+@file AcksenButtonGesture.h
+
+*/
+
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+// Gesture detection for the Acksen Button Library.
+//
+// AcksenButtonGestures refreshes a set of buttons from one read of the clock, as AcksenButtonGroup does, and turns
+// their debounced presses and releases into gestures: clicks, multi-clicks (double, triple...) and two-button
+// chords. Gestures are queued with the time they completed, and read with pollGesture().
+//
+// Decisions are made as early as they can be. A click is reported on release, immediately, unless the button is
+// configured for multi-click - only then does it wait the click window for a further press, and a sequence that
+// reaches the configured count is reported without waiting. A chord is reported as its second button is pressed,
+// if both were pressed within the chord window (buttons in the same scan share a timestamp, so a window of 0 only
+// accepts presses seen in the same scan). The presses that make up a chord are not reported as clicks.
+//
+// The buttons keep their own modes and events - gestures only read getButtonState().
+//
+// Gestures are timed in milliseconds, so every button must use the millisecond time base. add() refuses buttons in
+// the microsecond time base, and a button must not be switched to it once added.
+
+#ifndef AcksenButtonGesture_h
+#define AcksenButtonGesture_h
+
+#include "AcksenButtonHAL.h"
+#include "AcksenButton.h"
+#include "AcksenButtonRing.h"
+
+#define DEFAULT_GESTURE_CLICK_WINDOW					250		///< Default time allowed from a release to the next press of a multi-click (Milliseconds)
+#define DEFAULT_GESTURE_CHORD_WINDOW					50		///< Default time allowed between the two presses of a chord (Milliseconds)
+
+#define ACKSEN_BUTTON_GESTURE_QUEUE_SIZE				16		///< Number of slots in the gesture queue (power of two, holds one fewer gesture)
+
+#define ACKSEN_BUTTON_GESTURE_CLICK						0		///< Gesture: uiCount clicks of button uiIndex
+#define ACKSEN_BUTTON_GESTURE_CHORD						1		///< Gesture: chord uiIndex (both of its buttons held)
+
+/**************************************************************************/
+/*! 
+    @brief  Gesture reported by AcksenButtonGestures::pollGesture()
+*/
+/**************************************************************************/
+struct AcksenButtonGesture
+{
+	unsigned long ulTimestamp_MS;	///< Time the gesture completed (the last release of a click, the second press of a chord), in milliseconds
+	uint8_t uiType;					///< One of the ACKSEN_BUTTON_GESTURE_* constants
+	uint8_t uiIndex;				///< The button clicked, or the chord pressed, in the order added
+	uint8_t uiCount;				///< Number of clicks (1 for a single click), or 2 for a chord
+};
+
+/**************************************************************************/
+/*! 
+    @brief  Class that defines a set of buttons refreshed together, and the gestures made with them
+    @tparam BUTTONS
+            The maximum number of buttons that can be added.
+    @tparam CHORDS
+            The maximum number of chords that can be added.
+*/
+/**************************************************************************/
+template <uint8_t BUTTONS, uint8_t CHORDS = 4>
+class AcksenButtonGestures
+{
+
+public:
+
+	AcksenButtonGestures() : uiCount(0), uiChordCount(0), ulClickWindow_MS(DEFAULT_GESTURE_CLICK_WINDOW), ulChordWindow_MS(DEFAULT_GESTURE_CHORD_WINDOW) {}
+
+/**************************************************************************/
+/*!
+    @brief  Adds a button. It reports single clicks until setMultiClick() is called for it.
+    @param  pButton
+            The button to add. It is not copied, so must outlive the gestures.
+    @return Returns true if the button was added.
+			Returns false if the set is full, or the button uses the microsecond time base.
+*/
+/**************************************************************************/
+	bool add(AcksenButton* pButton)
+	{
+		if ((uiCount >= BUTTONS) || (pButton->getTimeBase() != ACKSEN_BUTTON_TIME_MILLIS))
+		{
+			return false;
+		}
+
+		ButtonState& sButton = asButtons[uiCount++];
+
+		sButton.pButton = pButton;
+		sButton.bDown = pButton->getButtonState();
+		sButton.bChorded = false;
+		sButton.uiMaxClicks = 1;
+		sButton.uiClicks = 0;
+		sButton.ulPress_MS = 0;
+		sButton.ulRelease_MS = 0;
+
+		return true;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of buttons added.
+*/
+/**************************************************************************/
+	uint8_t getCount() { return uiCount; }
+
+/**************************************************************************/
+/*!
+    @brief  Sets the most clicks a button counts in one gesture, e.g. 2 for double-click, 3 for triple-click.
+			Fewer clicks are reported once the click window passes without a further press.
+    @param  uiButton
+            The button, in the order added.
+    @param  uiMaxClicks
+            The number of clicks, from 1 (single clicks only, reported without waiting) upwards.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setMultiClick(uint8_t uiButton, uint8_t uiMaxClicks) { asButtons[uiButton].uiMaxClicks = (uiMaxClicks > 0) ? uiMaxClicks : 1; }
+
+/**************************************************************************/
+/*!
+    @brief  Sets the time allowed from a release to the next press, for the press to continue a multi-click.
+    @param  ulClickWindow_MS
+            The window, in milliseconds.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setClickWindow(unsigned long ulClickWindow_MS) { this->ulClickWindow_MS = ulClickWindow_MS; }
+
+/**************************************************************************/
+/*!
+    @brief  Sets the time allowed between the presses of the two buttons of a chord.
+    @param  ulChordWindow_MS
+            The window, in milliseconds. 0 only accepts presses seen in the same scan.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setChordWindow(unsigned long ulChordWindow_MS) { this->ulChordWindow_MS = ulChordWindow_MS; }
+
+/**************************************************************************/
+/*!
+    @brief  Adds a chord of two buttons, held together.
+    @param  uiButtonA
+            The first button, in the order added.
+    @param  uiButtonB
+            The second button, in the order added. The two may be pressed in either order.
+    @return Returns true if the chord was added (it is numbered in the order added).
+			Returns false if the chords are full.
+*/
+/**************************************************************************/
+	bool addChord(uint8_t uiButtonA, uint8_t uiButtonB)
+	{
+		if (uiChordCount >= CHORDS)
+		{
+			return false;
+		}
+
+		auiChords[uiChordCount][0] = uiButtonA;
+		auiChords[uiChordCount][1] = uiButtonB;
+		uiChordCount++;
+
+		return true;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Refreshes every button, with one read of the clock, and detects gestures.
+    @return Returns the number of gestures queued.
+*/
+/**************************************************************************/
+	uint8_t update()
+	{
+		return update(AcksenButtonHAL::getMillis());
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Refreshes every button, using a time supplied by the caller, and detects gestures.
+    @param  ulNow_MS
+            The present time, in milliseconds.
+    @return Returns the number of gestures queued.
+*/
+/**************************************************************************/
+	uint8_t update(unsigned long ulNow_MS)
+	{
+		uint8_t uiQueued = 0;
+
+		for (uint8_t uiButton = 0; uiButton < uiCount; uiButton++)
+		{
+			ButtonState& sButton = asButtons[uiButton];
+
+			sButton.pButton->refreshStatus(ulNow_MS);
+
+			// A multi-click ends when the window passes without a further press
+			if ((sButton.uiClicks > 0) && !sButton.bDown && !acksenButtonTimeBefore(ulNow_MS, sButton.ulRelease_MS + ulClickWindow_MS))
+			{
+				uiQueued += reportClicks(uiButton);
+			}
+
+			bool bDown = sButton.pButton->getButtonState();
+
+			if (bDown == sButton.bDown)
+			{
+				continue;
+			}
+
+			sButton.bDown = bDown;
+
+			if (bDown)
+			{
+				sButton.ulPress_MS = ulNow_MS;
+				uiQueued += checkChords(uiButton, ulNow_MS);
+			}
+			else if (sButton.bChorded)
+			{
+				sButton.bChorded = false;
+			}
+			else
+			{
+				sButton.ulRelease_MS = ulNow_MS;
+
+				if (++sButton.uiClicks >= sButton.uiMaxClicks)
+				{
+					uiQueued += reportClicks(uiButton);
+				}
+			}
+		}
+
+		return uiQueued;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Reads and removes the oldest gesture.
+    @param  sGesture
+            Receives the gesture.
+    @return Returns true if a gesture was read.
+			Returns false if none are waiting.
+*/
+/**************************************************************************/
+	bool pollGesture(AcksenButtonGesture& sGesture) { return cGestures.pop(sGesture); }
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of gestures dropped because the queue was full (saturates at 255).
+*/
+/**************************************************************************/
+	uint8_t getGestureOverflowCount() { return cGestures.getOverflowCount(); }
+
+/**************************************************************************/
+/*!
+    @brief  Returns the earliest time update() has something to do: a button deadline, or the end of a click window.
+    @param  ulDeadline_MS
+            Receives the deadline, in milliseconds. It may already have passed, in which case an update is due now.
+    @return Returns true if a deadline was set.
+			Returns false if nothing will happen until an input changes.
+*/
+/**************************************************************************/
+	bool getNextDeadline(unsigned long& ulDeadline_MS)
+	{
+		bool bDeadlineSet = false;
+
+		for (uint8_t uiButton = 0; uiButton < uiCount; uiButton++)
+		{
+			const ButtonState& sButton = asButtons[uiButton];
+			unsigned long ulButtonDeadline_MS = 0;
+
+			if (sButton.pButton->getNextDeadline(ulButtonDeadline_MS) && (!bDeadlineSet || acksenButtonTimeBefore(ulButtonDeadline_MS, ulDeadline_MS)))
+			{
+				ulDeadline_MS = ulButtonDeadline_MS;
+				bDeadlineSet = true;
+			}
+
+			if ((sButton.uiClicks > 0) && !sButton.bDown)
+			{
+				ulButtonDeadline_MS = sButton.ulRelease_MS + ulClickWindow_MS;
+
+				if (!bDeadlineSet || acksenButtonTimeBefore(ulButtonDeadline_MS, ulDeadline_MS))
+				{
+					ulDeadline_MS = ulButtonDeadline_MS;
+					bDeadlineSet = true;
+				}
+			}
+		}
+
+		return bDeadlineSet;
+	}
+
+protected:
+
+	struct ButtonState
+	{
+		AcksenButton* pButton;
+		bool bDown;						// Debounced state, as last seen by update()
+		bool bChorded;					// Pressed as part of a chord - its release is not a click
+		uint8_t uiMaxClicks;
+		uint8_t uiClicks;				// Clicks counted in the gesture in progress
+		unsigned long ulPress_MS;
+		unsigned long ulRelease_MS;
+	};
+
+	// Reports a chord if the button just pressed completes one, and returns the number of gestures queued
+	uint8_t checkChords(uint8_t uiButton, unsigned long ulNow_MS)
+	{
+		for (uint8_t uiChord = 0; uiChord < uiChordCount; uiChord++)
+		{
+			uint8_t uiPartner;
+
+			if (auiChords[uiChord][0] == uiButton)
+			{
+				uiPartner = auiChords[uiChord][1];
+			}
+			else if (auiChords[uiChord][1] == uiButton)
+			{
+				uiPartner = auiChords[uiChord][0];
+			}
+			else
+			{
+				continue;
+			}
+
+			ButtonState& sPartner = asButtons[uiPartner];
+
+			if (!sPartner.bDown || sPartner.bChorded || (ulNow_MS - sPartner.ulPress_MS > ulChordWindow_MS))
+			{
+				continue;
+			}
+
+			// Clicks completed before the chord began are still reported, first
+			uint8_t uiQueued = reportClicks(uiPartner) + reportClicks(uiButton);
+			AcksenButtonGesture sGesture = { ulNow_MS, ACKSEN_BUTTON_GESTURE_CHORD, uiChord, 2 };
+
+			sPartner.bChorded = true;
+			asButtons[uiButton].bChorded = true;
+
+			return uiQueued + cGestures.push(sGesture);
+		}
+
+		return 0;
+	}
+
+	// Reports the clicks counted so far on a button, if any, and returns the number of gestures queued
+	uint8_t reportClicks(uint8_t uiButton)
+	{
+		ButtonState& sButton = asButtons[uiButton];
+
+		if (sButton.uiClicks == 0)
+		{
+			return 0;
+		}
+
+		AcksenButtonGesture sGesture = { sButton.ulRelease_MS, ACKSEN_BUTTON_GESTURE_CLICK, uiButton, sButton.uiClicks };
+
+		sButton.uiClicks = 0;
+
+		return cGestures.push(sGesture);
+	}
+
+	ButtonState asButtons[BUTTONS];
+	uint8_t uiCount;
+
+	uint8_t auiChords[CHORDS][2];
+	uint8_t uiChordCount;
+
+	unsigned long ulClickWindow_MS;
+	unsigned long ulChordWindow_MS;
+
+	AcksenButtonRing<AcksenButtonGesture, ACKSEN_BUTTON_GESTURE_QUEUE_SIZE> cGestures;
+
+};
+
+#endif
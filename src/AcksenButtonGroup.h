@@ -0,0 +1,174 @@
+/*!
+@file AcksenButtonGroup.h
+
+*/
+
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+// Button registry for the Acksen Button Library.
+//
+// AcksenButtonGroup holds a fixed number of AcksenButton pointers, and refreshes them all from a single read of
+// the clock. This avoids a millis() call (which briefly disables interrupts on AVR) per button, and means every
+// button in one scan sees exactly the same time.
+
+#ifndef AcksenButtonGroup_h
+#define AcksenButtonGroup_h
+
+#include "AcksenButtonHAL.h"
+#include "AcksenButton.h"
+
+/**************************************************************************/
+/*! 
+    @brief  Class that defines a registry of buttons refreshed together
+    @tparam CAPACITY
+            The maximum number of buttons that can be added to the group.
+*/
+/**************************************************************************/
+template <uint16_t CAPACITY>
+class AcksenButtonGroup
+{
+
+public:
+
+	AcksenButtonGroup() : uiCount(0) {}
+
+/**************************************************************************/
+/*!
+    @brief  Adds a button to the group.
+    @param  pButton
+            The button to add. It is not copied, so must outlive the group.
+    @return Returns true if the button was added.
+			Returns false if the group is full.
+*/
+/**************************************************************************/
+	bool add(AcksenButton* pButton)
+	{
+		if (uiCount >= CAPACITY)
+		{
+			return false;
+		}
+
+		apButtons[uiCount++] = pButton;
+
+		return true;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of buttons in the group.
+*/
+/**************************************************************************/
+	uint16_t getCount() { return uiCount; }
+
+/**************************************************************************/
+/*!
+    @brief  Returns a button in the group, in the order added.
+    @param  uiIndex
+            The index of the button, from 0 to getCount()-1.
+*/
+/**************************************************************************/
+	AcksenButton* getButton(uint16_t uiIndex) { return apButtons[uiIndex]; }
+
+#if ACKSEN_BUTTON_EVENTS
+
+/**************************************************************************/
+/*!
+    @brief  Publishes the events of every button in the group to one channel (see AcksenButton::setEventChannel()),
+			each with its index in the group as its id. A group of more than 256 buttons needs more than one channel.
+    @param  pEventChannel
+            The channel to publish to, or NULL to stop publishing.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setEventChannel(AcksenButtonEventChannel* pEventChannel)
+	{
+		for (uint16_t uiIndex = 0; uiIndex < uiCount; uiIndex++)
+		{
+			apButtons[uiIndex]->setEventChannel(pEventChannel, (uint8_t)uiIndex);
+		}
+	}
+
+#endif
+
+/**************************************************************************/
+/*!
+    @brief  Refreshes every button in the group, with one read of millis().
+			Groups of buttons timed in microseconds (see AcksenButton::setTimeBase()) must use refreshAll(micros()).
+    @return Returns the number of buttons whose refreshStatus() returned true.
+*/
+/**************************************************************************/
+	uint16_t refreshAll()
+	{
+		return refreshAll(AcksenButtonHAL::getMillis());
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Refreshes every button in the group, using a time supplied by the caller.
+    @param  ulNow_MS
+            The present time, in milliseconds (or microseconds, for buttons timed in microseconds).
+    @return Returns the number of buttons whose refreshStatus() returned true.
+*/
+/**************************************************************************/
+	uint16_t refreshAll(unsigned long ulNow_MS)
+	{
+		uint16_t uiChanged = 0;
+
+		for (uint16_t uiIndex = 0; uiIndex < uiCount; uiIndex++)
+		{
+			uiChanged += apButtons[uiIndex]->refreshStatus(ulNow_MS);
+		}
+
+		return uiChanged;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Returns the earliest AcksenButton::getNextDeadline() of the buttons in the group.
+			A scheduler can sleep until this time, or until a pin change, before calling refreshAll() again.
+    @param  ulDeadline_MS
+            Receives the deadline, in milliseconds. It may already have passed, in which case a refresh is due now.
+    @return Returns true if a deadline was set.
+			Returns false if nothing will happen until an input changes.
+*/
+/**************************************************************************/
+	bool getNextDeadline(unsigned long& ulDeadline_MS)
+	{
+		bool bDeadlineSet = false;
+
+		for (uint16_t uiIndex = 0; uiIndex < uiCount; uiIndex++)
+		{
+			unsigned long ulButtonDeadline_MS = 0;
+
+			if (apButtons[uiIndex]->getNextDeadline(ulButtonDeadline_MS) && (!bDeadlineSet || acksenButtonTimeBefore(ulButtonDeadline_MS, ulDeadline_MS)))
+			{
+				ulDeadline_MS = ulButtonDeadline_MS;
+				bDeadlineSet = true;
+			}
+		}
+
+		return bDeadlineSet;
+	}
+
+protected:
+
+	AcksenButton* apButtons[CAPACITY];
+	uint16_t uiCount;
+
+};
+
+#endif
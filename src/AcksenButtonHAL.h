@@ -0,0 +1,307 @@
+/*!
+@file AcksenButtonHAL.h
+
+*/
+
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+// Hardware Abstraction Layer for the Acksen Button Library.
+//
+// All access to the clock and I/O pins from the library goes through AcksenButtonHAL, so that the
+// library can be built and benchmarked on a host PC (see extras/host) as well as on Arduino targets.
+//
+// When built by the Arduino IDE (ARDUINO is defined), each call forwards directly to the Arduino core
+// and is inlined away. For any other build, the functions are declared here and must be supplied by
+// the platform - extras/host/AcksenButtonHost.cpp provides a mock GPIO and a deterministic simulated clock.
+//
+// On AVR, getInputRegister() and getPinBitMask() let a button resolve its pin's input register once, and read it
+// directly instead of calling digitalRead(). Define ACKSEN_BUTTON_DISABLE_PORT_INPUT to always use digitalRead().
+// Other cores keep digitalRead() by default, as their portInputRegister()/digitalPinToBitMask() do not always
+// describe how a pin is really read - on ESP8266, for example, GPIO16 is read through GP16I rather than the port
+// those macros give, so a register read would never see it change. Define ACKSEN_BUTTON_ENABLE_PORT_INPUT to read
+// registers directly on such a core, once every pin in use is known to be readable that way.
+//
+// startAnalogRead()/isAnalogReadComplete()/getAnalogResult() run an ADC conversion without waiting for it. On AVR
+// they drive the ADC registers directly, using the reference selected by ACKSEN_BUTTON_ANALOG_REFERENCE (AVcc by
+// default). Other cores fall back to analogRead(), which completes within startAnalogRead(). Define
+// ACKSEN_BUTTON_DISABLE_ANALOG_ADC to use analogRead() on AVR too.
+//
+// Constant tables (e.g. acceleration curves) are placed in flash with PROGMEM, and read with readProgramWord().
+// PROGMEM is defined as nothing where the platform has no separate program memory.
+
+#ifndef AcksenButtonHAL_h
+#define AcksenButtonHAL_h
+
+#include <inttypes.h>
+#include <stddef.h>
+
+#if defined(ARDUINO)
+
+#include "Arduino.h"
+
+#if defined(portInputRegister) && defined(digitalPinToPort) && defined(digitalPinToBitMask) && !defined(ACKSEN_BUTTON_DISABLE_PORT_INPUT) && \
+	(defined(__AVR__) || defined(ACKSEN_BUTTON_ENABLE_PORT_INPUT))
+#define ACKSEN_BUTTON_PORT_INPUT		///< Defined when buttons can read their input register directly
+#endif
+
+#if defined(__AVR__) && defined(ADCSRA) && defined(ADSC) && defined(ADMUX) && !defined(ACKSEN_BUTTON_DISABLE_ANALOG_ADC)
+#define ACKSEN_BUTTON_ANALOG_ADC		///< Defined when analog conversions run in the background, on the ADC registers
+#endif
+
+#ifndef ACKSEN_BUTTON_ANALOG_REFERENCE
+#define ACKSEN_BUTTON_ANALOG_REFERENCE	DEFAULT	///< ADC reference (REFS bits of ADMUX) for background conversions
+#endif
+
+#else
+
+// Arduino constants used by the library and its callers
+#ifndef LOW
+#define LOW								0x0
+#endif
+#ifndef HIGH
+#define HIGH							0x1
+#endif
+#ifndef INPUT
+#define INPUT							0x0
+#endif
+#ifndef OUTPUT
+#define OUTPUT							0x1
+#endif
+#ifndef INPUT_PULLUP
+#define INPUT_PULLUP					0x2
+#endif
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+#endif
+
+// Width of an input port register - 8 bits on AVR (and the host mock GPIO), 32 bits on other Arduino cores
+#if defined(__AVR__) || !defined(ARDUINO)
+typedef uint8_t AcksenButtonPort_t;
+#else
+typedef uint32_t AcksenButtonPort_t;
+#endif
+
+/**************************************************************************/
+/*!
+    @brief  Class that defines the platform functions used by the AcksenButton library
+*/
+/**************************************************************************/
+class AcksenButtonHAL
+{
+
+public:
+
+#if defined(ARDUINO)
+
+	static inline unsigned long getMillis() { return millis(); }
+	static inline unsigned long getMicros() { return micros(); }
+	static inline bool readPin(uint8_t uiPin) { return digitalRead(uiPin); }
+	static inline void setPinMode(uint8_t uiPin, uint8_t uiMode) { pinMode(uiPin, uiMode); }
+	static inline void writePin(uint8_t uiPin, bool bLevel) { digitalWrite(uiPin, bLevel ? HIGH : LOW); }
+	static inline void delayMicros(uint16_t uiMicros) { delayMicroseconds(uiMicros); }
+
+#if defined(pgm_read_word)
+	static inline uint16_t readProgramWord(const uint16_t* puiWord) { return pgm_read_word(puiWord); }
+#else
+	static inline uint16_t readProgramWord(const uint16_t* puiWord) { return *puiWord; }
+#endif
+
+#if defined(ACKSEN_BUTTON_PORT_INPUT)
+
+	static inline const volatile AcksenButtonPort_t* getInputRegister(uint8_t uiPin)
+	{
+		// Only AVR ports are known to be numbered, with NOT_A_PIN for pins that have none - elsewhere the port may be a
+		// pointer or structure, so rely on portInputRegister() alone
+#if defined(__AVR__) && defined(NOT_A_PIN)
+		if (digitalPinToPort(uiPin) == NOT_A_PIN)
+		{
+			return NULL;
+		}
+#endif
+		return (const volatile AcksenButtonPort_t*)portInputRegister(digitalPinToPort(uiPin));
+	}
+
+	static inline AcksenButtonPort_t getPinBitMask(uint8_t uiPin) { return (AcksenButtonPort_t)digitalPinToBitMask(uiPin); }
+
+#else
+
+	static inline const volatile AcksenButtonPort_t* getInputRegister(uint8_t) { return NULL; }
+	static inline AcksenButtonPort_t getPinBitMask(uint8_t) { return 0; }
+
+#endif
+
+#if defined(ACKSEN_BUTTON_ANALOG_ADC)
+
+	static inline void startAnalogRead(uint8_t uiPin)
+	{
+		// Accept A0, A1... or channel numbers, as analogRead() does
+#if defined(PIN_A0)
+		if (uiPin >= PIN_A0)
+		{
+			uiPin -= PIN_A0;
+		}
+#endif
+#if defined(analogPinToChannel)
+		uiPin = analogPinToChannel(uiPin);
+#endif
+#if defined(ADCSRB) && defined(MUX5)
+		ADCSRB = (ADCSRB & ~(1 << MUX5)) | (((uiPin >> 3) & 0x01) << MUX5);
+#endif
+		ADMUX = (ACKSEN_BUTTON_ANALOG_REFERENCE << 6) | (uiPin & 0x07);
+		ADCSRA |= (1 << ADSC);
+	}
+
+	static inline bool isAnalogReadComplete() { return (ADCSRA & (1 << ADSC)) == 0; }
+	static inline uint16_t getAnalogResult() { return ADC; }
+
+#else
+
+	static inline void startAnalogRead(uint8_t uiPin) { analogResult() = analogRead(uiPin); }
+	static inline bool isAnalogReadComplete() { return true; }
+	static inline uint16_t getAnalogResult() { return analogResult(); }
+
+private:
+
+	static inline uint16_t& analogResult()
+	{
+		static uint16_t uiAnalogResult = 0;
+
+		return uiAnalogResult;
+	}
+
+public:
+
+#endif
+
+#else
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of milliseconds since startup (equivalent to Arduino millis()).
+*/
+/**************************************************************************/
+	static unsigned long getMillis();
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of microseconds since startup (equivalent to Arduino micros()).
+*/
+/**************************************************************************/
+	static unsigned long getMicros();
+
+/**************************************************************************/
+/*!
+    @brief  Returns the level of an I/O pin (equivalent to Arduino digitalRead()).
+    @param  uiPin
+            The I/O pin to read.
+    @return Returns true if the input is HIGH.
+			Returns false if the input is LOW.
+*/
+/**************************************************************************/
+	static bool readPin(uint8_t uiPin);
+
+/**************************************************************************/
+/*!
+    @brief  Configures an I/O pin (equivalent to Arduino pinMode()).
+    @param  uiPin
+            The I/O pin to configure.
+    @param  uiMode
+            INPUT, OUTPUT or INPUT_PULLUP.
+*/
+/**************************************************************************/
+	static void setPinMode(uint8_t uiPin, uint8_t uiMode);
+
+/**************************************************************************/
+/*!
+    @brief  Sets the level driven on an output pin (equivalent to Arduino digitalWrite()).
+    @param  uiPin
+            The I/O pin to write.
+    @param  bLevel
+            true for HIGH, false for LOW.
+*/
+/**************************************************************************/
+	static void writePin(uint8_t uiPin, bool bLevel);
+
+/**************************************************************************/
+/*!
+    @brief  Waits for a number of microseconds (equivalent to Arduino delayMicroseconds()).
+    @param  uiMicros
+            The time to wait.
+*/
+/**************************************************************************/
+	static void delayMicros(uint16_t uiMicros);
+
+/**************************************************************************/
+/*!
+    @brief  Reads a word from a table declared PROGMEM (equivalent to pgm_read_word()).
+    @param  puiWord
+            The word to read.
+*/
+/**************************************************************************/
+	static inline uint16_t readProgramWord(const uint16_t* puiWord) { return *puiWord; }
+
+/**************************************************************************/
+/*!
+    @brief  Returns the input register holding an I/O pin (equivalent to portInputRegister(digitalPinToPort())).
+    @param  uiPin
+            The I/O pin.
+    @return Returns a pointer to the register, or NULL if the pin cannot be read directly.
+*/
+/**************************************************************************/
+	static const volatile AcksenButtonPort_t* getInputRegister(uint8_t uiPin);
+
+/**************************************************************************/
+/*!
+    @brief  Returns the bit of an I/O pin within its input register (equivalent to digitalPinToBitMask()).
+    @param  uiPin
+            The I/O pin.
+*/
+/**************************************************************************/
+	static AcksenButtonPort_t getPinBitMask(uint8_t uiPin);
+
+/**************************************************************************/
+/*!
+    @brief  Starts an ADC conversion of an analog pin, without waiting for it to complete.
+    @param  uiPin
+            The analog pin to convert.
+*/
+/**************************************************************************/
+	static void startAnalogRead(uint8_t uiPin);
+
+/**************************************************************************/
+/*!
+    @brief  Returns whether the conversion started by startAnalogRead() has completed.
+    @return Returns true if the result is ready.
+			Returns false if the conversion is still running.
+*/
+/**************************************************************************/
+	static bool isAnalogReadComplete();
+
+/**************************************************************************/
+/*!
+    @brief  Returns the result of the last completed conversion (equivalent to the value of Arduino analogRead()).
+*/
+/**************************************************************************/
+	static uint16_t getAnalogResult();
+
+#endif
+
+};
+
+#endif
@@ -0,0 +1,283 @@
+/*!
+@file AcksenButtonMatrix.h
+
+*/
+
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+// Keypad matrix scanner for the Acksen Button Library.
+//
+// AcksenButtonMatrix drives the rows of a key matrix one at a time and reads the columns. The present state of
+// every key is kept as one word per row, and each key is an ordinary AcksenButton that reads its bit of that word
+// (see AcksenButtonVirtualInput), so keys keep every AcksenButton mode, debounce strategy and event queue.
+//
+// Rows are left as high impedance inputs, and pulled LOW one at a time by switching them to OUTPUT. Columns use
+// the internal pull-ups, so a pressed key reads LOW on its column while its row is driven. Each column's input
+// register is resolved once, and each row costs two pin mode changes plus one read of each distinct register
+// holding columns - a single read when all the columns share a port.
+//
+// The weak pull-ups take time to raise a column again once the row that pulled it LOW is released, so a column read
+// straight after driving the next row would still show the previous row's key. After driving each row the scanner
+// waits a settle time (ACKSEN_BUTTON_MATRIX_SETTLE_US, or setSettleTime()) before reading the columns. Long wires,
+// or external pull-ups above the internal ones, may need longer; each scan takes at least ROWS settle times.
+//
+// Without a diode per key, three keys pressed at the corners of a rectangle make the fourth appear pressed too.
+// After each scan any two rows sharing two or more pressed columns are flagged as ghosting, and those rows keep
+// their previous state until the ambiguity clears.
+
+#ifndef AcksenButtonMatrix_h
+#define AcksenButtonMatrix_h
+
+#include "AcksenButtonHAL.h"
+#include "AcksenButton.h"
+
+#ifndef ACKSEN_BUTTON_MATRIX_SETTLE_US
+#define ACKSEN_BUTTON_MATRIX_SETTLE_US		5		///< Default time allowed for the columns to settle after driving a row (Microseconds)
+#endif
+
+/**************************************************************************/
+/*! 
+    @brief  Class that defines a scanned key matrix, whose keys are read by AcksenButton instances
+    @tparam ROWS
+            The number of rows (driven pins).
+    @tparam COLUMNS
+            The number of columns (read pins), up to the width of AcksenButtonPort_t (8 on AVR, 32 on other cores).
+*/
+/**************************************************************************/
+template <uint8_t ROWS, uint8_t COLUMNS>
+class AcksenButtonMatrix
+{
+
+public:
+
+/**************************************************************************/
+/*!
+    @brief  Class initialisation.
+            Sets the row pins to high impedance inputs and the column pins to inputs with pull-ups.
+    @param  auiRowPins
+            The I/O pins of the rows, ROWS entries.
+    @param  auiColumnPins
+            The I/O pins of the columns, COLUMNS entries.
+    @return No return value.
+*/
+/**************************************************************************/
+	AcksenButtonMatrix(const uint8_t* auiRowPins, const uint8_t* auiColumnPins) : uiColumnRegisters(0), uiSettle_US(ACKSEN_BUTTON_MATRIX_SETTLE_US), bGhosting(false), uiGhostingCount(0)
+	{
+		static_assert(COLUMNS <= sizeof(AcksenButtonPort_t) * 8, "AcksenButtonMatrix has more columns than bits in AcksenButtonPort_t");
+
+		for (uint8_t uiRow = 0; uiRow < ROWS; uiRow++)
+		{
+			auiRowPin[uiRow] = auiRowPins[uiRow];
+			auiKeyState[uiRow] = 0;
+
+			// Driven LOW whenever switched to OUTPUT
+			AcksenButtonHAL::writePin(auiRowPin[uiRow], false);
+			AcksenButtonHAL::setPinMode(auiRowPin[uiRow], INPUT);
+		}
+
+		for (uint8_t uiColumn = 0; uiColumn < COLUMNS; uiColumn++)
+		{
+			uint8_t uiPin = auiColumnPins[uiColumn];
+			const volatile AcksenButtonPort_t* pRegister = AcksenButtonHAL::getInputRegister(uiPin);
+			uint8_t uiRegister = 0;
+
+			AcksenButtonHAL::setPinMode(uiPin, INPUT_PULLUP);
+
+			auiColumnPin[uiColumn] = uiPin;
+			auiColumnMask[uiColumn] = AcksenButtonHAL::getPinBitMask(uiPin);
+
+			// Columns sharing an input register are read together
+			while ((uiRegister < uiColumnRegisters) && (apColumnRegister[uiRegister] != pRegister))
+			{
+				uiRegister++;
+			}
+
+			if (uiRegister == uiColumnRegisters)
+			{
+				apColumnRegister[uiColumnRegisters++] = pRegister;
+			}
+
+			auiColumnRegister[uiColumn] = uiRegister;
+		}
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Returns the input of a key, for constructing the AcksenButton that reads it.
+			The input is HIGH while the key is pressed.
+    @param  uiRow
+            The row of the key, from 0 to ROWS-1.
+    @param  uiColumn
+            The column of the key, from 0 to COLUMNS-1.
+*/
+/**************************************************************************/
+	AcksenButtonVirtualInput getKeyInput(uint8_t uiRow, uint8_t uiColumn)
+	{
+		return AcksenButtonVirtualInput(&auiKeyState[uiRow], (AcksenButtonPort_t)((AcksenButtonPort_t)1 << uiColumn));
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Sets the time allowed for the columns to settle after driving each row, before they are read.
+    @param  uiSettle_US
+            The settle time, in microseconds (default ACKSEN_BUTTON_MATRIX_SETTLE_US). 0 reads the columns at once.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setSettleTime(uint16_t uiSettle_US) { this->uiSettle_US = uiSettle_US; }
+
+/**************************************************************************/
+/*!
+    @brief  Scans every row of the matrix, updating the key inputs. Call before refreshing the keys.
+    @return Returns true if ghosting was detected in this scan.
+			Returns false if every pressed key could be identified.
+*/
+/**************************************************************************/
+	bool scan()
+	{
+		AcksenButtonPort_t auiScanned[ROWS];
+
+		for (uint8_t uiRow = 0; uiRow < ROWS; uiRow++)
+		{
+			AcksenButtonPort_t auiRegister[COLUMNS];
+			AcksenButtonPort_t uiPressed = 0;
+
+			AcksenButtonHAL::setPinMode(auiRowPin[uiRow], OUTPUT);
+
+			// Let columns released by the previous row rise again
+			if (uiSettle_US > 0)
+			{
+				AcksenButtonHAL::delayMicros(uiSettle_US);
+			}
+
+			for (uint8_t uiRegister = 0; uiRegister < uiColumnRegisters; uiRegister++)
+			{
+				auiRegister[uiRegister] = (apColumnRegister[uiRegister] != NULL) ? *apColumnRegister[uiRegister] : 0;
+			}
+
+			for (uint8_t uiColumn = 0; uiColumn < COLUMNS; uiColumn++)
+			{
+				bool bLevel;
+
+				if (apColumnRegister[auiColumnRegister[uiColumn]] != NULL)
+				{
+					bLevel = (auiRegister[auiColumnRegister[uiColumn]] & auiColumnMask[uiColumn]) != 0;
+				}
+				else
+				{
+					bLevel = AcksenButtonHAL::readPin(auiColumnPin[uiColumn]);
+				}
+
+				if (!bLevel)
+				{
+					uiPressed |= (AcksenButtonPort_t)((AcksenButtonPort_t)1 << uiColumn);
+				}
+			}
+
+			AcksenButtonHAL::setPinMode(auiRowPin[uiRow], INPUT);
+
+			auiScanned[uiRow] = uiPressed;
+		}
+
+		return applyScan(auiScanned);
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Returns the pressed keys of a row, one bit per column, as of the last scan.
+    @param  uiRow
+            The row, from 0 to ROWS-1.
+*/
+/**************************************************************************/
+	AcksenButtonPort_t getRowState(uint8_t uiRow) { return auiKeyState[uiRow]; }
+
+/**************************************************************************/
+/*!
+    @brief  Returns true if ghosting was detected in the last scan.
+*/
+/**************************************************************************/
+	bool isGhosting() { return bGhosting; }
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of scans in which ghosting was detected (saturates at 65535).
+*/
+/**************************************************************************/
+	uint16_t getGhostingCount() { return uiGhostingCount; }
+
+protected:
+
+	// Updates the key state from a scan, holding rows that cannot be resolved
+	bool applyScan(const AcksenButtonPort_t* auiScanned)
+	{
+		bool abAmbiguous[ROWS];
+
+		bGhosting = false;
+
+		for (uint8_t uiRow = 0; uiRow < ROWS; uiRow++)
+		{
+			abAmbiguous[uiRow] = false;
+		}
+
+		for (uint8_t uiRowA = 0; uiRowA < ROWS; uiRowA++)
+		{
+			for (uint8_t uiRowB = uiRowA + 1; uiRowB < ROWS; uiRowB++)
+			{
+				AcksenButtonPort_t uiShared = auiScanned[uiRowA] & auiScanned[uiRowB];
+
+				// Two or more shared columns - at least one of the four corners is a ghost
+				if ((uiShared & (AcksenButtonPort_t)(uiShared - 1)) != 0)
+				{
+					abAmbiguous[uiRowA] = true;
+					abAmbiguous[uiRowB] = true;
+					bGhosting = true;
+				}
+			}
+		}
+
+		for (uint8_t uiRow = 0; uiRow < ROWS; uiRow++)
+		{
+			if (!abAmbiguous[uiRow])
+			{
+				auiKeyState[uiRow] = auiScanned[uiRow];
+			}
+		}
+
+		if (bGhosting && (uiGhostingCount < 0xFFFF))
+		{
+			uiGhostingCount++;
+		}
+
+		return bGhosting;
+	}
+
+	uint8_t auiRowPin[ROWS];
+	uint8_t auiColumnPin[COLUMNS];
+	AcksenButtonPort_t auiColumnMask[COLUMNS];
+	uint8_t auiColumnRegister[COLUMNS];							///< Index into apColumnRegister for each column
+	const volatile AcksenButtonPort_t* apColumnRegister[COLUMNS];	///< Distinct input registers holding columns (NULL - read with readPin())
+	uint8_t uiColumnRegisters;
+	uint16_t uiSettle_US;										///< Wait after driving each row, before reading the columns
+
+	volatile AcksenButtonPort_t auiKeyState[ROWS];				///< Pressed keys, one word per row - read by the keys' AcksenButtons
+
+	bool bGhosting;
+	uint16_t uiGhostingCount;
+
+};
+
+#endif
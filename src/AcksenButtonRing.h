@@ -0,0 +1,230 @@
+/*!
+@file AcksenButtonRing.h
+
+*/
+
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+// Lock-free single-producer/single-consumer ring buffer for the Acksen Button Library.
+//
+// One side (e.g. an interrupt handler, or a scanning task) only ever calls push(), and the other side only
+// ever calls pop()/peek(). Each index is written by one side only, so no locking or interrupt masking is
+// needed. On AVR the 8-bit indices are naturally atomic and a compiler barrier orders the slot access;
+// elsewhere std::atomic provides the acquire/release ordering, so the ring is also safe between threads.
+
+#ifndef AcksenButtonRing_h
+#define AcksenButtonRing_h
+
+#include <inttypes.h>
+
+#if !defined(__AVR__)
+#include <atomic>
+#endif
+
+/**************************************************************************/
+/*!
+    @brief  Class that defines a byte written by one side of an AcksenButtonRing, and read by the other
+*/
+/**************************************************************************/
+class AcksenButtonSharedByte
+{
+
+public:
+
+#if defined(__AVR__)
+
+	AcksenButtonSharedByte() : uiValue(0) {}
+
+	uint8_t load() const { uint8_t uiResult = uiValue; __asm__ __volatile__("" ::: "memory"); return uiResult; }		///< Read the value written by the other side, before accessing the slots it guards
+	void store(uint8_t uiNewValue) { __asm__ __volatile__("" ::: "memory"); uiValue = uiNewValue; }					///< Write the value, after accessing the slots it guards
+	uint8_t loadOwned() const { return uiValue; }																	///< Read the value from the side that writes it
+
+private:
+
+	volatile uint8_t uiValue;
+
+#else
+
+	AcksenButtonSharedByte() : uiValue(0) {}
+
+	uint8_t load() const { return uiValue.load(std::memory_order_acquire); }				///< Read the value written by the other side, before accessing the slots it guards
+	void store(uint8_t uiNewValue) { uiValue.store(uiNewValue, std::memory_order_release); }	///< Write the value, after accessing the slots it guards
+	uint8_t loadOwned() const { return uiValue.load(std::memory_order_relaxed); }			///< Read the value from the side that writes it
+
+private:
+
+	std::atomic<uint8_t> uiValue;
+
+#endif
+
+};
+
+/**************************************************************************/
+/*!
+    @brief  Class that defines a fixed-capacity lock-free single-producer/single-consumer ring buffer
+    @tparam T
+            The element type.
+    @tparam SIZE
+            The number of slots - must be a power of two, no greater than 128. One slot is always kept free,
+			so the ring holds up to SIZE-1 elements.
+*/
+/**************************************************************************/
+template <typename T, uint8_t SIZE>
+class AcksenButtonRing
+{
+
+	static_assert((SIZE >= 2) && (SIZE <= 128) && ((SIZE & (SIZE - 1)) == 0), "AcksenButtonRing SIZE must be a power of two from 2 to 128");
+
+public:
+
+/**************************************************************************/
+/*!
+    @brief  Adds an element to the ring. Producer side only.
+    @param  sElement
+            The element to add.
+    @return Returns true if the element was added.
+			Returns false if the ring was full, in which case the element is dropped and the overflow count incremented.
+*/
+/**************************************************************************/
+	bool push(const T& sElement)
+	{
+		uint8_t uiHead = cHead.loadOwned();
+		uint8_t uiNext = (uint8_t)((uiHead + 1) & (SIZE - 1));
+
+		if (uiNext == cTail.load())
+		{
+			// Saturate rather than wrap, so a large overflow is never reported as a small one
+			uint8_t uiOverflows = cOverflowCount.loadOwned();
+
+			if (uiOverflows < 0xFF)
+			{
+				cOverflowCount.store(uiOverflows + 1);
+			}
+
+			// Always differs from the consumer's acknowledgement, so the flag cannot wrap back to clear
+			cOverflowFlag.store((uint8_t)(cOverflowAcknowledged.load() + 1));
+
+			return false;
+		}
+
+		aSlots[uiHead] = sElement;
+		cHead.store(uiNext);
+
+		return true;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Reads the oldest element without removing it. Consumer side only.
+    @param  sElement
+            Receives the element.
+    @return Returns true if an element was available.
+			Returns false if the ring was empty.
+*/
+/**************************************************************************/
+	bool peek(T& sElement)
+	{
+		uint8_t uiTail = cTail.loadOwned();
+
+		if (uiTail == cHead.load())
+		{
+			return false;
+		}
+
+		sElement = aSlots[uiTail];
+
+		return true;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Removes the oldest element. Consumer side only.
+    @param  sElement
+            Receives the element.
+    @return Returns true if an element was removed.
+			Returns false if the ring was empty.
+*/
+/**************************************************************************/
+	bool pop(T& sElement)
+	{
+		if (!peek(sElement))
+		{
+			return false;
+		}
+
+		cTail.store((uint8_t)((cTail.loadOwned() + 1) & (SIZE - 1)));
+
+		return true;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Returns true if there are no elements waiting. Consumer side only.
+*/
+/**************************************************************************/
+	bool isEmpty() const
+	{
+		return cTail.loadOwned() == cHead.load();
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of elements dropped because the ring was full (saturates at 255).
+*/
+/**************************************************************************/
+	uint8_t getOverflowCount() const
+	{
+		return cOverflowCount.load();
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Returns true if an element has been dropped since clearOverflow() was last called. Consumer side only.
+			Unlike getOverflowCount(), this never saturates, so the consumer can always tell that it has missed
+			something and needs to resynchronise.
+*/
+/**************************************************************************/
+	bool hasOverflowed() const
+	{
+		return cOverflowFlag.load() != cOverflowAcknowledged.loadOwned();
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Acknowledges the elements dropped so far, clearing hasOverflowed(). Consumer side only.
+			Elements dropped after this call set hasOverflowed() again.
+*/
+/**************************************************************************/
+	void clearOverflow()
+	{
+		cOverflowAcknowledged.store(cOverflowFlag.load());
+	}
+
+private:
+
+	T aSlots[SIZE];
+
+	AcksenButtonSharedByte cHead;		// Written by the producer only
+	AcksenButtonSharedByte cTail;		// Written by the consumer only
+
+	AcksenButtonSharedByte cOverflowCount;	// Written by the producer only
+	AcksenButtonSharedByte cOverflowFlag;	// Written by the producer only - set by making it differ from cOverflowAcknowledged
+	AcksenButtonSharedByte cOverflowAcknowledged;	// Written by the consumer only
+
+};
+
+#endif
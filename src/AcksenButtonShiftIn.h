@@ -0,0 +1,195 @@
+/*!
+@file AcksenButtonShiftIn.h
+
+*/
+
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+// Shift register input expansion for the Acksen Button Library.
+//
+// AcksenButtonShiftIn reads a chain of parallel-in/serial-out shift registers (e.g. 74HC165), BYTES long, into
+// a buffer with one latch pulse and one bus transfer per scan. Each button is an ordinary AcksenButton reading its
+// bit of the buffer (see AcksenButtonVirtualInput), so every mode, debounce strategy and event queue still applies.
+// The buffer can equally be packed into a word for AcksenButtonBank.
+//
+// The transfer itself is left to a function supplied by the sketch, normally a single SPI.transfer(buffer, length)
+// inside an SPI transaction, so the library does not depend on SPI.h. Without SPI, the chain can be bit-banged
+// on any two pins instead.
+//
+// Bits are numbered in the order they arrive: bit 0 to 7 are the first byte received (from the register nearest
+// the microcontroller, input D0 to D7), bit 8 to 15 the next, and so on.
+
+#ifndef AcksenButtonShiftIn_h
+#define AcksenButtonShiftIn_h
+
+#include "AcksenButtonHAL.h"
+#include "AcksenButton.h"
+
+typedef void (*AcksenButtonTransferFunction)(uint8_t* auiBuffer, uint8_t uiLength);	///< Clocks uiLength bytes in from the shift register chain
+
+/**************************************************************************/
+/*! 
+    @brief  Class that defines a chain of input shift registers, whose bits are read by AcksenButton instances
+    @tparam BYTES
+            The length of the chain in bytes (i.e. the number of 8-bit shift registers).
+*/
+/**************************************************************************/
+template <uint8_t BYTES>
+class AcksenButtonShiftIn
+{
+
+public:
+
+	static const uint16_t INPUTS = (uint16_t)BYTES * 8;		///< Number of inputs in the chain
+
+/**************************************************************************/
+/*!
+    @brief  Class initialisation, reading the chain through a bus transfer function (e.g. SPI).
+    @param  uiLatchPin
+            The I/O pin driving the parallel load input of every register (SH/LD on a 74HC165), active LOW.
+    @param  pTransfer
+            The function that clocks BYTES bytes in from the chain, e.g. SPI.transfer(auiBuffer, uiLength) within a transaction.
+    @return No return value.
+*/
+/**************************************************************************/
+	AcksenButtonShiftIn(uint8_t uiLatchPin, AcksenButtonTransferFunction pTransfer) : pTransfer(pTransfer), uiDataPin(0), uiClockPin(0)
+	{
+		initialise(uiLatchPin);
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Class initialisation, bit-banging the chain on two I/O pins.
+    @param  uiLatchPin
+            The I/O pin driving the parallel load input of every register (SH/LD on a 74HC165), active LOW.
+    @param  uiDataPin
+            The I/O pin reading the serial output of the chain (QH on a 74HC165).
+    @param  uiClockPin
+            The I/O pin driving the shift clock of every register (CLK on a 74HC165).
+    @return No return value.
+*/
+/**************************************************************************/
+	AcksenButtonShiftIn(uint8_t uiLatchPin, uint8_t uiDataPin, uint8_t uiClockPin) : pTransfer(NULL), uiDataPin(uiDataPin), uiClockPin(uiClockPin)
+	{
+		AcksenButtonHAL::setPinMode(uiDataPin, INPUT);
+		AcksenButtonHAL::writePin(uiClockPin, false);
+		AcksenButtonHAL::setPinMode(uiClockPin, OUTPUT);
+
+		initialise(uiLatchPin);
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Inverts every input as it is read, for buttons that pull their input LOW when pressed.
+    @param  bInvert
+            true to invert the inputs, false to use them as read.
+    @return No return value.
+*/
+/**************************************************************************/
+	void setInputInversion(bool bInvert) { uiInvert = bInvert ? 0xFF : 0x00; }
+
+/**************************************************************************/
+/*!
+    @brief  Returns the input of one bit of the chain, for constructing the AcksenButton that reads it.
+    @param  uiInput
+            The input, from 0 to INPUTS-1, in the order received.
+*/
+/**************************************************************************/
+	AcksenButtonVirtualInput getInput(uint16_t uiInput)
+	{
+		return AcksenButtonVirtualInput(&auiInputs[uiInput / 8], (AcksenButtonPort_t)(1 << (uiInput % 8)));
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Latches every input of the chain and reads it into the buffer. Call before refreshing the buttons.
+    @return No return value.
+*/
+/**************************************************************************/
+	void read()
+	{
+		uint8_t auiReceived[BYTES];
+
+		// Load the parallel inputs into the registers
+		AcksenButtonHAL::writePin(uiLatchPin, false);
+		AcksenButtonHAL::writePin(uiLatchPin, true);
+
+		if (pTransfer != NULL)
+		{
+			pTransfer(auiReceived, BYTES);
+		}
+		else
+		{
+			for (uint8_t uiByte = 0; uiByte < BYTES; uiByte++)
+			{
+				uint8_t uiValue = 0;
+
+				// Most significant bit first - each bit is presented before the clock edge that shifts in the next
+				for (uint8_t uiBit = 0; uiBit < 8; uiBit++)
+				{
+					uiValue = (uint8_t)((uiValue << 1) | (AcksenButtonHAL::readPin(uiDataPin) ? 1 : 0));
+
+					AcksenButtonHAL::writePin(uiClockPin, true);
+					AcksenButtonHAL::writePin(uiClockPin, false);
+				}
+
+				auiReceived[uiByte] = uiValue;
+			}
+		}
+
+		for (uint8_t uiByte = 0; uiByte < BYTES; uiByte++)
+		{
+			auiInputs[uiByte] = auiReceived[uiByte] ^ uiInvert;
+		}
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Returns one byte of the buffer, as of the last read().
+    @param  uiByte
+            The byte, from 0 to BYTES-1, in the order received.
+*/
+/**************************************************************************/
+	uint8_t getByte(uint8_t uiByte) { return (uint8_t)auiInputs[uiByte]; }
+
+protected:
+
+	void initialise(uint8_t uiLatchPin)
+	{
+		this->uiLatchPin = uiLatchPin;
+		uiInvert = 0x00;
+
+		AcksenButtonHAL::writePin(uiLatchPin, true);
+		AcksenButtonHAL::setPinMode(uiLatchPin, OUTPUT);
+
+		for (uint8_t uiByte = 0; uiByte < BYTES; uiByte++)
+		{
+			auiInputs[uiByte] = 0;
+		}
+	}
+
+	AcksenButtonTransferFunction pTransfer;
+	uint8_t uiLatchPin;
+	uint8_t uiDataPin;
+	uint8_t uiClockPin;
+	uint8_t uiInvert;
+
+	volatile AcksenButtonPort_t auiInputs[BYTES];		///< One received byte per word - read by the buttons' AcksenButtons
+
+};
+
+#endif
@@ -0,0 +1,334 @@
+/*!
+@file AcksenButtonStatic.h
+
+*/
+
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+// Compile-time specialised button for the Acksen Button Library.
+//
+// AcksenButtonStatic behaves like an AcksenButton polling its pin, but the pin, mode and all intervals are
+// template parameters. Each mode is a separate specialisation of AcksenButtonStaticMode, so an instance only
+// stores the state its own mode needs, and refreshStatus() contains no mode branches or interval loads.
+// Use AcksenButton where the mode or intervals must be changed at run time, or for edge capture and event queues.
+
+#ifndef AcksenButtonStatic_h
+#define AcksenButtonStatic_h
+
+#include "AcksenButtonHAL.h"
+#include "AcksenButton.h"
+
+/**************************************************************************/
+/*! 
+    @brief  Per-mode state and behaviour of an AcksenButtonStatic - Normal mode, which needs neither
+*/
+/**************************************************************************/
+template <uint8_t MODE, unsigned long LONG_PRESS_MS, unsigned long REPEAT_MS, unsigned long REPEAT_OFFSET_MS, unsigned long ACCEL_OFFSET_MS, unsigned long ACCEL_MS>
+class AcksenButtonStaticMode
+{
+
+protected:
+
+	void modeStateChange(bool bNewButtonState, unsigned long ulNow_MS) { (void)bNewButtonState; (void)ulNow_MS; }				// Debounced state has changed
+	bool modeHeld(unsigned long ulNow_MS, unsigned long ulLastStatusUpdate_MS) { (void)ulNow_MS; (void)ulLastStatusUpdate_MS; return false; }	// Button held - returns true to repeat the press
+	bool modeLongPress() { return false; }
+
+};
+
+/**************************************************************************/
+/*! 
+    @brief  Per-mode state and behaviour of an AcksenButtonStatic - Long Press mode
+*/
+/**************************************************************************/
+template <unsigned long LONG_PRESS_MS, unsigned long REPEAT_MS, unsigned long REPEAT_OFFSET_MS, unsigned long ACCEL_OFFSET_MS, unsigned long ACCEL_MS>
+class AcksenButtonStaticMode<ACKSEN_BUTTON_MODE_LONGPRESS, LONG_PRESS_MS, REPEAT_MS, REPEAT_OFFSET_MS, ACCEL_OFFSET_MS, ACCEL_MS>
+{
+
+protected:
+
+	AcksenButtonStaticMode() : uiLongPressFlags(0) {}
+
+	void modeStateChange(bool bNewButtonState, unsigned long ulNow_MS)
+	{
+		(void)ulNow_MS;
+
+		if (bNewButtonState == false)
+		{
+			uiLongPressFlags = 0;
+		}
+	}
+
+	bool modeHeld(unsigned long ulNow_MS, unsigned long ulLastStatusUpdate_MS)
+	{
+		if (!(uiLongPressFlags & LONG_PRESS_RECORDED) && (ulNow_MS - ulLastStatusUpdate_MS >= LONG_PRESS_MS))
+		{
+			uiLongPressFlags = LONG_PRESS_RECORDED;
+		}
+
+		return false;
+	}
+
+	bool modeLongPress()
+	{
+		if (uiLongPressFlags == LONG_PRESS_RECORDED)
+		{
+			uiLongPressFlags |= LONG_PRESS_PROCESSED;
+			return true;
+		}
+
+		return false;
+	}
+
+private:
+
+	static const uint8_t LONG_PRESS_RECORDED = 0x01;
+	static const uint8_t LONG_PRESS_PROCESSED = 0x02;
+
+	uint8_t uiLongPressFlags;
+
+};
+
+/**************************************************************************/
+/*! 
+    @brief  Per-mode state and behaviour of an AcksenButtonStatic - Repeat mode
+*/
+/**************************************************************************/
+template <unsigned long LONG_PRESS_MS, unsigned long REPEAT_MS, unsigned long REPEAT_OFFSET_MS, unsigned long ACCEL_OFFSET_MS, unsigned long ACCEL_MS>
+class AcksenButtonStaticMode<ACKSEN_BUTTON_MODE_REPEAT, LONG_PRESS_MS, REPEAT_MS, REPEAT_OFFSET_MS, ACCEL_OFFSET_MS, ACCEL_MS>
+{
+
+protected:
+
+	void modeStateChange(bool bNewButtonState, unsigned long ulNow_MS)
+	{
+		(void)bNewButtonState;
+		ulRepeatPressesPeriodEnd = ulNow_MS + REPEAT_OFFSET_MS;
+	}
+
+	bool modeHeld(unsigned long ulNow_MS, unsigned long ulLastStatusUpdate_MS)
+	{
+		(void)ulLastStatusUpdate_MS;
+
+		if (!acksenButtonTimeBefore(ulNow_MS, ulRepeatPressesPeriodEnd))
+		{
+			ulRepeatPressesPeriodEnd = ulNow_MS + REPEAT_MS;
+			return true;
+		}
+
+		return false;
+	}
+
+	bool modeLongPress() { return false; }
+
+private:
+
+	unsigned long ulRepeatPressesPeriodEnd = 0;
+
+};
+
+/**************************************************************************/
+/*! 
+    @brief  Per-mode state and behaviour of an AcksenButtonStatic - Accelerate mode
+*/
+/**************************************************************************/
+template <unsigned long LONG_PRESS_MS, unsigned long REPEAT_MS, unsigned long REPEAT_OFFSET_MS, unsigned long ACCEL_OFFSET_MS, unsigned long ACCEL_MS>
+class AcksenButtonStaticMode<ACKSEN_BUTTON_MODE_ACCELERATE, LONG_PRESS_MS, REPEAT_MS, REPEAT_OFFSET_MS, ACCEL_OFFSET_MS, ACCEL_MS>
+{
+
+protected:
+
+	void modeStateChange(bool bNewButtonState, unsigned long ulNow_MS)
+	{
+		(void)bNewButtonState;
+		ulRepeatPressesPeriodEnd = ulNow_MS + REPEAT_OFFSET_MS;
+	}
+
+	// The acceleration offset is timed from the last state change, so no separate start time is stored
+	bool modeHeld(unsigned long ulNow_MS, unsigned long ulLastStatusUpdate_MS)
+	{
+		if (!acksenButtonTimeBefore(ulNow_MS, ulRepeatPressesPeriodEnd))
+		{
+			ulRepeatPressesPeriodEnd = ulNow_MS + ((ulNow_MS - ulLastStatusUpdate_MS >= ACCEL_OFFSET_MS) ? ACCEL_MS : REPEAT_MS);
+			return true;
+		}
+
+		return false;
+	}
+
+	bool modeLongPress() { return false; }
+
+private:
+
+	unsigned long ulRepeatPressesPeriodEnd = 0;
+
+};
+
+/**************************************************************************/
+/*! 
+    @brief  Class that defines a button whose pin, mode and intervals are fixed at compile time
+    @tparam PIN
+            The Arduino I/O pin assigned to the button.
+    @tparam MODE
+            The operating mode for the button (one of the ACKSEN_BUTTON_MODE_* constants).
+    @tparam DEBOUNCE_MS
+            The debounce interval applied to the button, in milliseconds.
+    @tparam LONG_PRESS_MS
+            The long press interval (Long Press mode), in milliseconds.
+    @tparam REPEAT_MS
+            The repeat presses interval (Repeat and Accelerate modes), in milliseconds.
+    @tparam REPEAT_OFFSET_MS
+            The repeat presses initial offset delay (Repeat and Accelerate modes), in milliseconds.
+    @tparam ACCEL_OFFSET_MS
+            The acceleration initial offset delay (Accelerate mode), in milliseconds.
+    @tparam ACCEL_MS
+            The acceleration presses interval (Accelerate mode), in milliseconds.
+*/
+/**************************************************************************/
+template <uint8_t PIN, uint8_t MODE, unsigned long DEBOUNCE_MS,
+	unsigned long LONG_PRESS_MS = DEFAULT_LONG_PRESS_INTERVAL,
+	unsigned long REPEAT_MS = DEFAULT_REPEAT_PRESS_INTERVAL,
+	unsigned long REPEAT_OFFSET_MS = DEFAULT_REPEAT_INITIAL_OFFSET_INTERVAL,
+	unsigned long ACCEL_OFFSET_MS = DEFAULT_ACCELERATION_INITIAL_OFFSET_INTERVAL,
+	unsigned long ACCEL_MS = DEFAULT_ACCELERATION_PRESSES_INTERVAL>
+class AcksenButtonStatic : public AcksenButtonStaticMode<MODE, LONG_PRESS_MS, REPEAT_MS, REPEAT_OFFSET_MS, ACCEL_OFFSET_MS, ACCEL_MS>
+{
+
+	static_assert(MODE <= ACKSEN_BUTTON_MODE_ACCELERATE, "AcksenButtonStatic MODE must be one of the ACKSEN_BUTTON_MODE_* constants");
+
+public:
+
+/**************************************************************************/
+/*!
+    @brief  Class initialisation.
+    @param  uiButtonInputMode
+            Used to specify the input type on the button pin (INPUT or INPUT_PULLUP)
+    @return No return value.
+*/
+/**************************************************************************/
+	AcksenButtonStatic(uint8_t uiButtonInputMode)
+	{
+		AcksenButtonHAL::setPinMode(PIN, uiButtonInputMode);
+
+		ulLastStatusUpdate_MS = AcksenButtonHAL::getMillis();
+		uiFlags = AcksenButtonHAL::readPin(PIN) ? DEBOUNCED_STATE : 0;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Updates the Button states, using the state of the assigned Arduino I/O Pin.
+    @return Returns true if the state changed, or a repeat press fired.
+			Returns false if the state did not change.
+*/
+/**************************************************************************/
+	bool refreshStatus()
+	{
+		return refreshStatus(AcksenButtonHAL::getMillis());
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Updates the Button states, using a time supplied by the caller.
+    @param  ulNow_MS
+            The present time, in milliseconds (i.e. the value of millis() at the start of the scan).
+    @return Returns true if the state changed, or a repeat press fired.
+			Returns false if the state did not change.
+*/
+/**************************************************************************/
+	bool refreshStatus(unsigned long ulNow_MS)
+	{
+		bool bState = uiFlags & DEBOUNCED_STATE;
+
+		if ((AcksenButtonHAL::readPin(PIN) != bState) && (ulNow_MS - ulLastStatusUpdate_MS >= DEBOUNCE_MS))
+		{
+			bState = !bState;
+			ulLastStatusUpdate_MS = ulNow_MS;
+			uiFlags = bState ? (DEBOUNCED_STATE | STATE_CHANGE_RECORDED) : STATE_CHANGE_RECORDED;
+
+			this->modeStateChange(bState, ulNow_MS);
+
+			return true;
+		}
+
+		if (bState && this->modeHeld(ulNow_MS, ulLastStatusUpdate_MS))
+		{
+			uiFlags = DEBOUNCED_STATE | STATE_CHANGE_RECORDED;
+			return true;
+		}
+
+		uiFlags &= (uint8_t)~STATE_CHANGE_RECORDED;
+
+		return false;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Returns the debounced state of the button.
+*/
+/**************************************************************************/
+	bool getButtonState() { return uiFlags & DEBOUNCED_STATE; }
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of milliseconds the button has been in the current state.
+*/
+/**************************************************************************/
+	unsigned long getTimeFromLastStateChange() { return AcksenButtonHAL::getMillis() - ulLastStatusUpdate_MS; }
+
+/**************************************************************************/
+/*!
+    @brief  Returns true once after the button transitioned from LOW to HIGH (or repeated) in the last refresh.
+*/
+/**************************************************************************/
+	bool onPressed() { return consume(DEBOUNCED_STATE | STATE_CHANGE_RECORDED); }
+
+/**************************************************************************/
+/*!
+    @brief  Returns true once after the button transitioned from HIGH to LOW in the last refresh.
+*/
+/**************************************************************************/
+	bool onReleased() { return consume(STATE_CHANGE_RECORDED); }
+
+/**************************************************************************/
+/*!
+    @brief  Returns true once after the button has been held for the Long Press interval (Long Press mode only).
+*/
+/**************************************************************************/
+	bool onLongPress() { return this->modeLongPress(); }
+
+private:
+
+	static const uint8_t DEBOUNCED_STATE = 0x01;
+	static const uint8_t STATE_CHANGE_RECORDED = 0x02;
+
+	// Returns true, and clears the recorded change, if the flags exactly match the event requested
+	bool consume(uint8_t uiEventFlags)
+	{
+		if (uiFlags == uiEventFlags)
+		{
+			uiFlags &= (uint8_t)~STATE_CHANGE_RECORDED;
+			return true;
+		}
+
+		return false;
+	}
+
+	unsigned long ulLastStatusUpdate_MS;
+	uint8_t uiFlags;
+
+};
+
+#endif
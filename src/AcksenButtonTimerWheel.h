@@ -0,0 +1,465 @@
+/*!
+@file AcksenButtonTimerWheel.h
+
+*/
+
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+// Shared hierarchical timer wheel for the Acksen Button Library.
+//
+// With many buttons, most of them idle, refreshing every button every scan is mostly wasted work: only a button
+// whose input has changed, or whose debounce, Long Press or Repeat/Accelerate deadline has arrived, can do
+// anything. AcksenButtonTimerWheel files each registered button under its next AcksenButton::getNextDeadline(),
+// and advance() refreshes only those buttons whose deadline has expired, at the tick it expires.
+//
+// The wheel has two levels of ACKSEN_TIMER_WHEEL_SLOTS slots - one per millisecond, then one per
+// ACKSEN_TIMER_WHEEL_SLOTS milliseconds - plus an overflow list for deadlines further out, which is re-examined
+// each time the second level wraps. Scheduling, cancelling and expiring a button are all constant time.
+//
+// The wheel cannot see input changes by itself. When a button's input changes (from a pin change interrupt,
+// AcksenButtonBank mask, or a multiplexed panel scan), call refreshButton() for it so its deadline is rescheduled.
+//
+// All time comparisons are made on differences, so the wheel is unaffected by millis() rollover.
+//
+// The wheel ticks in milliseconds, so every button in it must use the millisecond time base. add() refuses buttons
+// in the microsecond time base, and a button must not be switched to it while in the wheel.
+
+#ifndef AcksenButtonTimerWheel_h
+#define AcksenButtonTimerWheel_h
+
+#include "AcksenButtonHAL.h"
+#include "AcksenButton.h"
+
+#ifndef ACKSEN_TIMER_WHEEL_SLOT_BITS
+#if defined(__AVR__)
+#define ACKSEN_TIMER_WHEEL_SLOT_BITS		4		///< log2 of the slots per level - 16 slots keeps the wheel small on AVR
+#else
+#define ACKSEN_TIMER_WHEEL_SLOT_BITS		6		///< log2 of the slots per level
+#endif
+#endif
+
+#if (ACKSEN_TIMER_WHEEL_SLOT_BITS < 1) || (ACKSEN_TIMER_WHEEL_SLOT_BITS > 6)
+#error "ACKSEN_TIMER_WHEEL_SLOT_BITS must be between 1 and 6"
+#endif
+
+#define ACKSEN_TIMER_WHEEL_SLOTS			(1 << ACKSEN_TIMER_WHEEL_SLOT_BITS)		///< Slots per level
+#define ACKSEN_TIMER_WHEEL_SLOT_MASK		(ACKSEN_TIMER_WHEEL_SLOTS - 1)
+#define ACKSEN_TIMER_WHEEL_SPAN_MS			((unsigned long)ACKSEN_TIMER_WHEEL_SLOTS * ACKSEN_TIMER_WHEEL_SLOTS)	///< Range of the two levels, in milliseconds
+
+#define ACKSEN_TIMER_WHEEL_NONE				0xFFFF		///< Invalid handle, or end of a slot list
+
+/**************************************************************************/
+/*! 
+    @brief  Class that defines a timer wheel scheduling refreshes for a set of buttons
+    @tparam CAPACITY
+            The maximum number of buttons that can be added to the wheel.
+*/
+/**************************************************************************/
+template <uint16_t CAPACITY>
+class AcksenButtonTimerWheel
+{
+
+public:
+
+	AcksenButtonTimerWheel() : uiCount(0), ulNextTick_MS(0)
+	{
+		for (uint8_t uiList = 0; uiList <= LIST_OVERFLOW; uiList++)
+		{
+			auiListHead[uiList] = ACKSEN_TIMER_WHEEL_NONE;
+		}
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Adds a button to the wheel, and schedules its first deadline.
+    @param  pButton
+            The button to add. It is not copied, so must outlive the wheel.
+    @return Returns the handle of the button, for refreshButton() and reschedule().
+			Returns ACKSEN_TIMER_WHEEL_NONE if the wheel is full, or the button uses the microsecond time base.
+*/
+/**************************************************************************/
+	uint16_t add(AcksenButton* pButton)
+	{
+		return add(pButton, AcksenButtonHAL::getMillis());
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Adds a button to the wheel, using a time supplied by the caller.
+    @param  pButton
+            The button to add. It is not copied, so must outlive the wheel.
+    @param  ulNow_MS
+            The present time, in milliseconds. The first button added sets the wheel's starting time.
+    @return Returns the handle of the button, for refreshButton() and reschedule().
+			Returns ACKSEN_TIMER_WHEEL_NONE if the wheel is full, or the button uses the microsecond time base.
+*/
+/**************************************************************************/
+	uint16_t add(AcksenButton* pButton, unsigned long ulNow_MS)
+	{
+		// Deadlines in microseconds would be filed as milliseconds
+		if ((uiCount >= CAPACITY) || (pButton->getTimeBase() != ACKSEN_BUTTON_TIME_MILLIS))
+		{
+			return ACKSEN_TIMER_WHEEL_NONE;
+		}
+
+		if (uiCount == 0)
+		{
+			ulNextTick_MS = ulNow_MS;
+		}
+
+		uint16_t uiHandle = uiCount++;
+
+		asNodes[uiHandle].pButton = pButton;
+		asNodes[uiHandle].uiList = LIST_IDLE;
+
+		reschedule(uiHandle);
+
+		return uiHandle;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of buttons in the wheel.
+*/
+/**************************************************************************/
+	uint16_t getCount() { return uiCount; }
+
+/**************************************************************************/
+/*!
+    @brief  Returns a button in the wheel.
+    @param  uiHandle
+            The handle returned by add().
+*/
+/**************************************************************************/
+	AcksenButton* getButton(uint16_t uiHandle) { return asNodes[uiHandle].pButton; }
+
+/**************************************************************************/
+/*!
+    @brief  Refreshes a button whose input has changed, and reschedules its deadline.
+    @param  uiHandle
+            The handle returned by add().
+    @param  ulNow_MS
+            The present time, in milliseconds.
+    @return Returns the result of the button's refreshStatus().
+*/
+/**************************************************************************/
+	bool refreshButton(uint16_t uiHandle, unsigned long ulNow_MS)
+	{
+		bool bResult = asNodes[uiHandle].pButton->refreshStatus(ulNow_MS);
+
+		reschedule(uiHandle);
+
+		return bResult;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Refreshes a button whose input has changed, and reschedules its deadline.
+    @param  uiHandle
+            The handle returned by add().
+    @return Returns the result of the button's refreshStatus().
+*/
+/**************************************************************************/
+	bool refreshButton(uint16_t uiHandle)
+	{
+		return refreshButton(uiHandle, AcksenButtonHAL::getMillis());
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Files a button under its present getNextDeadline(), replacing any earlier deadline.
+			Use this after refreshing the button directly, or changing its mode or intervals.
+    @param  uiHandle
+            The handle returned by add().
+*/
+/**************************************************************************/
+	void reschedule(uint16_t uiHandle)
+	{
+		unsigned long ulDeadline_MS = 0;
+
+		unlink(uiHandle);
+
+		if (asNodes[uiHandle].pButton->getNextDeadline(ulDeadline_MS))
+		{
+			asNodes[uiHandle].ulDeadline_MS = ulDeadline_MS;
+			place(uiHandle);
+		}
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Refreshes every button whose deadline has expired, up to the present time.
+    @return Returns the number of refreshStatus() calls that returned true.
+*/
+/**************************************************************************/
+	uint16_t advance()
+	{
+		return advance(AcksenButtonHAL::getMillis());
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Refreshes every button whose deadline has expired, using a time supplied by the caller.
+			Each button is refreshed with the tick its deadline fell on, so the results are the same as
+			refreshing it every millisecond. If the wheel has not been advanced for longer than
+			ACKSEN_TIMER_WHEEL_SPAN_MS, expired buttons are instead refreshed at ulNow_MS.
+    @param  ulNow_MS
+            The present time, in milliseconds.
+    @return Returns the number of refreshStatus() calls that returned true.
+*/
+/**************************************************************************/
+	uint16_t advance(unsigned long ulNow_MS)
+	{
+		uint16_t uiChanged = 0;
+
+		if (acksenButtonTimeBefore(ulNow_MS, ulNextTick_MS))
+		{
+			return 0;
+		}
+
+		if ((ulNow_MS - ulNextTick_MS) >= ACKSEN_TIMER_WHEEL_SPAN_MS)
+		{
+			rebase(ulNow_MS);
+		}
+
+		while (!acksenButtonTimeBefore(ulNow_MS, ulNextTick_MS))
+		{
+			uiChanged += processTick();
+		}
+
+		return uiChanged;
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Returns the earliest deadline scheduled in the wheel.
+    @param  ulDeadline_MS
+            Receives the deadline, in milliseconds.
+    @return Returns true if a deadline was set.
+			Returns false if no button has a deadline, so nothing will happen until an input changes.
+*/
+/**************************************************************************/
+	bool getNextDeadline(unsigned long& ulDeadline_MS)
+	{
+		bool bDeadlineSet = false;
+
+		// The first occupied millisecond slot holds only one deadline
+		for (uint8_t uiOffset = 0; uiOffset < ACKSEN_TIMER_WHEEL_SLOTS; uiOffset++)
+		{
+			if (auiListHead[(ulNextTick_MS + uiOffset) & ACKSEN_TIMER_WHEEL_SLOT_MASK] != ACKSEN_TIMER_WHEEL_NONE)
+			{
+				ulDeadline_MS = ulNextTick_MS + uiOffset;
+				bDeadlineSet = true;
+				break;
+			}
+		}
+
+		// The first occupied coarse slot, and the overflow list, may hold earlier deadlines
+		for (uint8_t uiOffset = 0; uiOffset < ACKSEN_TIMER_WHEEL_SLOTS; uiOffset++)
+		{
+			uint8_t uiList = ACKSEN_TIMER_WHEEL_SLOTS + (((ulNextTick_MS >> ACKSEN_TIMER_WHEEL_SLOT_BITS) + uiOffset) & ACKSEN_TIMER_WHEEL_SLOT_MASK);
+
+			if (auiListHead[uiList] != ACKSEN_TIMER_WHEEL_NONE)
+			{
+				bDeadlineSet |= getListDeadline(uiList, ulDeadline_MS, bDeadlineSet);
+				break;
+			}
+		}
+
+		bDeadlineSet |= getListDeadline(LIST_OVERFLOW, ulDeadline_MS, bDeadlineSet);
+
+		return bDeadlineSet;
+	}
+
+protected:
+
+	static const uint8_t LIST_OVERFLOW = 2 * ACKSEN_TIMER_WHEEL_SLOTS;		///< Deadlines beyond the second level
+	static const uint8_t LIST_IDLE = 0xFF;									///< Not scheduled
+
+	struct Node
+	{
+		AcksenButton* pButton;
+		unsigned long ulDeadline_MS;
+		uint16_t uiNext;
+		uint16_t uiPrev;
+		uint8_t uiList;
+	};
+
+	// Files a node in the list for its deadline, relative to the next tick to be processed
+	void place(uint16_t uiHandle)
+	{
+		Node& sNode = asNodes[uiHandle];
+		uint8_t uiList;
+
+		// Deadlines already passed are handled on the next tick
+		if (acksenButtonTimeBefore(sNode.ulDeadline_MS, ulNextTick_MS))
+		{
+			sNode.ulDeadline_MS = ulNextTick_MS;
+		}
+
+		unsigned long ulDelta_MS = sNode.ulDeadline_MS - ulNextTick_MS;
+
+		// Whole coarse slots from the one holding the next tick - taken from the difference, so rollover is harmless
+		unsigned long ulCoarseDelta = (sNode.ulDeadline_MS - (ulNextTick_MS & ~(unsigned long)ACKSEN_TIMER_WHEEL_SLOT_MASK)) >> ACKSEN_TIMER_WHEEL_SLOT_BITS;
+
+		if (ulDelta_MS < ACKSEN_TIMER_WHEEL_SLOTS)
+		{
+			uiList = sNode.ulDeadline_MS & ACKSEN_TIMER_WHEEL_SLOT_MASK;
+		}
+		else if (ulCoarseDelta < ACKSEN_TIMER_WHEEL_SLOTS)
+		{
+			uiList = ACKSEN_TIMER_WHEEL_SLOTS + ((sNode.ulDeadline_MS >> ACKSEN_TIMER_WHEEL_SLOT_BITS) & ACKSEN_TIMER_WHEEL_SLOT_MASK);
+		}
+		else
+		{
+			uiList = LIST_OVERFLOW;
+		}
+
+		sNode.uiList = uiList;
+		sNode.uiPrev = ACKSEN_TIMER_WHEEL_NONE;
+		sNode.uiNext = auiListHead[uiList];
+
+		if (sNode.uiNext != ACKSEN_TIMER_WHEEL_NONE)
+		{
+			asNodes[sNode.uiNext].uiPrev = uiHandle;
+		}
+
+		auiListHead[uiList] = uiHandle;
+	}
+
+	// Removes a node from whichever list it is filed in
+	void unlink(uint16_t uiHandle)
+	{
+		Node& sNode = asNodes[uiHandle];
+
+		if (sNode.uiList == LIST_IDLE)
+		{
+			return;
+		}
+
+		if (sNode.uiPrev != ACKSEN_TIMER_WHEEL_NONE)
+		{
+			asNodes[sNode.uiPrev].uiNext = sNode.uiNext;
+		}
+		else
+		{
+			auiListHead[sNode.uiList] = sNode.uiNext;
+		}
+
+		if (sNode.uiNext != ACKSEN_TIMER_WHEEL_NONE)
+		{
+			asNodes[sNode.uiNext].uiPrev = sNode.uiPrev;
+		}
+
+		sNode.uiList = LIST_IDLE;
+	}
+
+	// Detaches a whole list and files each of its nodes again, relative to the next tick
+	void refile(uint8_t uiList)
+	{
+		uint16_t uiHandle = auiListHead[uiList];
+
+		auiListHead[uiList] = ACKSEN_TIMER_WHEEL_NONE;
+
+		while (uiHandle != ACKSEN_TIMER_WHEEL_NONE)
+		{
+			uint16_t uiNext = asNodes[uiHandle].uiNext;
+
+			place(uiHandle);
+			uiHandle = uiNext;
+		}
+	}
+
+	// Refiles every scheduled node relative to a new next tick, after a gap longer than the wheel covers
+	void rebase(unsigned long ulNow_MS)
+	{
+		ulNextTick_MS = ulNow_MS;
+
+		for (uint8_t uiList = 0; uiList <= LIST_OVERFLOW; uiList++)
+		{
+			auiListHead[uiList] = ACKSEN_TIMER_WHEEL_NONE;
+		}
+
+		for (uint16_t uiHandle = 0; uiHandle < uiCount; uiHandle++)
+		{
+			if (asNodes[uiHandle].uiList != LIST_IDLE)
+			{
+				place(uiHandle);
+			}
+		}
+	}
+
+	// Cascades the coarser lists into the millisecond slots when due, then refreshes the buttons expiring at the next tick
+	uint16_t processTick()
+	{
+		unsigned long ulTick_MS = ulNextTick_MS;
+		uint16_t uiChanged = 0;
+
+		if ((ulTick_MS & ACKSEN_TIMER_WHEEL_SLOT_MASK) == 0)
+		{
+			if (((ulTick_MS >> ACKSEN_TIMER_WHEEL_SLOT_BITS) & ACKSEN_TIMER_WHEEL_SLOT_MASK) == 0)
+			{
+				refile(LIST_OVERFLOW);
+			}
+
+			refile(ACKSEN_TIMER_WHEEL_SLOTS + ((ulTick_MS >> ACKSEN_TIMER_WHEEL_SLOT_BITS) & ACKSEN_TIMER_WHEEL_SLOT_MASK));
+		}
+
+		uint8_t uiList = ulTick_MS & ACKSEN_TIMER_WHEEL_SLOT_MASK;
+		uint16_t uiHandle = auiListHead[uiList];
+
+		// Detach the slot first - a button rescheduled a full turn ahead lands back in the same slot
+		auiListHead[uiList] = ACKSEN_TIMER_WHEEL_NONE;
+		ulNextTick_MS = ulTick_MS + 1;
+
+		while (uiHandle != ACKSEN_TIMER_WHEEL_NONE)
+		{
+			uint16_t uiNext = asNodes[uiHandle].uiNext;
+
+			asNodes[uiHandle].uiList = LIST_IDLE;
+			uiChanged += asNodes[uiHandle].pButton->refreshStatus(ulTick_MS);
+			reschedule(uiHandle);
+
+			uiHandle = uiNext;
+		}
+
+		return uiChanged;
+	}
+
+	// Updates ulDeadline_MS with the earliest deadline in a list
+	bool getListDeadline(uint8_t uiList, unsigned long& ulDeadline_MS, bool bDeadlineSet)
+	{
+		for (uint16_t uiHandle = auiListHead[uiList]; uiHandle != ACKSEN_TIMER_WHEEL_NONE; uiHandle = asNodes[uiHandle].uiNext)
+		{
+			if (!bDeadlineSet || acksenButtonTimeBefore(asNodes[uiHandle].ulDeadline_MS, ulDeadline_MS))
+			{
+				ulDeadline_MS = asNodes[uiHandle].ulDeadline_MS;
+				bDeadlineSet = true;
+			}
+		}
+
+		return bDeadlineSet;
+	}
+
+	Node asNodes[CAPACITY];
+	uint16_t auiListHead[LIST_OVERFLOW + 1];
+	uint16_t uiCount;
+	unsigned long ulNextTick_MS;		///< The first tick not yet processed
+
+};
+
+#endif
@@ -0,0 +1,508 @@
+/*!
+@file AcksenButtonTrace.h
+
+*/
+
+/***********************************************************
+This source file is licenced using the 3-Clause BSD License.
+
+Copyright (c) 2022 Acksen Ltd, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************/
+
+
+// Binary trace recording for the Acksen Button Library.
+//
+// To reproduce a problem seen in the field, build with ACKSEN_BUTTON_TRACE defined as 1 (see AcksenButton.h) and
+// attach an AcksenButtonTraceRecorder to each button with AcksenButton::setTraceRecorder(). Every change in the level a
+// button reads from its pin, and every event it reports, is then written as a compact binary record through a
+// function supplied by the sketch - typically Serial.write(), or a write to the next EEPROM address. The trace can be
+// replayed through AcksenButton on a host PC, on the simulated clock, with extras/host/replay.
+//
+// Traces are written one byte at a time, and most records take two bytes:
+//
+//   Header   'A' 'B' 'T', ACKSEN_BUTTON_TRACE_VERSION, flags (ACKSEN_BUTTON_TRACE_FLAG_*), start time in
+//            milliseconds and in microseconds (LEB128)
+//   Record   tag, time since the previous record on the same clock (signed, zigzag LEB128), payload
+//
+// The tag holds the record type in bits 7-6, two bits of data in bits 5-4 and the button's channel (0 to 15) in
+// bits 3-0. For an edge, bit 4 is the new level and there is no payload. For an event, bits 5-4 are the
+// ACKSEN_BUTTON_EVENT_* type and there is no payload. A config record (bit 4 is the debounced state, bit 5 is set for
+// the microsecond time base) is written by setTraceRecorder(), and carries the button's mode, debounce strategy and
+// samples as bytes, then as LEB128 the time since its last state change and since its debounce timer was set, its
+// debounce, long press, repeat, repeat offset, acceleration and acceleration offset intervals, and its adaptive
+// debounce bounds. A refresh record (channel 0, bit 4 set for the microsecond time base) is written by
+// recordRefresh() when the trace was begun with ACKSEN_BUTTON_TRACE_FLAG_REFRESHES. Otherwise the replay assumes
+// every button was refreshed every millisecond, or every microsecond in the microsecond time base.
+//
+// Each record is timed in its button's time base (see AcksenButton::setTimeBase()), so the recorder keeps the time of
+// the last record on each clock, and the config record tells the reader which clock a channel's records are on.
+//
+// Only polled buttons record their edges - edges captured by interrupt are not traced, though their events are.
+// Acceleration curves are not recorded.
+
+#ifndef AcksenButtonTrace_h
+#define AcksenButtonTrace_h
+
+#include "AcksenButtonHAL.h"
+#include "AcksenButton.h"
+
+#define ACKSEN_BUTTON_TRACE_VERSION						2		///< Format version written in the trace header
+
+#define ACKSEN_BUTTON_TRACE_FLAG_REFRESHES				0x01	///< Header flag: the trace holds a refresh record for every main loop
+
+#define ACKSEN_BUTTON_TRACE_CHANNELS					16		///< Number of buttons a trace can hold
+
+#define ACKSEN_BUTTON_TRACE_EDGE						0		///< Record: raw input level changed
+#define ACKSEN_BUTTON_TRACE_EVENT						1		///< Record: button reported an event
+#define ACKSEN_BUTTON_TRACE_CONFIG						2		///< Record: button attached to the trace, with its settings
+#define ACKSEN_BUTTON_TRACE_REFRESH						3		///< Record: every button was refreshed
+#define ACKSEN_BUTTON_TRACE_HEADER						4		///< Returned by AcksenButtonTraceReader for the trace header (never written as a tag)
+
+#define ACKSEN_BUTTON_TRACE_OK							0		///< Reader status: a record was decoded
+#define ACKSEN_BUTTON_TRACE_MORE						1		///< Reader status: the buffer ends part way through a record
+#define ACKSEN_BUTTON_TRACE_ERROR						2		///< Reader status: the data is not a valid trace
+
+typedef void (*AcksenButtonTraceWriteFunction)(uint8_t uiByte);	///< Writes one byte of the trace, e.g. to Serial or EEPROM
+
+/**************************************************************************/
+/*! 
+    @brief  Button settings carried by a config record
+*/
+/**************************************************************************/
+struct AcksenButtonTraceConfig
+{
+	uint8_t uiMode;										///< ACKSEN_BUTTON_MODE_*
+	uint8_t uiDebounceStrategy;							///< ACKSEN_BUTTON_DEBOUNCE_*
+	uint8_t uiDebounceSamples;							///< Samples per debounce interval
+	uint8_t uiTimeBase;									///< ACKSEN_BUTTON_TIME_*, the unit of every time and interval below
+	unsigned long ulAge_MS;								///< Time since the button's last state change
+	unsigned long ulDebounceTimerAge_MS;				///< Time since the debounce strategy's timer was set (last sample, lockout or edge)
+	unsigned long ulDebounceInterval_MS;				///< Debounce interval
+	unsigned long ulLongPressInterval_MS;				///< Long press interval
+	unsigned long ulRepeatPressesInterval_MS;			///< Repeat interval
+	unsigned long ulRepeatInitialOffsetDelay_MS;		///< Delay before repeats start
+	unsigned long ulAccelerationPressesInterval_MS;		///< Accelerated repeat interval
+	unsigned long ulAccelerationInitialOffsetDelay_MS;	///< Delay before acceleration starts
+	unsigned long ulAdaptiveMinimum_MS;					///< Shortest adaptive debounce window
+	unsigned long ulAdaptiveMaximum_MS;					///< Longest adaptive debounce window
+};
+
+/**************************************************************************/
+/*! 
+    @brief  One decoded trace record
+*/
+/**************************************************************************/
+struct AcksenButtonTraceRecord
+{
+	uint8_t uiType;						///< ACKSEN_BUTTON_TRACE_EDGE, _EVENT, _CONFIG, _REFRESH or _HEADER
+	uint8_t uiChannel;					///< Button the record belongs to
+	uint8_t uiData;						///< Level (edge, config), ACKSEN_BUTTON_EVENT_* (event) or flags (header)
+	uint8_t uiTimeBase;					///< ACKSEN_BUTTON_TIME_*, the clock the record is timed on (always milliseconds for the header)
+	unsigned long ulTimestamp_MS;		///< Time of the record, in the unit of uiTimeBase
+	AcksenButtonTraceConfig sConfig;	///< Settings (config records only)
+};
+
+/**************************************************************************/
+/*! 
+    @brief  Class that writes a binary trace of button inputs and events
+*/
+/**************************************************************************/
+class AcksenButtonTraceRecorder
+{
+
+public:
+
+/**************************************************************************/
+/*!
+    @brief  Class initialisation.
+    @param  pWrite
+            The function that writes each byte of the trace.
+    @return No return value.
+*/
+/**************************************************************************/
+	AcksenButtonTraceRecorder(AcksenButtonTraceWriteFunction pWrite) : pWrite(pWrite), uiFlags(0), uiMicrosChannels(0), ulLastRecord_MS(0), ulLastRecord_US(0), ulBytesWritten(0)
+	{
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Writes the trace header. Call before attaching any buttons.
+    @param  uiFlags
+            ACKSEN_BUTTON_TRACE_FLAG_REFRESHES if recordRefresh() will be called after refreshing the buttons in every
+			main loop, so the replay refreshes them at the same times. Otherwise 0, and the replay refreshes them
+			every millisecond.
+    @return No return value.
+*/
+/**************************************************************************/
+	void begin(uint8_t uiFlags = 0)
+	{
+		this->uiFlags = uiFlags;
+		uiMicrosChannels = 0;
+		ulLastRecord_MS = AcksenButtonHAL::getMillis();
+		ulLastRecord_US = AcksenButtonHAL::getMicros();
+		
+		writeByte('A');
+		writeByte('B');
+		writeByte('T');
+		writeByte(ACKSEN_BUTTON_TRACE_VERSION);
+		writeByte(uiFlags);
+		writeNumber(ulLastRecord_MS);
+		writeNumber(ulLastRecord_US);
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Records that every button in a time base has just been refreshed. Only written if the trace was begun
+			with ACKSEN_BUTTON_TRACE_FLAG_REFRESHES. If buttons in both time bases are traced, call once for each.
+    @param  ulNow_MS
+            The time passed to refreshStatus().
+    @param  uiTimeBase
+            The time base of ulNow_MS and of the buttons refreshed, ACKSEN_BUTTON_TIME_MILLIS (default) or ACKSEN_BUTTON_TIME_MICROS.
+    @return No return value.
+*/
+/**************************************************************************/
+	void recordRefresh(unsigned long ulNow_MS, uint8_t uiTimeBase = ACKSEN_BUTTON_TIME_MILLIS)
+	{
+		if (uiFlags & ACKSEN_BUTTON_TRACE_FLAG_REFRESHES)
+		{
+			bool bMicros = (uiTimeBase == ACKSEN_BUTTON_TIME_MICROS);
+			
+			writeTag(ACKSEN_BUTTON_TRACE_REFRESH, bMicros ? 1 : 0, 0, ulNow_MS, bMicros);
+		}
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Records a change in the raw input level of a button (called by AcksenButton).
+    @param  uiChannel
+            The button's channel.
+    @param  bLevel
+            The new level.
+    @param  ulNow_MS
+            The time the level was read.
+    @return No return value.
+*/
+/**************************************************************************/
+	void recordEdge(uint8_t uiChannel, bool bLevel, unsigned long ulNow_MS)
+	{
+		writeTag(ACKSEN_BUTTON_TRACE_EDGE, bLevel ? 1 : 0, uiChannel, ulNow_MS, isMicros(uiChannel));
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Records an event reported by a button (called by AcksenButton).
+    @param  uiChannel
+            The button's channel.
+    @param  uiEvent
+            One of the ACKSEN_BUTTON_EVENT_* constants.
+    @param  ulTimestamp_MS
+            The time of the event.
+    @return No return value.
+*/
+/**************************************************************************/
+	void recordEvent(uint8_t uiChannel, uint8_t uiEvent, unsigned long ulTimestamp_MS)
+	{
+		writeTag(ACKSEN_BUTTON_TRACE_EVENT, uiEvent, uiChannel, ulTimestamp_MS, isMicros(uiChannel));
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Records a button's settings (called by AcksenButton::setTraceRecorder()).
+    @param  uiChannel
+            The button's channel.
+    @param  bLevel
+            The button's debounced state.
+    @param  sConfig
+            The button's settings.
+    @param  ulNow_MS
+            The present time, in the button's time base.
+    @return No return value.
+*/
+/**************************************************************************/
+	void recordConfig(uint8_t uiChannel, bool bLevel, const AcksenButtonTraceConfig& sConfig, unsigned long ulNow_MS)
+	{
+		bool bMicros = (sConfig.uiTimeBase == ACKSEN_BUTTON_TIME_MICROS);
+		uint16_t uiChannelMask = (uint16_t)1 << (uiChannel & 0x0F);
+		
+		// Every later record of the channel is timed on the same clock
+		uiMicrosChannels = bMicros ? (uiMicrosChannels | uiChannelMask) : (uiMicrosChannels & ~uiChannelMask);
+		
+		writeTag(ACKSEN_BUTTON_TRACE_CONFIG, (bMicros ? 2 : 0) | (bLevel ? 1 : 0), uiChannel, ulNow_MS, bMicros);
+		
+		writeByte(sConfig.uiMode);
+		writeByte(sConfig.uiDebounceStrategy);
+		writeByte(sConfig.uiDebounceSamples);
+		writeNumber(sConfig.ulAge_MS);
+		writeNumber(sConfig.ulDebounceTimerAge_MS);
+		writeNumber(sConfig.ulDebounceInterval_MS);
+		writeNumber(sConfig.ulLongPressInterval_MS);
+		writeNumber(sConfig.ulRepeatPressesInterval_MS);
+		writeNumber(sConfig.ulRepeatInitialOffsetDelay_MS);
+		writeNumber(sConfig.ulAccelerationPressesInterval_MS);
+		writeNumber(sConfig.ulAccelerationInitialOffsetDelay_MS);
+		writeNumber(sConfig.ulAdaptiveMinimum_MS);
+		writeNumber(sConfig.ulAdaptiveMaximum_MS);
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of bytes written since the recorder was created.
+*/
+/**************************************************************************/
+	unsigned long getBytesWritten()
+	{
+		return ulBytesWritten;
+	}
+
+protected:
+
+	void writeByte(uint8_t uiByte)
+	{
+		pWrite(uiByte);
+		ulBytesWritten++;
+	}
+
+	// Unsigned LEB128 - 7 bits per byte, low bits first, top bit set on all but the last byte
+	void writeNumber(unsigned long ulValue)
+	{
+		while (ulValue >= 0x80)
+		{
+			writeByte((uint8_t)(ulValue | 0x80));
+			ulValue >>= 7;
+		}
+		
+		writeByte((uint8_t)ulValue);
+	}
+
+	bool isMicros(uint8_t uiChannel)
+	{
+		return (uiMicrosChannels & ((uint16_t)1 << (uiChannel & 0x0F))) != 0;
+	}
+
+	// Tag, then the time since the last record on the same clock - zigzag encoded, as an event may be timestamped
+	// before the last edge
+	void writeTag(uint8_t uiType, uint8_t uiData, uint8_t uiChannel, unsigned long ulTime_MS, bool bMicros)
+	{
+		unsigned long& ulLastRecord = bMicros ? ulLastRecord_US : ulLastRecord_MS;
+		long lDelta_MS = (long)(ulTime_MS - ulLastRecord);
+		
+		ulLastRecord = ulTime_MS;
+		
+		writeByte((uint8_t)((uiType << 6) | ((uiData & 0x03) << 4) | (uiChannel & 0x0F)));
+		writeNumber(((unsigned long)lDelta_MS << 1) ^ (unsigned long)(lDelta_MS >> (sizeof(long) * 8 - 1)));
+	}
+
+	AcksenButtonTraceWriteFunction pWrite;
+	uint8_t uiFlags;
+	uint16_t uiMicrosChannels;			// Bit set for each channel timed in microseconds
+	unsigned long ulLastRecord_MS;		// Time of the last record on each clock
+	unsigned long ulLastRecord_US;
+	unsigned long ulBytesWritten;
+
+};
+
+/**************************************************************************/
+/*! 
+    @brief  Class that decodes a binary trace, from a buffer holding any part of it
+*/
+/**************************************************************************/
+class AcksenButtonTraceReader
+{
+
+public:
+
+	AcksenButtonTraceReader() : bHeaderRead(false), uiMicrosChannels(0), ulLastRecord_MS(0), ulLastRecord_US(0)
+	{
+	}
+
+/**************************************************************************/
+/*!
+    @brief  Decodes the next record. The first record of a trace is its header (ACKSEN_BUTTON_TRACE_HEADER).
+    @param  pauiBuffer
+            The next unread bytes of the trace.
+    @param  uiLength
+            The number of bytes in the buffer.
+    @param  uiUsed
+            Receives the number of bytes decoded, when a record is returned.
+    @param  sRecord
+            Receives the record.
+    @return Returns ACKSEN_BUTTON_TRACE_OK if a record was decoded.
+			Returns ACKSEN_BUTTON_TRACE_MORE if the buffer ends part way through a record - call again with more data,
+			starting from the same byte.
+			Returns ACKSEN_BUTTON_TRACE_ERROR if the data is not a valid trace.
+*/
+/**************************************************************************/
+	uint8_t read(const uint8_t* pauiBuffer, size_t uiLength, size_t& uiUsed, AcksenButtonTraceRecord& sRecord)
+	{
+		
+		size_t uiPosition = 0;
+		unsigned long ulValue;
+		
+		if (!bHeaderRead)
+		{
+			static const uint8_t auiMagic[4] = { 'A', 'B', 'T', ACKSEN_BUTTON_TRACE_VERSION };
+			
+			for (; uiPosition < 4; uiPosition++)
+			{
+				if (uiPosition >= uiLength)
+				{
+					return ACKSEN_BUTTON_TRACE_MORE;
+				}
+				
+				if (pauiBuffer[uiPosition] != auiMagic[uiPosition])
+				{
+					return ACKSEN_BUTTON_TRACE_ERROR;
+				}
+			}
+			
+			if (uiPosition >= uiLength)
+			{
+				return ACKSEN_BUTTON_TRACE_MORE;
+			}
+			
+			sRecord.uiType = ACKSEN_BUTTON_TRACE_HEADER;
+			sRecord.uiChannel = 0;
+			sRecord.uiData = pauiBuffer[uiPosition++];
+			sRecord.uiTimeBase = ACKSEN_BUTTON_TIME_MILLIS;
+			
+			uint8_t uiStatus = readNumber(pauiBuffer, uiLength, uiPosition, sRecord.ulTimestamp_MS);
+			
+			if (uiStatus == ACKSEN_BUTTON_TRACE_OK)
+			{
+				uiStatus = readNumber(pauiBuffer, uiLength, uiPosition, ulValue);
+			}
+			
+			if (uiStatus == ACKSEN_BUTTON_TRACE_OK)
+			{
+				bHeaderRead = true;
+				uiMicrosChannels = 0;
+				ulLastRecord_MS = sRecord.ulTimestamp_MS;
+				ulLastRecord_US = ulValue;
+				uiUsed = uiPosition;
+			}
+			
+			return uiStatus;
+		}
+		
+		if (uiLength == 0)
+		{
+			return ACKSEN_BUTTON_TRACE_MORE;
+		}
+		
+		uint8_t uiTag = pauiBuffer[uiPosition++];
+		uint8_t uiStatus = readNumber(pauiBuffer, uiLength, uiPosition, ulValue);
+		
+		if (uiStatus != ACKSEN_BUTTON_TRACE_OK)
+		{
+			return uiStatus;
+		}
+		
+		sRecord.uiType = uiTag >> 6;
+		sRecord.uiData = (uiTag >> 4) & 0x03;
+		sRecord.uiChannel = uiTag & 0x0F;
+		
+		// Config and refresh records carry their clock, and every other record is on its channel's clock
+		bool bMicros = (uiMicrosChannels & ((uint16_t)1 << sRecord.uiChannel)) != 0;
+		
+		if (sRecord.uiType == ACKSEN_BUTTON_TRACE_CONFIG)
+		{
+			bMicros = (sRecord.uiData & 0x02) != 0;
+			sRecord.uiData &= 0x01;
+		}
+		else if (sRecord.uiType == ACKSEN_BUTTON_TRACE_REFRESH)
+		{
+			bMicros = (sRecord.uiData & 0x01) != 0;
+			sRecord.uiData = 0;
+		}
+		
+		unsigned long& ulLastRecord = bMicros ? ulLastRecord_US : ulLastRecord_MS;
+		
+		sRecord.uiTimeBase = bMicros ? ACKSEN_BUTTON_TIME_MICROS : ACKSEN_BUTTON_TIME_MILLIS;
+		sRecord.ulTimestamp_MS = ulLastRecord + (unsigned long)((long)(ulValue >> 1) ^ -(long)(ulValue & 1));
+		
+		if (sRecord.uiType == ACKSEN_BUTTON_TRACE_CONFIG)
+		{
+			AcksenButtonTraceConfig& sConfig = sRecord.sConfig;
+			unsigned long* apulNumbers[] = { &sConfig.ulAge_MS, &sConfig.ulDebounceTimerAge_MS, &sConfig.ulDebounceInterval_MS, &sConfig.ulLongPressInterval_MS,
+				&sConfig.ulRepeatPressesInterval_MS, &sConfig.ulRepeatInitialOffsetDelay_MS, &sConfig.ulAccelerationPressesInterval_MS,
+				&sConfig.ulAccelerationInitialOffsetDelay_MS, &sConfig.ulAdaptiveMinimum_MS, &sConfig.ulAdaptiveMaximum_MS };
+			
+			if (uiPosition + 3 > uiLength)
+			{
+				return ACKSEN_BUTTON_TRACE_MORE;
+			}
+			
+			sConfig.uiMode = pauiBuffer[uiPosition++];
+			sConfig.uiDebounceStrategy = pauiBuffer[uiPosition++];
+			sConfig.uiDebounceSamples = pauiBuffer[uiPosition++];
+			sConfig.uiTimeBase = sRecord.uiTimeBase;
+			
+			for (uint8_t i = 0; i < sizeof(apulNumbers) / sizeof(apulNumbers[0]); i++)
+			{
+				uiStatus = readNumber(pauiBuffer, uiLength, uiPosition, *apulNumbers[i]);
+				
+				if (uiStatus != ACKSEN_BUTTON_TRACE_OK)
+				{
+					return uiStatus;
+				}
+			}
+			
+			uint16_t uiChannelMask = (uint16_t)1 << sRecord.uiChannel;
+			
+			uiMicrosChannels = bMicros ? (uiMicrosChannels | uiChannelMask) : (uiMicrosChannels & ~uiChannelMask);
+		}
+		
+		ulLastRecord = sRecord.ulTimestamp_MS;
+		uiUsed = uiPosition;
+		
+		return ACKSEN_BUTTON_TRACE_OK;
+		
+	}
+
+protected:
+
+	// Unsigned LEB128, no longer than an unsigned long can hold
+	uint8_t readNumber(const uint8_t* pauiBuffer, size_t uiLength, size_t& uiPosition, unsigned long& ulValue)
+	{
+		
+		ulValue = 0;
+		
+		for (uint8_t uiShift = 0; uiShift < sizeof(unsigned long) * 8; uiShift += 7)
+		{
+			if (uiPosition >= uiLength)
+			{
+				return ACKSEN_BUTTON_TRACE_MORE;
+			}
+			
+			uint8_t uiByte = pauiBuffer[uiPosition++];
+			
+			ulValue |= (unsigned long)(uiByte & 0x7F) << uiShift;
+			
+			if ((uiByte & 0x80) == 0)
+			{
+				return ACKSEN_BUTTON_TRACE_OK;
+			}
+		}
+		
+		return ACKSEN_BUTTON_TRACE_ERROR;
+		
+	}
+
+	bool bHeaderRead;
+	uint16_t uiMicrosChannels;			// Bit set for each channel whose config record is in microseconds
+	unsigned long ulLastRecord_MS;		// Time of the last record on each clock
+	unsigned long ulLastRecord_US;
+
+};
+
+#endif